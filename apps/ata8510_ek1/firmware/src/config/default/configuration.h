@@ -93,17 +93,51 @@ extern "C" {
 // *****************************************************************************
 // *****************************************************************************
 /* ATA8510 Driver Configuration Options */
-    /* UHF SPI SERCOM mapping */
-    #define UHF_SPI_TRANSFER                SERCOM1_SPI_WriteRead
-    /* UHF SPI Chip Select mapping */
-    #define UHF_SPI_CS_ENABLE               SYS_PORT_PinClear(SYS_PORT_PIN_PA17)
-    #define UHF_SPI_CS_DISABLE              SYS_PORT_PinSet(SYS_PORT_PIN_PA17)
-    /* UHF NRESET mapping */
-    #define UHF_NRESET_CLEAR                SYS_PORT_PinClear(SYS_PORT_PIN_PA21)
-    #define UHF_NRESET_SET                  SYS_PORT_PinSet(SYS_PORT_PIN_PA21)
-    /* UHF NPWRON1 mapping */
-    #define UHF_NPWRON1_CLEAR               SYS_PORT_PinClear(SYS_PORT_PIN_PA20)
-    #define UHF_NPWRON1_SET                 SYS_PORT_PinSet(SYS_PORT_PIN_PA20)
+    /* UHF SPI driver instances (SERCOM, DMAC, timer and pin mapping in initialization.c) */
+    #define UHF_SPI_INDEX_0                 0
+    #define UHF_SPI_INSTANCES_NUMBER        1
+    /* UHF SPI DMA (1: DMAC driven transfers, 0: polled SERCOM) */
+    #define UHF_SPI_DMA_ENABLE              1
+    /* UHF SPI command queue depth (asynchronous API) */
+    #define UHF_SPI_QUEUE_LENGTH            8
+    /* UHF SPI guard timer (1: TC one-shot, 0: SYS_TIME counter polling) */
+    #define UHF_SPI_GUARD_TIMER_ENABLE      1
+    /* UHF SPI wake state tracking (1: skip T0 while the AVR is known awake) */
+    #define UHF_SPI_WAKE_TRACKING_ENABLE    1
+    /* UHF SPI timing statistics (1: per command wall and CPU busy time) */
+    #define UHF_SPI_STATS_ENABLE            1
+    /* UHF SPI bus speed negotiation (SCK candidates in Hz, slowest first = MHC setting) */
+    #define UHF_SPI_SPEED_LIST              { 500000UL, 1000000UL, 2000000UL, 3000000UL, 4000000UL }
+    #define UHF_SPI_SPEED_MARGIN            1
+    #define UHF_SPI_SPEED_CHECKS            8
+    #define UHF_SPI_SPEED_ERROR_LIMIT       3
+    #define UHF_SPI_SPEED_SCRATCH_ADDR      (0x02E9)
+    /* UHF SPI trace ring (1: record every telegram, TCC0 ticks; records, power of 2) */
+    #define UHF_SPI_TRACE_ENABLE            1
+    #define UHF_SPI_TRACE_LENGTH            32
+    /* UHF SPI EEPROM programming job (CMD_RDY poll interval, at most 1365 us with the 48 MHz guard timer; timeout per byte) */
+    #define UHF_SPI_EEPROM_POLL_US          1000
+    #define UHF_SPI_EEPROM_TIMEOUT_US       10000
+    /* Unchanged bytes an EEPROM update merges into one secure write with the changed bytes around them */
+    #define UHF_SPI_EEPROM_MERGE_GAP        2
+    /* UHF SPI EEPROM shadow (1: RAM copy of selected EEPROM ranges; bytes, ranges) */
+    #define UHF_SPI_EEPROM_SHADOW_ENABLE    1
+    #define UHF_SPI_EEPROM_SHADOW_SIZE      64
+    #define UHF_SPI_EEPROM_SHADOW_RANGES    4
+    /* UHF SPI bulk dump (bytes per "Read SRAM" telegram and per sink call, 1 to 255; one chunk on the stack) */
+    #define UHF_SPI_DUMP_CHUNK_LENGTH       128
+    /* UHF SPI SRAM register map (1: RAM mirror with dirty bits; registers, mirror bytes, clean bytes a flush writes along) */
+    #define UHF_SPI_REGMAP_ENABLE           1
+    #define UHF_SPI_REGMAP_REGISTERS        32
+    #define UHF_SPI_REGMAP_SIZE             64
+    #define UHF_SPI_REGMAP_MERGE_GAP        4
+    /* UHF SPI RSSI survey (1: channel sweep with statistics; samples per channel, IRQ line poll interval, at most 1365 us with the 48 MHz guard timer; timeout per sample) */
+    #define UHF_SPI_RSSI_SURVEY_ENABLE      1
+    #define UHF_SPI_RSSI_SURVEY_SAMPLES     64
+    #define UHF_SPI_RSSI_POLL_US            50
+    #define UHF_SPI_RSSI_TIMEOUT_US         10000
+    /* UHF SPI IRQ line on an EIC falling edge interrupt (1: edges stamped for the application, which may sleep in between) */
+    #define UHF_SPI_IRQ_EIC_ENABLE          1
 
 
 // *****************************************************************************
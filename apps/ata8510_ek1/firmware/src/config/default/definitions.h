@@ -49,7 +49,9 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include "peripheral/nvmctrl/plib_nvmctrl.h"
+#include "peripheral/eic/plib_eic.h"
 #include "peripheral/sercom/spi_master/plib_sercom1_spi_master.h"
+#include "peripheral/dmac/plib_dmac.h"
 #include "peripheral/evsys/plib_evsys.h"
 #include "peripheral/port/plib_port.h"
 #include "peripheral/clock/plib_clock.h"
@@ -59,6 +61,8 @@
 #include "peripheral/sercom/usart/plib_sercom4_usart.h"
 #include "peripheral/tc/plib_tc0.h"
 #include "peripheral/tc/plib_tc2.h"
+#include "peripheral/tc/plib_tc4.h"
+#include "peripheral/tcc/plib_tcc0.h"
 #include "system/time/sys_time.h"
 #include "spi/ata8510/spi_ata8510.h"
 #include "system/int/sys_int.h"
@@ -188,6 +192,7 @@ Remarks:
 typedef struct
 {
     SYS_MODULE_OBJ  sysTime;
+    uhf_dev_t       *uhfSpi0;
 
 } SYSTEM_OBJECTS;
 
@@ -79,6 +79,39 @@
 // Section: Driver Initialization Data
 // *****************************************************************************
 // *****************************************************************************
+// <editor-fold defaultstate="collapsed" desc="UHF SPI Instance 0 Initialization Data">
+
+/* ATA8510 on SERCOM1, DMAC channel 0 / 1, TC4 guard timer, TCC0 trace counter */
+const uhf_spi_init_t uhfSpi0InitData =
+{
+    .spi_setup = SERCOM1_SPI_TransferSetup,
+    .spi_write_read = SERCOM1_SPI_WriteRead,
+    .dma_channel_tx = DMAC_CHANNEL_0,
+    .dma_channel_rx = DMAC_CHANNEL_1,
+    .dma_data_address = (void *)&(SERCOM1_REGS->SPIM.SERCOM_DATA),
+    .timer_frequency_get = TC4_TimerFrequencyGet,
+    .timer_start = TC4_TimerStart,
+    .timer_period_set = TC4_Timer16bitPeriodSet,
+    .timer_command = TC4_TimerCommandSet,
+    .timer_callback_register = TC4_TimerCallbackRegister,
+#if (UHF_SPI_TRACE_ENABLE == 1)
+    .trace_counter_get = TCC0_Timer24bitCounterGet,
+    .trace_frequency_get = TCC0_TimerFrequencyGet,
+    .trace_counter_start = TCC0_TimerStart,
+    .trace_counter_mask = 0xFFFFFFUL,
+    .trace_write = SERCOM4_USART_Write,
+#endif
+    .cs_pin = SYS_PORT_PIN_PA17,
+    .nreset_pin = SYS_PORT_PIN_PA21,
+    .npwron_pin = SYS_PORT_PIN_PA20,
+    .irq_pin = SYS_PORT_PIN_PB14,
+#if (UHF_SPI_IRQ_EIC_ENABLE == 1)
+    .irq_eic_pin = EIC_PIN_14,
+    .irq_callback_register = EIC_CallbackRegister,
+#endif
+};
+
+// </editor-fold>
 
 
 // *****************************************************************************
@@ -158,6 +191,10 @@ void SYS_Initialize ( void* data )
 
     NVMCTRL_Initialize( );
 
+    EIC_Initialize();
+
+    DMAC_Initialize();
+
     SERCOM1_SPI_Initialize();
 
     EVSYS_Initialize();
@@ -171,10 +208,17 @@ void SYS_Initialize ( void* data )
 
     TC2_TimerInitialize();
 
+    TC4_TimerInitialize();
+
+    TCC0_TimerInitialize();
+
 
 
     sysObj.sysTime = SYS_TIME_Initialize(SYS_TIME_INDEX_0, (SYS_MODULE_INIT *)&sysTimeInitData);
 
+    /* UHF SPI guard times are derived from the SYS_TIME counter frequency */
+    sysObj.uhfSpi0 = uhf_spi_initialize(UHF_SPI_INDEX_0, &uhfSpi0InitData);
+
 
     NVIC_Initialize();
 
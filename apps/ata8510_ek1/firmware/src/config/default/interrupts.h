@@ -61,8 +61,11 @@ void Reset_Handler (void);
 void NonMaskableInt_Handler (void);
 void HardFault_Handler (void);
 void SysTick_Handler (void);
+void EIC_InterruptHandler (void);
+void DMAC_InterruptHandler (void);
 void TC0_TimerInterruptHandler (void);
 void TC2_TimerInterruptHandler (void);
+void TC4_TimerInterruptHandler (void);
 
 
 
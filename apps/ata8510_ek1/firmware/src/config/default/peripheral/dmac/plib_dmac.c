@@ -0,0 +1,399 @@
+/*******************************************************************************
+  Direct Memory Access Controller (DMAC) PLIB
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    plib_dmac.c
+
+  Summary
+    Source for DMAC peripheral library interface Implementation.
+
+  Description
+    This file defines the interface to the DMAC peripheral library. This
+    library provides access to and control of the DMAC controller.
+
+  Remarks:
+    None.
+
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+/* This section lists the other files that are included in this file.
+*/
+
+#include <string.h>
+#include "interrupts.h"
+#include "plib_dmac.h"
+#include "peripheral/nvic/plib_nvic.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define DMAC_CHANNELS_NUMBER        2U
+
+/* DMAC channels object configuration structure */
+typedef struct
+{
+    uint8_t                inUse;
+
+    DMAC_CHANNEL_CALLBACK  callback;
+
+    uintptr_t              context;
+
+    bool                   busyStatus;
+
+} DMAC_CH_OBJECT ;
+
+/* Initial write back memory section for DMAC */
+static dmac_descriptor_registers_t write_back_section[DMAC_CHANNELS_NUMBER] __ALIGNED(8);
+
+/* Descriptor section for DMAC */
+static dmac_descriptor_registers_t descriptor_section[DMAC_CHANNELS_NUMBER] __ALIGNED(8);
+
+/* DMAC Channels object information structure */
+static DMAC_CH_OBJECT dmacChannelObj[DMAC_CHANNELS_NUMBER];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: DMAC PLib Interface Implementations
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* This function initializes the DMAC controller of the device. */
+void DMAC_Initialize( void )
+{
+    DMAC_CH_OBJECT *dmacChObj = &dmacChannelObj[0];
+    uint16_t channel = 0U;
+
+    /* Initialize DMAC Channel objects */
+    for(channel = 0U; channel < DMAC_CHANNELS_NUMBER; channel++)
+    {
+        dmacChObj->inUse = 0U;
+        dmacChObj->callback = NULL;
+        dmacChObj->context = 0U;
+        dmacChObj->busyStatus = false;
+
+        /* Point to next channel object */
+        dmacChObj += 1U;
+    }
+
+    /* Update the Base address and Write Back address register */
+    DMAC_REGS->DMAC_BASEADDR = (uint32_t) descriptor_section;
+    DMAC_REGS->DMAC_WRBADDR  = (uint32_t) write_back_section;
+
+    /* Update the Priority Control register */
+    DMAC_REGS->DMAC_PRICTRL0 = DMAC_PRICTRL0_LVLPRI0(1UL) | DMAC_PRICTRL0_RRLVLEN0_Msk;
+
+    /***************** Configure DMA channel 0 ********************/
+
+    /* SERCOM1 TX: memory to SERCOM1 DATA, one beat per DRE trigger */
+    DMAC_REGS->DMAC_CHID = 0U;
+
+    DMAC_REGS->DMAC_CHCTRLB = DMAC_CHCTRLB_TRIGACT_BEAT | DMAC_CHCTRLB_TRIGSRC(SERCOM1_DMAC_ID_TX) | DMAC_CHCTRLB_LVL_LVL0;
+
+    descriptor_section[0].DMAC_BTCTRL = (uint16_t)(DMAC_BTCTRL_BLOCKACT_INT | DMAC_BTCTRL_BEATSIZE_BYTE | DMAC_BTCTRL_VALID_Msk | DMAC_BTCTRL_SRCINC_Msk);
+
+    dmacChannelObj[0].inUse = 1U;
+
+    DMAC_REGS->DMAC_CHINTENSET = (uint8_t)(DMAC_CHINTENSET_TERR_Msk | DMAC_CHINTENSET_TCMPL_Msk);
+
+    /***************** Configure DMA channel 1 ********************/
+
+    /* SERCOM1 RX: SERCOM1 DATA to memory, one beat per RXC trigger */
+    DMAC_REGS->DMAC_CHID = 1U;
+
+    DMAC_REGS->DMAC_CHCTRLB = DMAC_CHCTRLB_TRIGACT_BEAT | DMAC_CHCTRLB_TRIGSRC(SERCOM1_DMAC_ID_RX) | DMAC_CHCTRLB_LVL_LVL0;
+
+    descriptor_section[1].DMAC_BTCTRL = (uint16_t)(DMAC_BTCTRL_BLOCKACT_INT | DMAC_BTCTRL_BEATSIZE_BYTE | DMAC_BTCTRL_VALID_Msk | DMAC_BTCTRL_DSTINC_Msk);
+
+    dmacChannelObj[1].inUse = 1U;
+
+    DMAC_REGS->DMAC_CHINTENSET = (uint8_t)(DMAC_CHINTENSET_TERR_Msk | DMAC_CHINTENSET_TCMPL_Msk);
+
+    /* Enable the DMAC module & Priority Level x Enable */
+    DMAC_REGS->DMAC_CTRL = (uint16_t)(DMAC_CTRL_DMAENABLE_Msk | DMAC_CTRL_LVLEN0_Msk);
+}
+
+// *****************************************************************************
+/* This function registers the callback function for the given channel. */
+void DMAC_ChannelCallbackRegister( DMAC_CHANNEL channel, const DMAC_CHANNEL_CALLBACK eventHandler, const uintptr_t contextHandle )
+{
+    dmacChannelObj[channel].callback = eventHandler;
+
+    dmacChannelObj[channel].context  = contextHandle;
+}
+
+// *****************************************************************************
+/* This function schedules a DMA transfer on the specified DMA channel. */
+bool DMAC_ChannelTransfer( DMAC_CHANNEL channel, const void *srcAddr, const void *destAddr, size_t blockSize )
+{
+    uint8_t beat_size = 0U;
+    uint8_t channelId = 0U;
+    bool returnStatus = false;
+    bool interruptStatus = false;
+    dmac_descriptor_registers_t *const dmacDescReg = &descriptor_section[channel];
+
+    if (dmacChannelObj[channel].busyStatus == false)
+    {
+        interruptStatus = NVIC_INT_Disable();
+
+        /* Save channel ID */
+        channelId = (uint8_t)DMAC_REGS->DMAC_CHID;
+
+        /* Set the DMA channel */
+        DMAC_REGS->DMAC_CHID = (uint8_t)channel;
+
+        /* Clear any stale channel flags */
+        DMAC_REGS->DMAC_CHINTFLAG = (uint8_t)(DMAC_CHINTFLAG_TCMPL_Msk | DMAC_CHINTFLAG_TERR_Msk);
+
+        dmacChannelObj[channel].busyStatus = true;
+
+        /* Set source address */
+        if ((dmacDescReg->DMAC_BTCTRL & DMAC_BTCTRL_SRCINC_Msk) == DMAC_BTCTRL_SRCINC_Msk)
+        {
+            dmacDescReg->DMAC_SRCADDR = ((uint32_t)srcAddr + blockSize);
+        }
+        else
+        {
+            dmacDescReg->DMAC_SRCADDR = (uint32_t)srcAddr;
+        }
+
+        /* Set destination address */
+        if ((dmacDescReg->DMAC_BTCTRL & DMAC_BTCTRL_DSTINC_Msk) == DMAC_BTCTRL_DSTINC_Msk)
+        {
+            dmacDescReg->DMAC_DSTADDR = ((uint32_t)destAddr + blockSize);
+        }
+        else
+        {
+            dmacDescReg->DMAC_DSTADDR = (uint32_t)destAddr;
+        }
+
+        /* Calculate the beat size and then set the BTCNT value */
+        beat_size = (uint8_t)((dmacDescReg->DMAC_BTCTRL & DMAC_BTCTRL_BEATSIZE_Msk) >> DMAC_BTCTRL_BEATSIZE_Pos);
+
+        /* Set Block Transfer Count */
+        dmacDescReg->DMAC_BTCNT = (uint16_t)(blockSize / (1UL << beat_size));
+
+        /* Enable the channel */
+        DMAC_REGS->DMAC_CHCTRLA |= (uint8_t)DMAC_CHCTRLA_ENABLE_Msk;
+
+        /* Verify if Trigger source is Software Trigger */
+        if ((DMAC_REGS->DMAC_CHCTRLB & DMAC_CHCTRLB_TRIGSRC_Msk) == 0U)
+        {
+            /* Trigger the DMA transfer */
+            DMAC_REGS->DMAC_SWTRIGCTRL |= (1UL << (uint32_t)channel);
+        }
+
+        /* Restore channel ID */
+        DMAC_REGS->DMAC_CHID = channelId;
+
+        NVIC_INT_Restore(interruptStatus);
+
+        returnStatus = true;
+    }
+
+    return returnStatus;
+}
+
+// *****************************************************************************
+/* This function submits a list of DMAC linked descriptors. The first descriptor
+   is copied to the channel descriptor; the others are fetched by the DMAC from
+   the caller's memory and have to stay valid until the transfer completes. */
+bool DMAC_ChannelLinkedListTransfer( DMAC_CHANNEL channel, dmac_descriptor_registers_t *channelDesc )
+{
+    uint8_t channelId = 0U;
+    bool returnStatus = false;
+    bool interruptStatus = false;
+
+    if (dmacChannelObj[channel].busyStatus == false)
+    {
+        interruptStatus = NVIC_INT_Disable();
+
+        /* Save channel ID */
+        channelId = (uint8_t)DMAC_REGS->DMAC_CHID;
+
+        /* Set the DMA channel */
+        DMAC_REGS->DMAC_CHID = (uint8_t)channel;
+
+        /* Clear any stale channel flags */
+        DMAC_REGS->DMAC_CHINTFLAG = (uint8_t)(DMAC_CHINTFLAG_TCMPL_Msk | DMAC_CHINTFLAG_TERR_Msk);
+
+        dmacChannelObj[channel].busyStatus = true;
+
+        (void)memcpy(&descriptor_section[channel], channelDesc, sizeof(dmac_descriptor_registers_t));
+
+        /* Enable the channel */
+        DMAC_REGS->DMAC_CHCTRLA |= (uint8_t)DMAC_CHCTRLA_ENABLE_Msk;
+
+        /* Verify if Trigger source is Software Trigger */
+        if ((DMAC_REGS->DMAC_CHCTRLB & DMAC_CHCTRLB_TRIGSRC_Msk) == 0U)
+        {
+            /* Trigger the DMA transfer */
+            DMAC_REGS->DMAC_SWTRIGCTRL |= (1UL << (uint32_t)channel);
+        }
+
+        /* Restore channel ID */
+        DMAC_REGS->DMAC_CHID = channelId;
+
+        NVIC_INT_Restore(interruptStatus);
+
+        returnStatus = true;
+    }
+
+    return returnStatus;
+}
+
+// *****************************************************************************
+/* This function returns the status of the channel. */
+bool DMAC_ChannelIsBusy ( DMAC_CHANNEL channel )
+{
+    return dmacChannelObj[channel].busyStatus;
+}
+
+// *****************************************************************************
+/* This function disables the specified DMAC channel. */
+void DMAC_ChannelDisable ( DMAC_CHANNEL channel )
+{
+    bool interruptStatus = NVIC_INT_Disable();
+    uint8_t channelId = (uint8_t)DMAC_REGS->DMAC_CHID;
+
+    /* Set the DMA Channel ID */
+    DMAC_REGS->DMAC_CHID = (uint8_t)channel;
+
+    /* Disable the DMA channel */
+    DMAC_REGS->DMAC_CHCTRLA &= (uint8_t)(~DMAC_CHCTRLA_ENABLE_Msk);
+
+    while((DMAC_REGS->DMAC_CHCTRLA & DMAC_CHCTRLA_ENABLE_Msk) != 0U)
+    {
+        /* Wait till the channel is disabled */
+    }
+
+    dmacChannelObj[channel].busyStatus = false;
+
+    /* Restore channel ID */
+    DMAC_REGS->DMAC_CHID = channelId;
+
+    NVIC_INT_Restore(interruptStatus);
+}
+
+// *****************************************************************************
+/* This function returns the block transfer control settings of the channel. */
+DMAC_CHANNEL_CONFIG DMAC_ChannelSettingsGet ( DMAC_CHANNEL channel )
+{
+    return (DMAC_CHANNEL_CONFIG)descriptor_section[channel].DMAC_BTCTRL;
+}
+
+// *****************************************************************************
+/* This function changes the block transfer control settings of the channel. */
+bool DMAC_ChannelSettingsSet ( DMAC_CHANNEL channel, DMAC_CHANNEL_CONFIG setting )
+{
+    bool returnStatus = false;
+
+    if (dmacChannelObj[channel].busyStatus == false)
+    {
+        /* Set the new settings, the descriptor is always kept valid */
+        descriptor_section[channel].DMAC_BTCTRL = (uint16_t)(setting | DMAC_BTCTRL_VALID_Msk);
+
+        returnStatus = true;
+    }
+
+    return returnStatus;
+}
+
+// *****************************************************************************
+/* This function returns the number of beats transferred by the channel. */
+uint16_t DMAC_ChannelGetTransferredCount( DMAC_CHANNEL channel )
+{
+    return (descriptor_section[channel].DMAC_BTCNT - write_back_section[channel].DMAC_BTCNT);
+}
+
+// *****************************************************************************
+/* DMAC interrupt handler, dispatches the channel callbacks */
+void DMAC_InterruptHandler( void )
+{
+    DMAC_CH_OBJECT *dmacChObj = NULL;
+    uint8_t channel = 0U;
+    uint8_t channelId = 0U;
+    uint8_t chanIntFlagStatus = 0U;
+    DMAC_TRANSFER_EVENT event = DMAC_TRANSFER_EVENT_ERROR;
+
+    /* Get active channel number */
+    channel = (uint8_t)(DMAC_REGS->DMAC_INTPEND & DMAC_INTPEND_ID_Msk);
+
+    dmacChObj = &dmacChannelObj[channel];
+
+    /* Save channel ID */
+    channelId = (uint8_t)DMAC_REGS->DMAC_CHID;
+
+    /* Update the DMAC channel ID */
+    DMAC_REGS->DMAC_CHID = channel;
+
+    /* Get the DMAC channel interrupt status */
+    chanIntFlagStatus = DMAC_REGS->DMAC_CHINTFLAG;
+
+    /* Verify if DMAC Channel Transfer complete flag is set */
+    if ((chanIntFlagStatus & DMAC_CHINTFLAG_TCMPL_Msk) == DMAC_CHINTFLAG_TCMPL_Msk)
+    {
+        /* Clear the transfer complete flag */
+        DMAC_REGS->DMAC_CHINTFLAG = DMAC_CHINTFLAG_TCMPL_Msk;
+
+        event = DMAC_TRANSFER_EVENT_COMPLETE;
+
+        dmacChObj->busyStatus = false;
+    }
+
+    /* Verify if DMAC Channel Error flag is set */
+    if ((chanIntFlagStatus & DMAC_CHINTFLAG_TERR_Msk) == DMAC_CHINTFLAG_TERR_Msk)
+    {
+        /* Clear transfer error flag */
+        DMAC_REGS->DMAC_CHINTFLAG = DMAC_CHINTFLAG_TERR_Msk;
+
+        event = DMAC_TRANSFER_EVENT_ERROR;
+
+        dmacChObj->busyStatus = false;
+    }
+
+    /* Restore channel ID */
+    DMAC_REGS->DMAC_CHID = channelId;
+
+    /* Execute the callback function */
+    if (dmacChObj->callback != NULL)
+    {
+        dmacChObj->callback(event, dmacChObj->context);
+    }
+}
@@ -0,0 +1,182 @@
+/*******************************************************************************
+  Direct Memory Access Controller (DMAC) PLIB
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    plib_dmac.h
+
+  Summary
+    DMAC PLIB Header File.
+
+  Description
+    This file defines the interface to the DMAC peripheral library. This
+    library provides access to and control of the DMAC controller.
+
+  Remarks:
+    None.
+
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef PLIB_DMAC_H    // Guards against multiple inclusion
+#define PLIB_DMAC_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+/* This section lists the other files that are included in this file.
+*/
+
+#include "device.h"
+#include <string.h>
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus // Provide C Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/* The following data type definitions are used by the functions in this
+    interface and should be considered part it.
+*/
+
+// *****************************************************************************
+/* DMAC Channels
+
+  Summary:
+    Identifies the DMAC channels that are configured in MHC.
+
+  Description:
+    Channel 0 is the SERCOM1 TX channel and channel 1 is the SERCOM1 RX
+    channel used by the ATA8510 driver.
+
+  Remarks:
+    None.
+*/
+
+typedef enum
+{
+    DMAC_CHANNEL_0 = 0,
+    DMAC_CHANNEL_1 = 1,
+} DMAC_CHANNEL;
+
+// *****************************************************************************
+/* DMAC Transfer Events
+
+  Summary:
+    Enumeration of possible DMAC transfer events.
+
+  Description:
+    This data type provides an enumeration of all possible DMAC transfer
+    events.
+
+  Remarks:
+    None.
+*/
+
+typedef enum
+{
+    /* Data was transferred successfully. */
+    DMAC_TRANSFER_EVENT_COMPLETE,
+
+    /* Error while processing the request */
+    DMAC_TRANSFER_EVENT_ERROR
+
+} DMAC_TRANSFER_EVENT;
+
+// *****************************************************************************
+/* DMAC Channel Settings
+
+  Summary:
+    Defines the channel settings (block transfer control register value).
+
+  Remarks:
+    None.
+*/
+
+typedef uint32_t DMAC_CHANNEL_CONFIG;
+
+// *****************************************************************************
+/* DMAC Transfer Event Handler Function
+
+  Summary:
+    Pointer to a DMAC transfer event handler function.
+
+  Remarks:
+    The callback is invoked from the DMAC interrupt context.
+*/
+
+typedef void (*DMAC_CHANNEL_CALLBACK) (DMAC_TRANSFER_EVENT event, uintptr_t contextHandle);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+/* The following functions make up the methods (set of possible operations) of
+   this interface.
+*/
+
+void DMAC_Initialize( void );
+
+void DMAC_ChannelCallbackRegister( DMAC_CHANNEL channel, const DMAC_CHANNEL_CALLBACK eventHandler, const uintptr_t contextHandle );
+
+bool DMAC_ChannelTransfer( DMAC_CHANNEL channel, const void *srcAddr, const void *destAddr, size_t blockSize );
+
+bool DMAC_ChannelLinkedListTransfer( DMAC_CHANNEL channel, dmac_descriptor_registers_t *channelDesc );
+
+bool DMAC_ChannelIsBusy ( DMAC_CHANNEL channel );
+
+void DMAC_ChannelDisable ( DMAC_CHANNEL channel );
+
+DMAC_CHANNEL_CONFIG DMAC_ChannelSettingsGet ( DMAC_CHANNEL channel );
+
+bool DMAC_ChannelSettingsSet ( DMAC_CHANNEL channel, DMAC_CHANNEL_CONFIG setting );
+
+uint16_t DMAC_ChannelGetTransferredCount( DMAC_CHANNEL channel );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    }
+
+#endif
+// DOM-IGNORE-END
+
+#endif /* PLIB_DMAC_H */
@@ -57,10 +57,16 @@ void NVIC_Initialize( void )
 
     /* Enable the interrupt sources and configure the priorities as configured
      * from within the "Interrupt Manager" of MHC. */
+    NVIC_SetPriority(EIC_IRQn, 3);
+    NVIC_EnableIRQ(EIC_IRQn);
+    NVIC_SetPriority(DMAC_IRQn, 3);
+    NVIC_EnableIRQ(DMAC_IRQn);
     NVIC_SetPriority(TC0_IRQn, 3);
     NVIC_EnableIRQ(TC0_IRQn);
     NVIC_SetPriority(TC2_IRQn, 3);
     NVIC_EnableIRQ(TC2_IRQn);
+    NVIC_SetPriority(TC4_IRQn, 3);
+    NVIC_EnableIRQ(TC4_IRQn);
 
 
 
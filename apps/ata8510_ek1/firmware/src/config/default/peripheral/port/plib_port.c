@@ -105,7 +105,7 @@ void PORT_Initialize(void)
    PORT_REGS->GROUP[1].PORT_PINCFG[7] = 0x6U;
    PORT_REGS->GROUP[1].PORT_PINCFG[10] = 0x1U;
    PORT_REGS->GROUP[1].PORT_PINCFG[11] = 0x1U;
-   PORT_REGS->GROUP[1].PORT_PINCFG[14] = 0x6U;
+   PORT_REGS->GROUP[1].PORT_PINCFG[14] = 0x7U;
 
    PORT_REGS->GROUP[1].PORT_PMUX[0] = 0x33U;
    PORT_REGS->GROUP[1].PORT_PMUX[1] = 0x3U;
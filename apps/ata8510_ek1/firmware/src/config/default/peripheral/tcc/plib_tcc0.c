@@ -0,0 +1,176 @@
+/*******************************************************************************
+  Timer/Counter for Control Applications(TCC0) PLIB
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    plib_tcc0.c
+
+  Summary
+    TCC0 PLIB Implementation File.
+
+  Description
+    This file defines the interface to the TCC peripheral library. This
+    library provides access to and control of the associated peripheral
+    instance.
+
+  Remarks:
+    None.
+
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+/* This section lists the other files that are included in this file.
+*/
+
+#include "plib_tcc0.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: TCC0 Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Initialize the TCC module in Timer mode */
+void TCC0_TimerInitialize( void )
+{
+    /* Reset TCC */
+    TCC0_REGS->TCC_CTRLA = TCC_CTRLA_SWRST_Msk;
+
+    while((TCC0_REGS->TCC_SYNCBUSY & TCC_SYNCBUSY_SWRST_Msk) == TCC_SYNCBUSY_SWRST_Msk)
+    {
+        /* Wait for Write Synchronization */
+    }
+
+    /* Configure prescaler */
+    TCC0_REGS->TCC_CTRLA = TCC_CTRLA_PRESCALER_DIV1 | TCC_CTRLA_PRESCSYNC_PRESC ;
+
+    /* Configure in Normal Frequency Mode */
+    TCC0_REGS->TCC_WAVE = TCC_WAVE_WAVEGEN_NFRQ;
+
+    /* Configure timer period */
+    TCC0_REGS->TCC_PER = 16777215U;
+
+    /* Clear all interrupt flags */
+    TCC0_REGS->TCC_INTFLAG = TCC_INTFLAG_Msk;
+
+    while((TCC0_REGS->TCC_SYNCBUSY) != 0U)
+    {
+        /* Wait for Write Synchronization */
+    }
+}
+
+/* Enable the TCC counter */
+void TCC0_TimerStart( void )
+{
+    TCC0_REGS->TCC_CTRLA |= TCC_CTRLA_ENABLE_Msk;
+    while((TCC0_REGS->TCC_SYNCBUSY & TCC_SYNCBUSY_ENABLE_Msk) == TCC_SYNCBUSY_ENABLE_Msk)
+    {
+        /* Wait for Write Synchronization */
+    }
+}
+
+/* Disable the TCC counter */
+void TCC0_TimerStop( void )
+{
+    TCC0_REGS->TCC_CTRLA &= ~TCC_CTRLA_ENABLE_Msk;
+    while((TCC0_REGS->TCC_SYNCBUSY & TCC_SYNCBUSY_ENABLE_Msk) == TCC_SYNCBUSY_ENABLE_Msk)
+    {
+        /* Wait for Write Synchronization */
+    }
+}
+
+uint32_t TCC0_TimerFrequencyGet( void )
+{
+    return (uint32_t)(48000000UL);
+}
+
+/* Configure timer period */
+bool TCC0_Timer24bitPeriodSet( uint32_t period )
+{
+    bool status = false;
+    if ((TCC0_REGS->TCC_STATUS & TCC_STATUS_PERBUFV_Msk) == 0U)
+    {
+        TCC0_REGS->TCC_PERBUF = period & 0xFFFFFFU;
+        status = true;
+    }
+    return status;
+}
+
+/* Read the timer period value */
+uint32_t TCC0_Timer24bitPeriodGet( void )
+{
+    /* Get 24-bit period value */
+    return (TCC0_REGS->TCC_PER & 0xFFFFFFU);
+}
+
+/* Get the current timer counter value */
+uint32_t TCC0_Timer24bitCounterGet( void )
+{
+    /* Write command to force COUNT register read synchronization */
+    TCC0_REGS->TCC_CTRLBSET |= (uint8_t)TCC_CTRLBSET_CMD_READSYNC;
+
+    while((TCC0_REGS->TCC_SYNCBUSY & TCC_SYNCBUSY_CTRLB_Msk) == TCC_SYNCBUSY_CTRLB_Msk)
+    {
+        /* Wait for Write Synchronization */
+    }
+
+    while((TCC0_REGS->TCC_CTRLBSET & TCC_CTRLBSET_CMD_Msk) != 0U)
+    {
+        /* Wait for CMD to become zero */
+    }
+
+    /* Read current count value */
+    return (TCC0_REGS->TCC_COUNT & 0xFFFFFFU);
+}
+
+/* Configure timer counter value */
+void TCC0_Timer24bitCounterSet( uint32_t count )
+{
+    TCC0_REGS->TCC_COUNT = count & 0xFFFFFFU;
+
+    while((TCC0_REGS->TCC_SYNCBUSY & TCC_SYNCBUSY_COUNT_Msk) == TCC_SYNCBUSY_COUNT_Msk)
+    {
+        /* Wait for Write Synchronization */
+    }
+}
+
+/* Polling method to check if timer period interrupt flag is set */
+bool TCC0_TimerPeriodHasExpired( void )
+{
+    bool status;
+    status = ((TCC0_REGS->TCC_INTFLAG & TCC_INTFLAG_OVF_Msk) == TCC_INTFLAG_OVF_Msk);
+    TCC0_REGS->TCC_INTFLAG = TCC_INTFLAG_OVF_Msk;
+    return status;
+}
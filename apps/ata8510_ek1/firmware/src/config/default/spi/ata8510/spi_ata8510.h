@@ -51,8 +51,16 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include "configuration.h"
 #include "driver/driver.h"
 #include "system/system.h"
+#include "system/ports/sys_ports.h"
+#include "peripheral/sercom/spi_master/plib_sercom_spi_master_common.h"
+#include "peripheral/dmac/plib_dmac.h"
+#include "peripheral/tc/plib_tc_common.h"
+#if (UHF_SPI_IRQ_EIC_ENABLE == 1)
+#include "peripheral/eic/plib_eic.h"
+#endif
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
@@ -67,6 +75,37 @@
 // *****************************************************************************
 // *****************************************************************************
 
+/* SPI command IDs */
+#define UHF_SPI_CMD_READ_FILL_LEVEL_RX_FIFO     (0x01)
+#define UHF_SPI_CMD_READ_FILL_LEVEL_TX_FIFO     (0x02)
+#define UHF_SPI_CMD_READ_FILL_LEVEL_RSSI_FIFO   (0x03)
+#define UHF_SPI_CMD_GET_EVENT_BYTES             (0x04)
+#define UHF_SPI_CMD_READ_RSSI_FIFO              (0x05)
+#define UHF_SPI_CMD_READ_RX_FIFO                (0x06)
+#define UHF_SPI_CMD_WRITE_SRAM                  (0x07)
+#define UHF_SPI_CMD_READ_SRAM                   (0x08)
+#define UHF_SPI_CMD_WRITE_EEPROM                (0x09)
+#define UHF_SPI_CMD_READ_EEPROM                 (0x0A)
+#define UHF_SPI_CMD_WRITE_TX_FIFO               (0x0B)
+#define UHF_SPI_CMD_WRITE_TX_PREAMBLE_FIFO      (0x0C)
+#define UHF_SPI_CMD_SET_SYSTEM_MODE             (0x0D)
+#define UHF_SPI_CMD_CALIBRATE_AND_CHECK         (0x0E)
+#define UHF_SPI_CMD_PATCH_SPI                   (0x0F)
+#define UHF_SPI_CMD_SYSTEM_RESET_ROM            (0x10)
+#define UHF_SPI_CMD_GET_VERSION_ROM             (0x12)
+#define UHF_SPI_CMD_GET_VERSION_FLASH           (0x13)
+#define UHF_SPI_CMD_CUST_CONF                   (0x14)
+#define UHF_SPI_CMD_SYSTEM_RESET                (0x15)
+#define UHF_SPI_CMD_TRIG_EEPROM_SECURE_WRITE    (0x16)
+#define UHF_SPI_CMD_SET_VOLTAGE_MONITOR         (0x17)
+#define UHF_SPI_CMD_OFF                         (0x18)
+#define UHF_SPI_CMD_READ_TEMP_VALUE             (0x19)
+#define UHF_SPI_CMD_INIT_SRAM_SERVICE           (0x1A)
+#define UHF_SPI_CMD_START_RSSI_MEAS             (0x1B)
+#define UHF_SPI_CMD_GET_RSSI_VALUE              (0x1C)
+#define UHF_SPI_CMD_READ_RX_BUFFER_BYTE_INT     (0x1D)
+#define UHF_SPI_CMD_READ_RSSI_BUFFER_BYTE_INT   (0x1E)
+
 /* Event Bytes structure */
 typedef struct events_struct_t {
     uint8_t system;
@@ -75,6 +114,201 @@ typedef struct events_struct_t {
     uint8_t config;
 } events_struct_t;
 
+/* Driver instance handle, one per transceiver */
+typedef struct uhf_dev_t uhf_dev_t;
+
+/* Hardware mapping of one transceiver, see uhf_spi_initialize() */
+typedef struct uhf_spi_init_t {
+    /* SPI bus, SERCOM SPI master PLIB */
+    bool                (*spi_setup)(SPI_TRANSFER_SETUP *setup, uint32_t spiSourceClock);
+    bool                (*spi_write_read)(void *pTransmitData, size_t txSize, void *pReceiveData, size_t rxSize);
+    DMAC_CHANNEL        dma_channel_tx;
+    DMAC_CHANNEL        dma_channel_rx;
+    void                *dma_data_address;  /* SERCOM DATA register */
+    /* Guard timer, 16-bit TC PLIB in one-shot mode */
+    uint32_t            (*timer_frequency_get)(void);
+    void                (*timer_start)(void);
+    void                (*timer_period_set)(uint16_t period);
+    void                (*timer_command)(TC_COMMAND command);
+    void                (*timer_callback_register)(TC_TIMER_CALLBACK callback, uintptr_t context);
+#if (UHF_SPI_TRACE_ENABLE == 1)
+    /* Trace counter, free-running TCC PLIB, and the output used by the dump */
+    uint32_t            (*trace_counter_get)(void);
+    uint32_t            (*trace_frequency_get)(void);
+    void                (*trace_counter_start)(void);
+    uint32_t            trace_counter_mask; /* counter width, 0xFFFFFF for 24 bits */
+    bool                (*trace_write)(void *buffer, const size_t size);
+#endif
+    /* Transceiver pins */
+    SYS_PORT_PIN        cs_pin;
+    SYS_PORT_PIN        nreset_pin;
+    SYS_PORT_PIN        npwron_pin;
+    SYS_PORT_PIN        irq_pin;
+#if (UHF_SPI_IRQ_EIC_ENABLE == 1)
+    /* IRQ pin as EIC external interrupt, falling edge */
+    EIC_PIN             irq_eic_pin;
+    void                (*irq_callback_register)(EIC_PIN pin, EIC_CALLBACK callback, uintptr_t context);
+#endif
+} uhf_spi_init_t;
+
+/* Queued command descriptor */
+typedef struct uhf_spi_cmd_t uhf_spi_cmd_t;
+
+/* Command completion callback, called from uhf_spi_tasks() */
+typedef void (*uhf_spi_callback_t)(const uhf_spi_cmd_t *cmd, uintptr_t context);
+
+struct uhf_spi_cmd_t {
+    uint8_t             id;         /* SPI command ID, UHF_SPI_CMD_xxx */
+    uint8_t             param[2];   /* command parameters (mode, config, EEPROM data) */
+    uint16_t            addr;       /* SRAM / EEPROM address */
+    uint8_t             *data;      /* payload to be written or buffer for the result */
+    uint8_t             length;     /* payload length, updated with the length used */
+    uint8_t             *length_ref;/* if not NULL, length is read from here at start */
+    events_struct_t     events;     /* status bytes returned by the command */
+    uhf_spi_callback_t  callback;
+    uintptr_t           context;
+};
+
+/* Command timing statistics, times in microseconds */
+typedef struct uhf_spi_stats_t {
+    uint32_t commands;      /* completed commands */
+    uint32_t wall_last;     /* CS assert to completion, last command */
+    uint32_t busy_last;     /* CPU time spent in the driver, last command */
+    uint32_t wall_max;
+    uint32_t busy_max;
+    uint32_t wall_avg;
+    uint32_t busy_avg;
+    uint32_t wake_paid;     /* commands started with the T0 wake-up delay */
+    uint32_t wake_skipped;  /* commands started without it (AVR known awake) */
+    uint32_t speed;         /* SCK rate in Hz */
+    uint32_t speed_fallbacks;/* SCK steps down after failed status checks */
+} uhf_spi_stats_t;
+
+/* Trace record of one telegram, times in trace counter ticks */
+typedef struct uhf_spi_trace_t {
+    uint32_t start;         /* CS assert */
+    uint32_t end;           /* command completion, after T5 */
+    uint16_t length;        /* bytes clocked, header and payload */
+    uint8_t  opcode;
+    uint8_t  system;        /* events.system returned by the command */
+    uint8_t  trx;           /* events.trx returned by the command */
+} uhf_spi_trace_t;
+
+/* RX / RSSI FIFO drain, see uhf_spi_drain_submit() */
+typedef struct uhf_spi_drain_t {
+    uint8_t             *rx_data;       /* RX FIFO buffer, NULL to leave the FIFO */
+    uint8_t             rx_size;        /* size of rx_data */
+    uint8_t             rx_length;      /* bytes read from the RX FIFO */
+    uint8_t             *rssi_data;     /* RSSI FIFO buffer, NULL to leave the FIFO */
+    uint8_t             rssi_size;      /* size of rssi_data */
+    uint8_t             rssi_length;    /* bytes read from the RSSI FIFO */
+    events_struct_t     events;         /* status bytes of the first fill level command */
+    bool                byte_int;       /* read with the byte-int commands, while a telegram is still arriving */
+} uhf_spi_drain_t;
+
+/* Streaming RX of telegrams longer than the DFIFO, see uhf_spi_stream_rx_submit() */
+typedef struct uhf_spi_stream_rx_t {
+    uint8_t             *data;          /* reassembly buffer */
+    uint16_t            size;           /* size of data */
+    uint16_t            length;         /* bytes reassembled so far */
+    bool                complete;       /* EOT seen and the FIFO read empty */
+    bool                overrun;        /* bytes lost: full DFIFO or reassembly buffer */
+    uint16_t            reads;          /* FIFO read-outs */
+    uint8_t             fill_max;       /* highest fill level seen, the headroom left */
+    uint8_t             fill;           /* fill level of the read-out in progress */
+    events_struct_t     fill_events;    /* status bytes of its fill level command */
+    uint8_t             events[4];      /* event bytes read after it */
+    volatile bool       busy;           /* read-out queued */
+    bool                eot;            /* EOT seen in the event bytes */
+    bool                tail;           /* read-out queued after EOT */
+    uhf_dev_t           *dev;           /* instance of the read-out */
+} uhf_spi_stream_rx_t;
+
+/* Streaming TX of telegrams longer than the DFIFO, see uhf_spi_stream_tx_start() */
+typedef struct uhf_spi_stream_tx_t {
+    const uint8_t       *data;          /* telegram */
+    uint16_t            length;         /* bytes of data */
+    uint16_t            written;        /* bytes written to the TX FIFO so far */
+    bool                complete;       /* EOT seen */
+    bool                underrun;       /* TX ended before the last byte was written */
+    uint16_t            writes;         /* TX FIFO writes */
+    uint8_t             fill_min;       /* lowest fill level seen during TX, the margin left */
+    uint8_t             fill;           /* fill level of the refill in progress */
+    uint8_t             space;          /* bytes it writes */
+    events_struct_t     fill_events;    /* status bytes of its fill level command */
+    uint8_t             events[4];      /* event bytes read after it */
+    volatile bool       busy;           /* refill queued */
+    uhf_dev_t           *dev;           /* instance of the refill */
+} uhf_spi_stream_tx_t;
+
+/* Transceiver address space of uhf_spi_dump() */
+typedef enum {
+    UHF_SPI_DUMP_EEPROM = 0,
+    UHF_SPI_DUMP_SRAM,
+} uhf_spi_dump_space_t;
+
+/* Dump sink, gets consecutive blocks in address order, false stops the dump after this block */
+typedef bool (*uhf_spi_dump_sink_t)(uhf_spi_dump_space_t space, uint16_t addr, const uint8_t *data, uint16_t length,
+                                    uintptr_t context);
+
+/* RAM buffer of uhf_spi_dump_buffer_sink() */
+typedef struct {
+    uint8_t             *data;
+    uint32_t            size;
+    uint32_t            length;         /* bytes stored so far, set to 0 before the dump */
+} uhf_spi_dump_buffer_t;
+
+/* SRAM register of a register map, see uhf_spi_regmap_init() */
+typedef struct {
+    uint16_t            addr;
+    uint8_t             size;           /* bytes, 1 to 4, little endian like the AVR */
+} uhf_spi_reg_t;
+
+/* EEPROM programming job status, see uhf_spi_eeprom_write_submit() */
+typedef enum {
+    UHF_SPI_EEPROM_IDLE = 0,    /* no job submitted yet */
+    UHF_SPI_EEPROM_BUSY,
+    UHF_SPI_EEPROM_DONE,
+    UHF_SPI_EEPROM_ERROR,       /* secure write rejected (SYS_ERR) or no CMD_RDY in time */
+} uhf_spi_eeprom_status_t;
+
+/* EEPROM programming job completion callback, called from uhf_spi_tasks() */
+typedef void (*uhf_spi_eeprom_callback_t)(uhf_spi_eeprom_status_t status, uint16_t written, uintptr_t context);
+
+/* EEPROM programming job report, see uhf_spi_eeprom_report_get() */
+typedef struct {
+    uint16_t            length;         /* bytes of the block */
+    uint16_t            written;        /* bytes programmed */
+    uint16_t            skipped;        /* bytes already up to date (update job) */
+    uint16_t            chunks;         /* secure writes triggered */
+    uint32_t            compare_us;     /* time spent reading back (update job) */
+    uint32_t            program_us;     /* time from trigger to CMD_RDY, all chunks */
+    uint32_t            saved_us;       /* estimate against programming all bytes */
+} uhf_spi_eeprom_report_t;
+
+/* Channel of an RSSI survey, config is set by the caller, the rest is the result */
+typedef struct {
+    uint8_t             config;         /* service / channel configuration of "Start RSSI Measurement" */
+    uint8_t             min;            /* lowest RSSI average */
+    uint8_t             max;            /* highest RSSI average */
+    uint8_t             percentile;     /* RSSI average at the survey percentile, nearest rank */
+    uint16_t            mean;           /* mean RSSI average, 8.8 fixed point */
+    uint8_t             peak;           /* highest RSSI peak value */
+    uint8_t             samples;        /* samples taken */
+} uhf_spi_rssi_channel_t;
+
+/* RSSI survey, see uhf_spi_rssi_survey_submit() */
+typedef struct {
+    uhf_spi_rssi_channel_t *channels;
+    uint8_t             count;          /* entries of channels */
+    uint8_t             samples;        /* per channel, 1 to UHF_SPI_RSSI_SURVEY_SAMPLES */
+    uint8_t             percentile;     /* 1 to 100, e.g. 90 for the level exceeded 10 % of the time */
+    uint16_t            lost;           /* measurements without CMD_RDY in time, started again */
+    uint16_t            polls;          /* "Get RSSI Value" reads that found no result */
+    uint32_t            duration_us;    /* first start to last result */
+    volatile bool       done;
+} uhf_spi_rssi_survey_t;
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: SPI_ATA8510 Module Interface Routines
@@ -82,7 +316,469 @@ typedef struct events_struct_t {
 // *****************************************************************************
 
 /* Function:
-    void uhf_poweron(void)
+    uhf_dev_t *uhf_spi_initialize(uint8_t index, const uhf_spi_init_t *init)
+
+  Summary:
+    Initialize an ATA8510 SPI driver instance.
+
+  Description:
+    This function binds driver instance index to the SERCOM, DMAC channels,
+    guard timer and pins given in init, resets its command queue, sets the
+    SPI clock to the slowest UHF_SPI_SPEED_LIST rate, converts the SPI guard
+    times to guard timer counts and registers the DMAC and guard timer
+    completion handlers (UHF_SPI_DMA_ENABLE, UHF_SPI_GUARD_TIMER_ENABLE in
+    configuration.h). It returns the handle passed to all other functions,
+    or NULL if index is not below UHF_SPI_INSTANCES_NUMBER. It is called
+    once per instance from SYS_Initialize.
+
+    Instances on separate SERCOMs, DMAC channels and timers run their
+    commands independently and interleaved.
+
+  Remarks:
+    DMAC, SERCOM, TC and SYS_TIME have to be initialized before. init has to
+    stay valid while the instance is used.
+*/
+uhf_dev_t *uhf_spi_initialize(uint8_t index, const uhf_spi_init_t *init);
+
+/* Function:
+    bool uhf_spi_submit(uhf_dev_t *dev, const uhf_spi_cmd_t *cmd)
+
+  Summary:
+    Queue an SPI command for asynchronous execution.
+
+  Description:
+    This function copies the command descriptor into the driver queue and
+    returns immediately. Queued commands are executed back-to-back by
+    uhf_spi_tasks() in submission order, and the callback of the descriptor
+    (if any) is called once the command has completed, with the result bytes
+    already copied to the data buffer.
+
+    When length_ref is set, the payload length is taken from *length_ref at
+    the moment the command starts, limited to length (the buffer size), and
+    the length actually used is written back to *length_ref. This allows a
+    FIFO read to be queued behind the fill level command that produces its
+    length. A FIFO or SRAM transfer of length 0 completes without an SPI
+    transfer.
+
+  Remarks:
+    Returns false if the queue is full (UHF_SPI_QUEUE_LENGTH in
+    configuration.h). The data buffer has to stay valid until completion.
+*/
+bool uhf_spi_submit(uhf_dev_t *dev, const uhf_spi_cmd_t *cmd);
+
+/* Function:
+    bool uhf_spi_submit_chain(uhf_dev_t *dev, const uhf_spi_cmd_t *cmds, uint8_t count)
+
+  Summary:
+    Queue a chain of SPI commands, all of them or none.
+
+  Description:
+    This function queues count command descriptors from cmds like
+    uhf_spi_submit(), back-to-back in array order, if the queue has room for
+    all of them. Otherwise nothing is queued.
+
+  Remarks:
+    Returns false if the queue cannot take the whole chain or count is 0.
+*/
+bool uhf_spi_submit_chain(uhf_dev_t *dev, const uhf_spi_cmd_t *cmds, uint8_t count);
+
+/* Function:
+    void uhf_spi_tasks(uhf_dev_t *dev)
+
+  Summary:
+    Maintain the ATA8510 SPI command queue.
+
+  Description:
+    This function advances the command state machine (chip select, guard
+    times, transfer, completion). It never waits on guard times; it returns
+    as soon as no further step can be made. Guard times are timed by a TC
+    one-shot and the transfer by the DMAC, both signal their end from the
+    interrupt. It is called from SYS_Tasks and from the blocking command
+    functions, which sleep in between.
+
+  Remarks:
+    Completion callbacks are called from this function.
+*/
+void uhf_spi_tasks(uhf_dev_t *dev);
+
+/* Function:
+    bool uhf_spi_is_idle(uhf_dev_t *dev)
+
+  Summary:
+    Check if the command queue is empty.
+
+  Description:
+    This function returns true when no command is queued or in progress.
+
+  Remarks:
+    None.
+*/
+bool uhf_spi_is_idle(uhf_dev_t *dev);
+
+/* Function:
+    void uhf_spi_stats_get(uhf_dev_t *dev, uhf_spi_stats_t *stats)
+
+  Summary:
+    Read the command timing statistics.
+
+  Description:
+    This function returns the wall time (CS assert to completion) and the CPU
+    busy time (time spent executing driver code, sleep excluded) of the last
+    command, their maximum and their average since the last reset, and how
+    often the T0 wake-up delay was paid or skipped.
+
+  Remarks:
+    Times are 0 if UHF_SPI_STATS_ENABLE is 0 in configuration.h; wake
+    counters are 0 if UHF_SPI_WAKE_TRACKING_ENABLE is 0.
+*/
+void uhf_spi_stats_get(uhf_dev_t *dev, uhf_spi_stats_t *stats);
+
+/* Function:
+    void uhf_spi_stats_reset(uhf_dev_t *dev)
+
+  Summary:
+    Clear the command timing statistics.
+
+  Description:
+    This function clears all counters returned by uhf_spi_stats_get().
+
+  Remarks:
+    None.
+*/
+void uhf_spi_stats_reset(uhf_dev_t *dev);
+
+#if (UHF_SPI_TRACE_ENABLE == 1)
+/* Function:
+    uint32_t uhf_spi_trace_get(uhf_dev_t *dev, uhf_spi_trace_t *records, uint32_t size)
+
+  Summary:
+    Copy the trace ring.
+
+  Description:
+    This function copies up to size records of the trace ring to records,
+    oldest first, and returns the number of records copied. The ring holds
+    the last UHF_SPI_TRACE_LENGTH telegrams (configuration.h).
+
+  Remarks:
+    Only available if UHF_SPI_TRACE_ENABLE is 1 in configuration.h. The trace
+    counter wraps, durations have to be computed modulo trace_counter_mask.
+*/
+uint32_t uhf_spi_trace_get(uhf_dev_t *dev, uhf_spi_trace_t *records, uint32_t size);
+
+/* Function:
+    void uhf_spi_trace_dump(uhf_dev_t *dev)
+
+  Summary:
+    Print the trace ring.
+
+  Description:
+    This function prints the trace ring, oldest record first, one line per
+    telegram with opcode, length, start tick, duration and the returned
+    system / trx event bytes, through the trace_write function of the
+    instance (e.g. SERCOM4_USART_Write). The ring is cleared afterwards.
+
+  Remarks:
+    Blocking, call it from the task context on demand only.
+*/
+void uhf_spi_trace_dump(uhf_dev_t *dev);
+
+/* Function:
+    void uhf_spi_trace_reset(uhf_dev_t *dev)
+
+  Summary:
+    Clear the trace ring.
+
+  Description:
+    This function discards all records of the trace ring.
+
+  Remarks:
+    None.
+*/
+void uhf_spi_trace_reset(uhf_dev_t *dev);
+#endif
+
+/* Function:
+    uint32_t uhf_spi_speed_negotiate(uhf_dev_t *dev)
+
+  Summary:
+    Select the fastest reliable SPI clock.
+
+  Description:
+    This function steps the SPI clock through UHF_SPI_SPEED_LIST
+    (configuration.h), slowest first. At each rate it repeats a known-answer
+    test UHF_SPI_SPEED_CHECKS times: "Get Version ROM" has to return the value
+    read at the slowest rate, and a pattern written to the scratch SRAM area
+    at UHF_SPI_SPEED_SCRATCH_ADDR has to read back unchanged. It stops at the
+    first rate that fails and settles UHF_SPI_SPEED_MARGIN steps below the
+    fastest rate that passed. The scratch area is restored afterwards.
+
+    Once running, a status byte pair that fails the sanity check (SYS_ERR set
+    or both bytes 0xFF) UHF_SPI_SPEED_ERROR_LIMIT times in a row makes the
+    driver step down one rate for good.
+
+  Remarks:
+    Blocking, returns the selected rate in Hz. To be called after
+    uhf_power_on() while the transceiver is in IDLE, before "Get Event
+    Bytes" clears the events of the test. A running EEPROM programming job
+    is completed first, it stages its data in SRAM as well.
+*/
+uint32_t uhf_spi_speed_negotiate(uhf_dev_t *dev);
+
+/* Function:
+    uint32_t uhf_spi_speed_get(uhf_dev_t *dev)
+
+  Summary:
+    Return the SPI clock in use.
+
+  Description:
+    This function returns the current SPI clock rate in Hz.
+
+  Remarks:
+    None.
+*/
+uint32_t uhf_spi_speed_get(uhf_dev_t *dev);
+
+/* Function:
+    bool uhf_spi_drain_submit(uhf_dev_t *dev, uhf_spi_drain_t *drain,
+                              uhf_spi_callback_t callback, uintptr_t context)
+
+  Summary:
+    Queue the read-out of the RX and / or RSSI FIFO.
+
+  Description:
+    This function queues "Read Fill Level" and "Read FIFO" for each FIFO with
+    a buffer in the drain descriptor, RX first. Each FIFO read takes its
+    length from the fill level read right before, limited to the buffer size,
+    so a FIFO costs two SPI commands and an empty FIFO only one. The system
+    and trx status bytes of the first fill level command are stored in
+    drain->events, so the events are known without "Get Event Bytes".
+
+    The callback is called once the last FIFO has been read, with
+    rx_length / rssi_length set to the number of bytes read.
+
+    With drain->byte_int set the FIFOs are read with "Read RX / RSSI FIFO
+    Byte Interrupt" instead, for picking up the first bytes of a telegram
+    that is still being received (SOT IRQ). These reads bypass the SPI FIFO
+    and are limited to 30 bytes per FIFO and to data rates up to 250 Kbit/s.
+
+  Remarks:
+    Returns false, with nothing queued, if the queue has not room for the
+    commands. The drain descriptor has to stay valid until completion.
+    "Get Event Bytes" is still needed to clear the events and release the
+    IRQ line.
+*/
+bool uhf_spi_drain_submit(uhf_dev_t *dev, uhf_spi_drain_t *drain, uhf_spi_callback_t callback, uintptr_t context);
+
+/* Function:
+    uint8_t uhf_spi_drain_rx(uhf_dev_t *dev, uint8_t *data, uint8_t size)
+
+  Summary:
+    Read the RX FIFO content.
+
+  Description:
+    This function reads the RX FIFO fill level and then that many bytes, at
+    most size, to data. It returns the number of bytes read.
+
+  Remarks:
+    Blocking, see uhf_spi_drain_submit().
+*/
+uint8_t uhf_spi_drain_rx(uhf_dev_t *dev, uint8_t *data, uint8_t size);
+
+/* Function:
+    uint8_t uhf_spi_drain_rssi(uhf_dev_t *dev, uint8_t *data, uint8_t size)
+
+  Summary:
+    Read the RSSI FIFO content.
+
+  Description:
+    This function reads the RSSI FIFO fill level and then that many bytes, at
+    most size, to data. It returns the number of bytes read.
+
+  Remarks:
+    Blocking, see uhf_spi_drain_submit().
+*/
+uint8_t uhf_spi_drain_rssi(uhf_dev_t *dev, uint8_t *data, uint8_t size);
+
+/* Function:
+    void uhf_spi_drain(uhf_dev_t *dev, uhf_spi_drain_t *drain)
+
+  Summary:
+    Read the RX and RSSI FIFO content.
+
+  Description:
+    This function drains both FIFOs as described for uhf_spi_drain_submit()
+    and returns when done.
+
+  Remarks:
+    Blocking.
+*/
+void uhf_spi_drain(uhf_dev_t *dev, uhf_spi_drain_t *drain);
+
+/* Function:
+    void uhf_spi_stream_rx_init(uhf_spi_stream_rx_t *stream, uint8_t *data, uint16_t size)
+
+  Summary:
+    Prepare a streaming RX reassembly buffer.
+
+  Description:
+    This function resets the stream for the next telegram, which is
+    reassembled into data, up to size bytes.
+
+  Remarks:
+    See uhf_spi_stream_rx_submit().
+*/
+void uhf_spi_stream_rx_init(uhf_spi_stream_rx_t *stream, uint8_t *data, uint16_t size);
+
+/* Function:
+    bool uhf_spi_stream_rx_submit(uhf_dev_t *dev, uhf_spi_stream_rx_t *stream)
+
+  Summary:
+    Queue one read-out of a telegram that is being received.
+
+  Description:
+    A telegram longer than the 32 byte DFIFO has to be read while it is
+    still coming in. The DFIFO fill level event (events.system bit 1, its
+    threshold set in the transceiver configuration) raises the IRQ each
+    time the FIFO has filled up to the threshold, EOT raises it at the end.
+    On each IRQ the application calls this function, which queues
+    "Read Fill Level RX FIFO", "Read RX FIFO" and "Get Event Bytes". The
+    bytes are appended to the stream, up to 255 per read-out, and the event
+    read releases the IRQ line.
+
+    Once the FIFO has been read after EOT, stream->complete is set. A fill
+    level event or EOT that comes up during a read-out is cleared by its
+    event read, so the next read-out is queued right away instead of
+    waiting for the IRQ. stream->overrun is set if the fill level reached
+    the DFIFO size, where the transceiver drops further bytes, or if the
+    telegram does not fit into the reassembly buffer.
+
+  Remarks:
+    Returns false if a read-out of the stream is still queued, the stream
+    is complete or the queue has not room for the three commands.
+    The threshold has to leave the DFIFO enough headroom for the bytes that
+    arrive during a read-out; stream->fill_max shows how much was used.
+*/
+bool uhf_spi_stream_rx_submit(uhf_dev_t *dev, uhf_spi_stream_rx_t *stream);
+
+/* Function:
+    bool uhf_spi_stream_tx_start(uhf_dev_t *dev, uhf_spi_stream_tx_t *stream,
+                                 const uint8_t *data, uint16_t length,
+                                 uint8_t mode, uint8_t config)
+
+  Summary:
+    Start the transmission of a telegram longer than the TX FIFO.
+
+  Description:
+    This function queues "Write TX FIFO" with the first 32 bytes of data
+    and "Set System Mode" with mode / config (TX mode). The rest is written
+    by uhf_spi_stream_tx_submit() while the telegram is on air.
+
+  Remarks:
+    Returns false, with nothing queued, if the queue has not room for the
+    two commands. The TX preamble FIFO is left to the caller, as is reading
+    the event bytes beforehand: an EOT left over from an earlier telegram
+    would end the stream. stream and data have to stay valid until
+    stream->complete.
+*/
+bool uhf_spi_stream_tx_start(uhf_dev_t *dev, uhf_spi_stream_tx_t *stream, const uint8_t *data, uint16_t length,
+                             uint8_t mode, uint8_t config);
+
+/* Function:
+    bool uhf_spi_stream_tx_submit(uhf_dev_t *dev, uhf_spi_stream_tx_t *stream)
+
+  Summary:
+    Queue one refill of the TX FIFO.
+
+  Description:
+    The transceiver ends the telegram when it finds the TX FIFO empty, so
+    the FIFO has to be refilled ahead of the air. The DFIFO fill level
+    event (events.system bit 1) raises the IRQ when the TX FIFO has gone
+    down to its threshold, EOT raises it at the end. On each IRQ the
+    application calls this function, which queues "Read Fill Level TX
+    FIFO", "Write TX FIFO" with as many bytes as there is room for and
+    "Get Event Bytes", which releases the IRQ line. A fill level event
+    that comes up during the refill is followed up right away.
+
+    stream->complete is set with EOT. stream->underrun is set if the
+    telegram ended, or was found ended, before all of data was written.
+
+  Remarks:
+    Returns false if a refill of the stream is still queued, the stream is
+    complete or the queue has not room for the three commands.
+    stream->fill_min shows the margin left at the refill threshold.
+*/
+bool uhf_spi_stream_tx_submit(uhf_dev_t *dev, uhf_spi_stream_tx_t *stream);
+
+/* Function:
+    const events_struct_t *uhf_spi_events_get(uhf_dev_t *dev)
+
+  Summary:
+    Return the last event bytes of a transceiver.
+
+  Description:
+    This function returns the events.system and events.trx status bytes
+    returned by the last command of the instance.
+
+  Remarks:
+    None.
+*/
+const events_struct_t *uhf_spi_events_get(uhf_dev_t *dev);
+
+/* Function:
+    bool uhf_irq_get(uhf_dev_t *dev)
+
+  Summary:
+    Read the IRQ line of a transceiver.
+
+  Description:
+    This function returns the level of the IRQ pin; the line is active low.
+
+  Remarks:
+    None.
+*/
+bool uhf_irq_get(uhf_dev_t *dev);
+
+#if (UHF_SPI_IRQ_EIC_ENABLE == 1)
+/* Function:
+    bool uhf_spi_irq_take(uhf_dev_t *dev, uint32_t *stamp)
+
+  Summary:
+    Fetch the last falling edge of the IRQ line.
+
+  Description:
+    The EIC interrupt of the IRQ pin records the SYS_TIME counter of every
+    falling edge. This function returns true and the time of the latest
+    edge if one has been recorded since the last call, false otherwise.
+
+  Remarks:
+    Safe against an edge arriving during the call; that edge is returned
+    either now or by the next call. Edges caused by commands the driver
+    waits for itself (EEPROM job, RSSI survey) are recorded as well, the
+    IRQ line level tells whether an event is still pending.
+*/
+bool uhf_spi_irq_take(uhf_dev_t *dev, uint32_t *stamp);
+#endif
+
+/* Function:
+    bool uhf_spi_sleep_allowed(uhf_dev_t *dev)
+
+  Summary:
+    Tell whether the CPU may sleep as far as the driver is concerned.
+
+  Description:
+    This function returns true if the instance is idle or its command in
+    progress waits for a DMAC or guard timer interrupt, so that WFI does
+    not stall it.
+
+  Remarks:
+    Call with interrupts disabled and execute WFI before enabling them
+    again, otherwise an interrupt between the check and WFI is missed
+    until the next one.
+*/
+bool uhf_spi_sleep_allowed(uhf_dev_t *dev);
+
+/* Function:
+    void uhf_poweron(uhf_dev_t *dev)
 
   Summary:
     Power on UHF transceiver.
@@ -94,10 +790,10 @@ typedef struct events_struct_t {
   Remarks:
     NRESET pin and NPWRON1 pin have to be configured.
 */
-void uhf_power_on(void);
+void uhf_power_on(uhf_dev_t *dev);
 
 /* Function:
-    uint8_t uhf_spi_read_fill_level_rx_fifo(void)
+    uint8_t uhf_spi_read_fill_level_rx_fifo(uhf_dev_t *dev)
 
   Summary:
     Read Fill Level RX FIFO.
@@ -109,10 +805,10 @@ void uhf_power_on(void);
   Remarks:
     Refer user guide for more information.
 */
-uint8_t uhf_spi_read_fill_level_rx_fifo(void);
+uint8_t uhf_spi_read_fill_level_rx_fifo(uhf_dev_t *dev);
 
 /* Function:
-    uint8_t uhf_spi_read_fill_level_tx_fifo(void)
+    uint8_t uhf_spi_read_fill_level_tx_fifo(uhf_dev_t *dev)
 
   Summary:
     Read Fill Level TX FIFO.
@@ -124,10 +820,10 @@ uint8_t uhf_spi_read_fill_level_rx_fifo(void);
   Remarks:
     Refer user guide for more information.
 */
-uint8_t uhf_spi_read_fill_level_tx_fifo(void);
+uint8_t uhf_spi_read_fill_level_tx_fifo(uhf_dev_t *dev);
 
 /* Function:
-    uint8_t uhf_spi_read_fill_level_rssi_fifo(void)
+    uint8_t uhf_spi_read_fill_level_rssi_fifo(uhf_dev_t *dev)
 
   Summary:
     Read Fill Level RSSI FIFO.
@@ -139,10 +835,10 @@ uint8_t uhf_spi_read_fill_level_tx_fifo(void);
   Remarks:
     Refer user guide for more information.
 */
-uint8_t uhf_spi_read_fill_level_rssi_fifo(void);
+uint8_t uhf_spi_read_fill_level_rssi_fifo(uhf_dev_t *dev);
 
 /* Function:
-    void uhf_spi_get_event_bytes(uint8_t *events)
+    void uhf_spi_get_event_bytes(uhf_dev_t *dev, uint8_t *events)
 
   Summary:
     Get Event Bytes.
@@ -158,10 +854,10 @@ uint8_t uhf_spi_read_fill_level_rssi_fifo(void);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_get_event_bytes(uint8_t *events);
+void uhf_spi_get_event_bytes(uhf_dev_t *dev, uint8_t *events);
 
 /* Function:
-    void uhf_spi_read_rssi_fifo(uint8_t *data, uint8_t length)
+    void uhf_spi_read_rssi_fifo(uhf_dev_t *dev, uint8_t *data, uint8_t length)
 
   Summary:
     Read RSSI FIFO.
@@ -174,12 +870,14 @@ void uhf_spi_get_event_bytes(uint8_t *events);
     (direction temporarily stored in the T-bit).
 
   Remarks:
-    Refer user guide for more information.
+    The data bytes are clocked straight into the data buffer, so length is
+    not limited by the driver buffer size. Refer user guide for more
+    information.
 */
-void uhf_spi_read_rssi_fifo(uint8_t *data, uint8_t length);
+void uhf_spi_read_rssi_fifo(uhf_dev_t *dev, uint8_t *data, uint8_t length);
 
 /* Function:
-    void uhf_spi_read_rx_fifo(uint8_t *data, uint8_t length)
+    void uhf_spi_read_rx_fifo(uhf_dev_t *dev, uint8_t *data, uint8_t length)
 
   Summary:
     Read RX FIFO.
@@ -192,12 +890,14 @@ void uhf_spi_read_rssi_fifo(uint8_t *data, uint8_t length);
     (direction temporarily stored in the T-bit).
 
   Remarks:
-    Refer user guide for more information.
+    The data bytes are clocked straight into the data buffer, so length is
+    not limited by the driver buffer size. Refer user guide for more
+    information.
 */
-void uhf_spi_read_rx_fifo(uint8_t *data, uint8_t length);
+void uhf_spi_read_rx_fifo(uhf_dev_t *dev, uint8_t *data, uint8_t length);
 
 /* Function:
-    void uhf_spi_write_sram_reg(uint16_t addr, uint8_t *data, uint8_t length)
+    void uhf_spi_write_sram_reg(uhf_dev_t *dev, uint16_t addr, uint8_t *data, uint8_t length)
 
   Summary:
     Write SRAM/Register.
@@ -209,10 +909,10 @@ void uhf_spi_read_rx_fifo(uint8_t *data, uint8_t length);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_write_sram_reg(uint16_t addr, uint8_t *data, uint8_t length);
+void uhf_spi_write_sram_reg(uhf_dev_t *dev, uint16_t addr, uint8_t *data, uint8_t length);
 
 /* Function:
-    void uhf_spi_read_sram_reg(uint16_t addr, uint8_t *data, uint8_t length)
+    void uhf_spi_read_sram_reg(uhf_dev_t *dev, uint16_t addr, uint8_t *data, uint8_t length)
 
   Summary:
     Read SRAM/Register.
@@ -224,10 +924,10 @@ void uhf_spi_write_sram_reg(uint16_t addr, uint8_t *data, uint8_t length);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_read_sram_reg(uint16_t addr, uint8_t *data, uint8_t length);
+void uhf_spi_read_sram_reg(uhf_dev_t *dev, uint16_t addr, uint8_t *data, uint8_t length);
 
 /* Function:
-    void uhf_spi_write_eeprom(uint16_t addr, uint8_t data)
+    void uhf_spi_write_eeprom(uhf_dev_t *dev, uint16_t addr, uint8_t data)
 
   Summary:
     Write EEPROM.
@@ -239,10 +939,10 @@ void uhf_spi_read_sram_reg(uint16_t addr, uint8_t *data, uint8_t length);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_write_eeprom(uint16_t addr, uint8_t data);
+void uhf_spi_write_eeprom(uhf_dev_t *dev, uint16_t addr, uint8_t data);
 
 /* Function:
-    void uhf_spi_write_eeprom_block(uint16_t addr, uint8_t *data, uint8_t len)
+    bool uhf_spi_write_eeprom_block(uhf_dev_t *dev, uint16_t addr, uint8_t *data, uint8_t len)
 
   Summary:
     Write EEPROM block.
@@ -252,12 +952,315 @@ void uhf_spi_write_eeprom(uint16_t addr, uint8_t data);
     address.
 
   Remarks:
-    Use SPI command "Write EEPROM" and "Trigger EEPROM Secure Write".
+    Blocking, see uhf_spi_eeprom_write_submit(). A running EEPROM
+    programming job is completed first. Returns false if len is 0 or the
+    block could not be programmed.
+*/
+bool uhf_spi_write_eeprom_block(uhf_dev_t *dev, uint16_t addr, uint8_t *data, uint8_t len);
+
+/* Function:
+    bool uhf_spi_eeprom_write_submit(uhf_dev_t *dev, uint16_t addr, const uint8_t *data,
+                                     uint16_t length, uhf_spi_eeprom_callback_t callback,
+                                     uintptr_t context)
+
+  Summary:
+    Start programming an EEPROM block in the background.
+
+  Description:
+    This function starts a job that programs length bytes from data to the
+    EEPROM at addr, in chunks of up to 7 bytes. Each chunk is staged with one
+    "Write SRAM" command to 0x02E9 - 0x02EC (address high, address low,
+    length, data) and programmed with "Trigger EEPROM Secure Write".
+
+    The chunk is complete once a status byte shows CMD_RDY again. Every
+    command of the instance counts, so traffic of the application detects
+    it as well; while the queue is idle the job polls with "Read Fill Level
+    RX FIFO" every UHF_SPI_EEPROM_POLL_US. A chunk fails on SYS_ERR or when
+    CMD_RDY does not show up within UHF_SPI_EEPROM_TIMEOUT_US per byte.
+
+    The job is advanced by uhf_spi_tasks(), so other commands keep running
+    meanwhile. The callback is called once with the final status and the
+    number of bytes programmed.
+
+  Remarks:
+    Returns false if a job is already running or length is 0. data has to
+    stay valid until completion. Commands that clear events.system, such as
+    "Get Event Bytes", still report CMD_RDY in their own status bytes.
+*/
+bool uhf_spi_eeprom_write_submit(uhf_dev_t *dev, uint16_t addr, const uint8_t *data, uint16_t length,
+                                 uhf_spi_eeprom_callback_t callback, uintptr_t context);
+
+/* Function:
+    bool uhf_spi_update_eeprom_block(uhf_dev_t *dev, uint16_t addr, uint8_t *data, uint8_t len)
+
+  Summary:
+    Update EEPROM block, programming changed bytes only.
+
+  Description:
+    The function brings n (n = len) consecutive EEPROM bytes at the given
+    address to the content of data, skipping bytes that already match.
+
+  Remarks:
+    Blocking, see uhf_spi_eeprom_update_submit(). A running EEPROM
+    programming job is completed first. Returns false if len is 0 or the
+    block could not be programmed.
+*/
+bool uhf_spi_update_eeprom_block(uhf_dev_t *dev, uint16_t addr, uint8_t *data, uint8_t len);
+
+/* Function:
+    bool uhf_spi_eeprom_update_submit(uhf_dev_t *dev, uint16_t addr, const uint8_t *data,
+                                      uint16_t length, uhf_spi_eeprom_callback_t callback,
+                                      uintptr_t context)
+
+  Summary:
+    Start updating an EEPROM block in the background.
+
+  Description:
+    This function starts a job like uhf_spi_eeprom_write_submit() that reads
+    the current content back with "Read EEPROM" first, up to 7 bytes ahead,
+    and only programs the bytes that differ. Unchanged bytes in front of a
+    change are skipped. A chunk starts at a changed byte and takes in the
+    following changed bytes of the same 7 byte window as long as no more
+    than UHF_SPI_EEPROM_MERGE_GAP unchanged bytes lie in between, since one
+    secure write is cheaper than two for short gaps.
+
+    The callback reports the number of bytes programmed; the skipped bytes
+    and times are returned by uhf_spi_eeprom_report_get().
+
+  Remarks:
+    Returns false if a job is already running or length is 0. data has to
+    stay valid until completion. A block that already matches completes
+    without any secure write.
+*/
+bool uhf_spi_eeprom_update_submit(uhf_dev_t *dev, uint16_t addr, const uint8_t *data, uint16_t length,
+                                  uhf_spi_eeprom_callback_t callback, uintptr_t context);
+
+/* Function:
+    uhf_spi_eeprom_status_t uhf_spi_eeprom_write_status(uhf_dev_t *dev, uint16_t *written)
+
+  Summary:
+    Return the status of the EEPROM programming job.
+
+  Description:
+    This function returns the status of the running or last job and, if
+    written is not NULL, the number of bytes programmed so far.
+
+  Remarks:
+    None.
+*/
+uhf_spi_eeprom_status_t uhf_spi_eeprom_write_status(uhf_dev_t *dev, uint16_t *written);
+
+/* Function:
+    void uhf_spi_eeprom_report_get(uhf_dev_t *dev, uhf_spi_eeprom_report_t *report)
+
+  Summary:
+    Return the report of the EEPROM programming job.
+
+  Description:
+    This function fills report with the byte counts and times of the running
+    or last job. saved_us estimates the time saved against programming the
+    whole block, at the per byte rate seen for the programmed bytes (or
+    UHF_SPI_EEPROM_TIMEOUT_US per byte if none was programmed), minus the
+    time spent reading back.
+
+  Remarks:
+    None.
+*/
+void uhf_spi_eeprom_report_get(uhf_dev_t *dev, uhf_spi_eeprom_report_t *report);
+
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+/* Function:
+    bool uhf_spi_eeprom_shadow_add(uhf_dev_t *dev, uint16_t addr, uint16_t length)
+
+  Summary:
+    Add an EEPROM range to the RAM shadow.
+
+  Description:
+    This function adds length bytes from addr to the ranges held in RAM.
+    Overlapping or adjacent ranges are merged, so each byte is read once.
+    The shadow is invalid until the next uhf_spi_eeprom_shadow_fill().
+
+  Remarks:
+    Only available if UHF_SPI_EEPROM_SHADOW_ENABLE is 1 in configuration.h.
+    Returns false, leaving the shadow as it is, if the merged ranges exceed
+    UHF_SPI_EEPROM_SHADOW_RANGES or UHF_SPI_EEPROM_SHADOW_SIZE bytes.
+*/
+bool uhf_spi_eeprom_shadow_add(uhf_dev_t *dev, uint16_t addr, uint16_t length);
+
+/* Function:
+    bool uhf_spi_eeprom_shadow_fill(uhf_dev_t *dev)
+
+  Summary:
+    Read the shadowed EEPROM ranges into RAM.
+
+  Description:
+    This function reads every shadowed byte with "Read EEPROM", all queued
+    back to back, and records a Fletcher-16 checksum of the content. From
+    then on uhf_spi_read_eeprom() serves these bytes from RAM, and
+    uhf_spi_eeprom_update_submit() compares against them without reading
+    back. uhf_spi_write_eeprom() and the EEPROM programming jobs update the
+    shadow as bytes are programmed; a failed job invalidates it.
+
+  Remarks:
+    Blocking, call it once at start-up. Returns false if no range was added
+    or an EEPROM programming job is running.
 */
-void uhf_spi_write_eeprom_block(uint16_t addr, uint8_t *data, uint8_t len);
+bool uhf_spi_eeprom_shadow_fill(uhf_dev_t *dev);
 
 /* Function:
-    uint8_t uhf_spi_read_eeprom(uint16_t addr)
+    bool uhf_spi_eeprom_shadow_verify(uhf_dev_t *dev)
+
+  Summary:
+    Check the RAM shadow against the EEPROM.
+
+  Description:
+    This function reads the shadowed bytes again and compares their
+    checksum with the one of the shadow, which detects an EEPROM
+    reprogrammed other than through this driver (or a corrupted RAM copy).
+    On a mismatch the shadow is invalidated, reads go to the transceiver
+    again until the next uhf_spi_eeprom_shadow_fill().
+
+  Remarks:
+    Blocking. Returns false on a mismatch, if the shadow is not valid or if
+    an EEPROM programming job is running.
+*/
+bool uhf_spi_eeprom_shadow_verify(uhf_dev_t *dev);
+#endif
+
+/* Function:
+    uint32_t uhf_spi_dump(uhf_dev_t *dev, uhf_spi_dump_space_t space, uint16_t addr,
+                          uint32_t length, uhf_spi_dump_sink_t sink, uintptr_t context)
+
+  Summary:
+    Dump an EEPROM or SRAM range to a sink.
+
+  Description:
+    This function reads length bytes from addr of the given address space and
+    hands them to sink in blocks of up to UHF_SPI_DUMP_CHUNK_LENGTH bytes, in
+    address order. SRAM is read with one "Read SRAM" telegram per block, the
+    payload going straight into the block. "Read EEPROM" returns one byte per
+    telegram, so EEPROM blocks are read with back to back queued telegrams,
+    bound by the guard times as uhf_spi_read_eeprom() is; only bytes held by
+    a valid EEPROM shadow are taken from RAM. The sink is
+    called with CS released, and the instance starts no telegram until it
+    returns.
+
+    The function returns the number of bytes handed to sink.
+
+  Remarks:
+    Blocking. Stops after the block for which sink returns false. The sink
+    must not use the instance. The dump does not lock out other commands;
+    for a consistent SRAM image, keep the transceiver idle meanwhile.
+*/
+uint32_t uhf_spi_dump(uhf_dev_t *dev, uhf_spi_dump_space_t space, uint16_t addr, uint32_t length,
+                      uhf_spi_dump_sink_t sink, uintptr_t context);
+
+/* Function:
+    bool uhf_spi_dump_buffer_sink(uhf_spi_dump_space_t space, uint16_t addr, const uint8_t *data,
+                                  uint16_t length, uintptr_t context)
+
+  Summary:
+    Dump sink that stores into a RAM buffer.
+
+  Description:
+    This sink for uhf_spi_dump() appends the blocks to the
+    uhf_spi_dump_buffer_t passed as context.
+
+  Remarks:
+    Returns false, stopping the dump, once the buffer is full.
+*/
+bool uhf_spi_dump_buffer_sink(uhf_spi_dump_space_t space, uint16_t addr, const uint8_t *data, uint16_t length,
+                              uintptr_t context);
+
+#if (UHF_SPI_REGMAP_ENABLE == 1)
+/* Function:
+    bool uhf_spi_regmap_init(uhf_dev_t *dev, const uhf_spi_reg_t *reg, uint8_t count)
+
+  Summary:
+    Set up the SRAM register map.
+
+  Description:
+    This function sets up a RAM mirror of the count SRAM registers in reg.
+    The application names the registers by their index in reg, e.g. with
+    an enum next to the table. The mirror starts all zero and clean; use
+    uhf_spi_regmap_load() to take over the transceiver values.
+
+  Remarks:
+    Only available if UHF_SPI_REGMAP_ENABLE is 1 in configuration.h. reg
+    has to stay valid and be sorted by address without overlaps. Returns
+    false if it is not, or if it exceeds UHF_SPI_REGMAP_REGISTERS registers
+    or UHF_SPI_REGMAP_SIZE bytes.
+*/
+bool uhf_spi_regmap_init(uhf_dev_t *dev, const uhf_spi_reg_t *reg, uint8_t count);
+
+/* Function:
+    void uhf_spi_regmap_load(uhf_dev_t *dev)
+
+  Summary:
+    Read the mapped registers into the mirror.
+
+  Description:
+    This function reads all mapped registers with one "Read SRAM" per run
+    of address-contiguous registers and marks them clean.
+
+  Remarks:
+    Blocking.
+*/
+void uhf_spi_regmap_load(uhf_dev_t *dev);
+
+/* Function:
+    void uhf_spi_regmap_set(uhf_dev_t *dev, uint8_t index, uint32_t value)
+
+  Summary:
+    Set a mapped register in the mirror.
+
+  Description:
+    This function stores value into the mirror of register index and marks
+    it dirty if the value changed. Nothing is sent until
+    uhf_spi_regmap_flush().
+
+  Remarks:
+    Bits beyond the register size are ignored.
+*/
+void uhf_spi_regmap_set(uhf_dev_t *dev, uint8_t index, uint32_t value);
+
+/* Function:
+    uint32_t uhf_spi_regmap_get(uhf_dev_t *dev, uint8_t index)
+
+  Summary:
+    Return a mapped register from the mirror.
+
+  Description:
+    This function returns the mirrored value of register index, including
+    changes not flushed yet.
+
+  Remarks:
+    No SPI traffic.
+*/
+uint32_t uhf_spi_regmap_get(uhf_dev_t *dev, uint8_t index);
+
+/* Function:
+    uint8_t uhf_spi_regmap_flush(uhf_dev_t *dev)
+
+  Summary:
+    Write the dirty registers to the transceiver.
+
+  Description:
+    This function writes the dirty registers with as few "Write SRAM"
+    telegrams as possible: dirty registers at contiguous addresses go out
+    as one payload, and once the mirror has been loaded, runs of up to
+    UHF_SPI_REGMAP_MERGE_GAP clean bytes in between are written along
+    rather than starting another telegram. It returns the number of
+    telegrams sent.
+
+  Remarks:
+    Blocking. The telegrams are queued back to back.
+*/
+uint8_t uhf_spi_regmap_flush(uhf_dev_t *dev);
+#endif
+
+/* Function:
+    uint8_t uhf_spi_read_eeprom(uhf_dev_t *dev, uint16_t addr)
 
   Summary:
     Read EEPROM.
@@ -267,12 +1270,13 @@ void uhf_spi_write_eeprom_block(uint16_t addr, uint8_t *data, uint8_t len);
     address.
 
   Remarks:
-    Refer user guide for more information.
+    Refer user guide for more information. Bytes held by a valid EEPROM
+    shadow are returned from RAM, see uhf_spi_eeprom_shadow_fill().
 */
-uint8_t uhf_spi_read_eeprom(uint16_t addr);
+uint8_t uhf_spi_read_eeprom(uhf_dev_t *dev, uint16_t addr);
 
 /* Function:
-    void uhf_spi_write_tx_fifo(uint8_t *data, uint8_t length)
+    void uhf_spi_write_tx_fifo(uhf_dev_t *dev, uint8_t *data, uint8_t length)
 
   Summary:
     Write TX FIFO.
@@ -287,10 +1291,10 @@ uint8_t uhf_spi_read_eeprom(uint16_t addr);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_write_tx_fifo(uint8_t *data, uint8_t length);
+void uhf_spi_write_tx_fifo(uhf_dev_t *dev, uint8_t *data, uint8_t length);
 
 /* Function:
-    void uhf_spi_write_tx_preamble_fifo(uint8_t *data, uint8_t length)
+    void uhf_spi_write_tx_preamble_fifo(uhf_dev_t *dev, uint8_t *data, uint8_t length)
 
   Summary:
     Write TX Preamble FIFO.
@@ -305,10 +1309,10 @@ void uhf_spi_write_tx_fifo(uint8_t *data, uint8_t length);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_write_tx_preamble_fifo(uint8_t *data, uint8_t length);
+void uhf_spi_write_tx_preamble_fifo(uhf_dev_t *dev, uint8_t *data, uint8_t length);
 
 /* Function:
-    void uhf_spi_set_system_mode(uint8_t system_mode_config, uint8_t service_channel_config)
+    void uhf_spi_set_system_mode(uhf_dev_t *dev, uint8_t system_mode_config, uint8_t service_channel_config)
 
   Summary:
     Set System Mode.
@@ -322,10 +1326,10 @@ void uhf_spi_write_tx_preamble_fifo(uint8_t *data, uint8_t length);
     and registers.
     Refer user guide for more information.
 */
-void uhf_spi_set_system_mode(uint8_t system_mode_config, uint8_t service_channel_config);
+void uhf_spi_set_system_mode(uhf_dev_t *dev, uint8_t system_mode_config, uint8_t service_channel_config);
 
 /* Function:
-    void uhf_spi_calibrate_and_check(uint8_t tune_check_config, uint8_t service_channel_config)
+    void uhf_spi_calibrate_and_check(uhf_dev_t *dev, uint8_t tune_check_config, uint8_t service_channel_config)
 
   Summary:
     Calibrate and Check.
@@ -339,10 +1343,10 @@ void uhf_spi_set_system_mode(uint8_t system_mode_config, uint8_t service_channel
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_calibrate_and_check(uint8_t tune_check_config, uint8_t service_channel_config);
+void uhf_spi_calibrate_and_check(uhf_dev_t *dev, uint8_t tune_check_config, uint8_t service_channel_config);
 
 /* Function:
-    void uhf_spi_patch_spi(uint8_t parameter)
+    void uhf_spi_patch_spi(uhf_dev_t *dev, uint8_t parameter)
 
   Summary:
     Patch SPI.
@@ -358,10 +1362,10 @@ void uhf_spi_calibrate_and_check(uint8_t tune_check_config, uint8_t service_chan
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_patch_spi(uint8_t parameter);
+void uhf_spi_patch_spi(uhf_dev_t *dev, uint8_t parameter);
 
 /* Function:
-    void uhf_spi_system_reset_ROM(void)
+    void uhf_spi_system_reset_ROM(uhf_dev_t *dev)
 
   Summary:
     System Reset ROM.
@@ -372,10 +1376,10 @@ void uhf_spi_patch_spi(uint8_t parameter);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_system_reset_ROM(void);
+void uhf_spi_system_reset_ROM(uhf_dev_t *dev);
 
 /* Function:
-    uint8_t uhf_spi_get_version_ROM(void)
+    uint8_t uhf_spi_get_version_ROM(uhf_dev_t *dev)
 
   Summary:
     Get Version ROM.
@@ -386,10 +1390,10 @@ void uhf_spi_system_reset_ROM(void);
   Remarks:
     Refer user guide for more information.
 */
-uint8_t uhf_spi_get_version_ROM(void);
+uint8_t uhf_spi_get_version_ROM(uhf_dev_t *dev);
 
 /* Function:
-    uint8_t uhf_spi_get_version_flash(uint8_t flash_version[], uint8_t *customer)
+    uint8_t uhf_spi_get_version_flash(uhf_dev_t *dev, uint8_t flash_version[], uint8_t *customer)
 
   Summary:
     Get Version Flash.
@@ -403,10 +1407,10 @@ uint8_t uhf_spi_get_version_ROM(void);
   Remarks:
     Refer user guide for more information.
 */
-uint8_t uhf_spi_get_version_flash(uint8_t flash_version[], uint8_t *customer);
+uint8_t uhf_spi_get_version_flash(uhf_dev_t *dev, uint8_t flash_version[], uint8_t *customer);
 
 /* Function:
-    void uhf_spi_customer_conf_cmd(void)
+    void uhf_spi_customer_conf_cmd(uhf_dev_t *dev)
 
   Summary:
     Customer Configurable Command.
@@ -421,10 +1425,10 @@ uint8_t uhf_spi_get_version_flash(uint8_t flash_version[], uint8_t *customer);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_customer_conf_cmd(void);
+void uhf_spi_customer_conf_cmd(uhf_dev_t *dev);
 
 /* Function:
-    void uhf_spi_system_reset(void)
+    void uhf_spi_system_reset(uhf_dev_t *dev)
 
   Summary:
     System Reset.
@@ -436,10 +1440,10 @@ void uhf_spi_customer_conf_cmd(void);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_system_reset(void);
+void uhf_spi_system_reset(uhf_dev_t *dev);
 
 /* Function:
-    void uhf_spi_trigger_eeprom_secure_write(void)
+    void uhf_spi_trigger_eeprom_secure_write(uhf_dev_t *dev)
 
   Summary:
     Trigger EEPROM Secure Write.
@@ -461,10 +1465,10 @@ void uhf_spi_system_reset(void);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_trigger_eeprom_secure_write(void);
+void uhf_spi_trigger_eeprom_secure_write(uhf_dev_t *dev);
 
 /* Function:
-    void uhf_spi_set_voltage_monitor(uint8_t reg_vmcsr)
+    void uhf_spi_set_voltage_monitor(uhf_dev_t *dev, uint8_t reg_vmcsr)
 
   Summary:
     Set Voltage Monitor.
@@ -477,10 +1481,10 @@ void uhf_spi_trigger_eeprom_secure_write(void);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_set_voltage_monitor(uint8_t reg_vmcsr);
+void uhf_spi_set_voltage_monitor(uhf_dev_t *dev, uint8_t reg_vmcsr);
 
 /* Function:
-    void uhf_spi_off_command(void)
+    void uhf_spi_off_command(uhf_dev_t *dev)
 
   Summary:
     OFF Command.
@@ -491,10 +1495,10 @@ void uhf_spi_set_voltage_monitor(uint8_t reg_vmcsr);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_off_command(void);
+void uhf_spi_off_command(uhf_dev_t *dev);
 
 /* Function:
-    uint16_t uhf_spi_read_temperature_value(void)
+    uint16_t uhf_spi_read_temperature_value(uhf_dev_t *dev)
 
   Summary:
     Read Temperature Value.
@@ -507,10 +1511,10 @@ void uhf_spi_off_command(void);
   Remarks:
     Refer user guide for more information.
 */
-uint16_t uhf_spi_read_temperature_value(void);
+uint16_t uhf_spi_read_temperature_value(uhf_dev_t *dev);
 
 /* Function:
-    void uhf_spi_init_sram_service(uint8_t sram_service_nr, uint8_t eep_service_nr)
+    void uhf_spi_init_sram_service(uhf_dev_t *dev, uint8_t sram_service_nr, uint8_t eep_service_nr)
 
   Summary:
     Init SRAM Service.
@@ -526,10 +1530,10 @@ uint16_t uhf_spi_read_temperature_value(void);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_init_sram_service(uint8_t sram_service_nr, uint8_t eep_service_nr);
+void uhf_spi_init_sram_service(uhf_dev_t *dev, uint8_t sram_service_nr, uint8_t eep_service_nr);
 
 /* Function:
-    void uhf_spi_start_rssi_meas(uint8_t service_channel_config)
+    void uhf_spi_start_rssi_meas(uhf_dev_t *dev, uint8_t service_channel_config)
 
   Summary:
     Start RSSI Measurement.
@@ -546,10 +1550,10 @@ void uhf_spi_init_sram_service(uint8_t sram_service_nr, uint8_t eep_service_nr);
     determined.
     Refer user guide for more information.
 */
-void uhf_spi_start_rssi_meas(uint8_t service_channel_config);
+void uhf_spi_start_rssi_meas(uhf_dev_t *dev, uint8_t service_channel_config);
 
 /* Function:
-    uint16_t uhf_spi_get_rssi_value(void)
+    uint16_t uhf_spi_get_rssi_value(uhf_dev_t *dev)
 
   Summary:
     Get RSSI Value.
@@ -563,10 +1567,62 @@ void uhf_spi_start_rssi_meas(uint8_t service_channel_config);
   Remarks:
     Refer user guide for more information.
 */
-uint16_t uhf_spi_get_rssi_value(void);
+uint16_t uhf_spi_get_rssi_value(uhf_dev_t *dev);
+
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+/* Function:
+    bool uhf_spi_rssi_survey_submit(uhf_dev_t *dev, uhf_spi_rssi_survey_t *survey)
+
+  Summary:
+    Start an RSSI survey of several service / channel configurations.
+
+  Description:
+    This function starts a job that takes survey->samples RSSI measurements
+    on each of the survey->count channels in turn and fills in their
+    statistics: min, max and mean (8.8 fixed point) of the RSSI average,
+    the nearest-rank survey->percentile of it and the highest peak value.
+
+    Per sample, "Start RSSI Measurement" is queued and the IRQ line is
+    checked every UHF_SPI_RSSI_POLL_US, without SPI traffic, until CMD_RDY
+    pulls it. "Get RSSI Value" then reads the result and, if its status
+    bytes show CMD_RDY, the next measurement is queued from its callback,
+    so two telegrams and at most one poll interval lie between two
+    measurements. An IRQ for another event is released with "Get Event
+    Bytes" and counted in survey->polls. A measurement without CMD_RDY
+    within UHF_SPI_RSSI_TIMEOUT_US is counted in survey->lost and started
+    again.
+
+    The job is advanced by uhf_spi_tasks(); survey->done is set once all
+    channels are complete.
+
+  Remarks:
+    Only available if UHF_SPI_RSSI_SURVEY_ENABLE is 1 in configuration.h.
+    Returns false if a survey is already running or the survey is empty or
+    out of range. The transceiver should be in IDLE mode, with the RSSI
+    measurement enabled in eepServices.rssiSysConf of the services used.
+    channels has to stay valid until completion.
+*/
+bool uhf_spi_rssi_survey_submit(uhf_dev_t *dev, uhf_spi_rssi_survey_t *survey);
+
+/* Function:
+    bool uhf_spi_rssi_survey(uhf_dev_t *dev, uhf_spi_rssi_survey_t *survey)
+
+  Summary:
+    Run an RSSI survey.
+
+  Description:
+    Blocking version of uhf_spi_rssi_survey_submit(), returns once
+    survey->done is set.
+
+  Remarks:
+    Only available if UHF_SPI_RSSI_SURVEY_ENABLE is 1 in configuration.h.
+    Returns false without a measurement if the survey cannot be started.
+*/
+bool uhf_spi_rssi_survey(uhf_dev_t *dev, uhf_spi_rssi_survey_t *survey);
+#endif
 
 /* Function:
-    void uhf_spi_read_rx_fifo_byte_int(uint8_t *data, uint8_t length)
+    void uhf_spi_read_rx_fifo_byte_int(uhf_dev_t *dev, uint8_t *data, uint8_t length)
 
   Summary:
     Read Rx FIFO Byte Interrupt.
@@ -587,10 +1643,10 @@ uint16_t uhf_spi_get_rssi_value(void);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_read_rx_fifo_byte_int(uint8_t *data, uint8_t length);
+void uhf_spi_read_rx_fifo_byte_int(uhf_dev_t *dev, uint8_t *data, uint8_t length);
 
 /* Function:
-    void uhf_spi_read_rssi_fifo_byte_int(uint8_t *data, uint8_t length)
+    void uhf_spi_read_rssi_fifo_byte_int(uhf_dev_t *dev, uint8_t *data, uint8_t length)
 
   Summary:
     Read RSSI FIFO Byte Interrupt.
@@ -611,9 +1667,7 @@ void uhf_spi_read_rx_fifo_byte_int(uint8_t *data, uint8_t length);
   Remarks:
     Refer user guide for more information.
 */
-void uhf_spi_read_rssi_fifo_byte_int(uint8_t *data, uint8_t length);
-
-extern events_struct_t g_events;
+void uhf_spi_read_rssi_fifo_byte_int(uhf_dev_t *dev, uint8_t *data, uint8_t length);
 
 #ifdef __cplusplus
 }
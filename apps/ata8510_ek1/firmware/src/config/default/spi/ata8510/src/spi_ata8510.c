@@ -59,9 +59,50 @@
 // *****************************************************************************
 // *****************************************************************************
 
-events_struct_t g_events;
-static uint8_t g_tx_buf[UHF_SPI_BUFFER_LENGTH];
-static uint8_t g_rx_buf[UHF_SPI_BUFFER_LENGTH];
+/* Driver instances, one per transceiver */
+static uhf_dev_t g_dev[UHF_SPI_INSTANCES_NUMBER];
+/* SCK rates tried by the speed negotiation, slowest first */
+static const uint32_t g_speed[] = UHF_SPI_SPEED_LIST;
+#define UHF_SPI_SPEED_COUNT (sizeof(g_speed) / sizeof(g_speed[0]))
+/* Telegram layout of each SPI command, indexed by command ID */
+static const uhf_spi_cmd_desc_t g_cmd_desc[] =
+{
+    /*                                          opcode                                 flags                                                        params dummy rx_offset rx_length */
+    [UHF_SPI_CMD_READ_FILL_LEVEL_RX_FIFO]   = { UHF_SPI_CMD_READ_FILL_LEVEL_RX_FIFO,   0,                                                            0,      2,     2,         1 },
+    [UHF_SPI_CMD_READ_FILL_LEVEL_TX_FIFO]   = { UHF_SPI_CMD_READ_FILL_LEVEL_TX_FIFO,   0,                                                            0,      2,     2,         1 },
+    [UHF_SPI_CMD_READ_FILL_LEVEL_RSSI_FIFO] = { UHF_SPI_CMD_READ_FILL_LEVEL_RSSI_FIFO, 0,                                                            0,      2,     2,         1 },
+    [UHF_SPI_CMD_GET_EVENT_BYTES]           = { UHF_SPI_CMD_GET_EVENT_BYTES,           UHF_SPI_DESC_NO_EVENTS,                                       0,      3,     0,         4 },
+    [UHF_SPI_CMD_READ_RSSI_FIFO]            = { UHF_SPI_CMD_READ_RSSI_FIFO,            UHF_SPI_DESC_LENGTH | UHF_SPI_DESC_READ,                      0,      1,     0,         0 },
+    [UHF_SPI_CMD_READ_RX_FIFO]              = { UHF_SPI_CMD_READ_RX_FIFO,              UHF_SPI_DESC_LENGTH | UHF_SPI_DESC_READ,                      0,      1,     0,         0 },
+    [UHF_SPI_CMD_WRITE_SRAM]                = { UHF_SPI_CMD_WRITE_SRAM,                UHF_SPI_DESC_LENGTH | UHF_SPI_DESC_ADDR | UHF_SPI_DESC_WRITE, 0,      0,     0,         0 },
+    [UHF_SPI_CMD_READ_SRAM]                 = { UHF_SPI_CMD_READ_SRAM,                 UHF_SPI_DESC_LENGTH | UHF_SPI_DESC_ADDR | UHF_SPI_DESC_READ,  0,      1,     0,         0 },
+    [UHF_SPI_CMD_WRITE_EEPROM]              = { UHF_SPI_CMD_WRITE_EEPROM,              UHF_SPI_DESC_ADDR,                                            1,      0,     0,         0 },
+    [UHF_SPI_CMD_READ_EEPROM]               = { UHF_SPI_CMD_READ_EEPROM,               UHF_SPI_DESC_ADDR,                                            0,      2,     4,         1 },
+    [UHF_SPI_CMD_WRITE_TX_FIFO]             = { UHF_SPI_CMD_WRITE_TX_FIFO,             UHF_SPI_DESC_LENGTH | UHF_SPI_DESC_WRITE,                     0,      0,     0,         0 },
+    [UHF_SPI_CMD_WRITE_TX_PREAMBLE_FIFO]    = { UHF_SPI_CMD_WRITE_TX_PREAMBLE_FIFO,    UHF_SPI_DESC_LENGTH | UHF_SPI_DESC_WRITE,                     0,      0,     0,         0 },
+    [UHF_SPI_CMD_SET_SYSTEM_MODE]           = { UHF_SPI_CMD_SET_SYSTEM_MODE,           0,                                                            2,      0,     0,         0 },
+    [UHF_SPI_CMD_CALIBRATE_AND_CHECK]       = { UHF_SPI_CMD_CALIBRATE_AND_CHECK,       0,                                                            2,      0,     0,         0 },
+    [UHF_SPI_CMD_PATCH_SPI]                 = { UHF_SPI_CMD_PATCH_SPI,                 0,                                                            1,      0,     0,         0 },
+    [UHF_SPI_CMD_SYSTEM_RESET_ROM]          = { UHF_SPI_CMD_SYSTEM_RESET_ROM,          UHF_SPI_DESC_NO_EVENTS,                                       1,      0,     0,         0 },
+    [UHF_SPI_CMD_GET_VERSION_ROM]           = { UHF_SPI_CMD_GET_VERSION_ROM,           0,                                                            0,      2,     2,         1 },
+    [UHF_SPI_CMD_GET_VERSION_FLASH]         = { UHF_SPI_CMD_GET_VERSION_FLASH,         0,                                                            0,      5,     2,         4 },
+    [UHF_SPI_CMD_CUST_CONF]                 = { UHF_SPI_CMD_CUST_CONF,                 0,                                                            1,      0,     0,         0 },
+    [UHF_SPI_CMD_SYSTEM_RESET]              = { UHF_SPI_CMD_SYSTEM_RESET,              UHF_SPI_DESC_NO_EVENTS,                                       1,      0,     0,         0 },
+    [UHF_SPI_CMD_TRIG_EEPROM_SECURE_WRITE]  = { UHF_SPI_CMD_TRIG_EEPROM_SECURE_WRITE,  UHF_SPI_DESC_KEY,                                             0,      0,     0,         0 },
+    [UHF_SPI_CMD_SET_VOLTAGE_MONITOR]       = { UHF_SPI_CMD_SET_VOLTAGE_MONITOR,       0,                                                            1,      0,     0,         0 },
+    [UHF_SPI_CMD_OFF]                       = { UHF_SPI_CMD_OFF,                       UHF_SPI_DESC_NO_EVENTS,                                       1,      0,     0,         0 },
+    [UHF_SPI_CMD_READ_TEMP_VALUE]           = { UHF_SPI_CMD_READ_TEMP_VALUE,           0,                                                            0,      3,     2,         2 },
+    [UHF_SPI_CMD_INIT_SRAM_SERVICE]         = { UHF_SPI_CMD_INIT_SRAM_SERVICE,         0,                                                            2,      0,     0,         0 },
+    [UHF_SPI_CMD_START_RSSI_MEAS]           = { UHF_SPI_CMD_START_RSSI_MEAS,           0,                                                            1,      0,     0,         0 },
+    [UHF_SPI_CMD_GET_RSSI_VALUE]            = { UHF_SPI_CMD_GET_RSSI_VALUE,            0,                                                            0,      3,     2,         2 },
+    [UHF_SPI_CMD_READ_RX_BUFFER_BYTE_INT]   = { UHF_SPI_CMD_READ_RX_BUFFER_BYTE_INT,   UHF_SPI_DESC_STEP,                                            0,      2,     2,         0 },
+    [UHF_SPI_CMD_READ_RSSI_BUFFER_BYTE_INT] = { UHF_SPI_CMD_READ_RSSI_BUFFER_BYTE_INT, UHF_SPI_DESC_STEP,                                            0,      2,     2,         0 },
+};
+#define UHF_SPI_CMD_DESC_COUNT (sizeof(g_cmd_desc) / sizeof(g_cmd_desc[0]))
+/* Trigger sequence of "Trigger EEPROM Secure Write" */
+static const uint8_t g_secure_write_key[] = { 0xAA, 0xCC, 0xF0 };
+/* Constant source of the dummy bytes clocked out while a payload is read */
+static const uint8_t g_zero[UHF_SPI_BUFFER_LENGTH] = { 0 };
 
 // *****************************************************************************
 // *****************************************************************************
@@ -69,672 +110,2784 @@ static uint8_t g_rx_buf[UHF_SPI_BUFFER_LENGTH];
 // *****************************************************************************
 // *****************************************************************************
 
-// *****************************************************************************
-// *****************************************************************************
-// Section: SPI_ATA8510 Global Functions
-// *****************************************************************************
-// *****************************************************************************
+#if (UHF_SPI_DMA_ENABLE == 1)
+static void uhf_spi_dma_rx_callback(DMAC_TRANSFER_EVENT event, uintptr_t context)
+{
+    uhf_dev_t *dev = (uhf_dev_t *)context;
+
+    /* RX channel finishes last, so the whole telegram has been clocked */
+    dev->transfer_done = true;
+}
+#endif
+
+#if (UHF_SPI_DMA_ENABLE == 1)
+static void uhf_spi_dma_segment(dmac_descriptor_registers_t *desc, uint16_t ctrl, const void *src, void *dst,
+                                size_t length, dmac_descriptor_registers_t *next)
+{
+    uint32_t srcAddr = (uint32_t)src;
+    uint32_t dstAddr = (uint32_t)dst;
+
+    /* Incrementing addresses point to the end of the block */
+    if ((ctrl & DMAC_BTCTRL_SRCINC_Msk) != 0U)
+    {
+        srcAddr += length;
+    }
+    if ((ctrl & DMAC_BTCTRL_DSTINC_Msk) != 0U)
+    {
+        dstAddr += length;
+    }
+
+    desc->DMAC_BTCTRL = (uint16_t)(ctrl | DMAC_BTCTRL_BEATSIZE_BYTE | DMAC_BTCTRL_VALID_Msk |
+                        ((next == NULL) ? DMAC_BTCTRL_BLOCKACT_INT : DMAC_BTCTRL_BLOCKACT_NOACT));
+    desc->DMAC_BTCNT = (uint16_t)length;
+    desc->DMAC_SRCADDR = srcAddr;
+    desc->DMAC_DSTADDR = dstAddr;
+    desc->DMAC_DESCADDR = (uint32_t)next;
+}
+#endif
+
+/* Clock the header from tx_buf into rx_buf, then the payload (if any)
+   straight from / into the caller buffer within the same telegram */
+static void uhf_spi_transfer_start(uhf_dev_t *dev, size_t length)
+{
+    dev->transfer_done = false;
+
+#if (UHF_SPI_DMA_ENABLE == 1)
+    if (dev->payload_length == 0U)
+    {
+        uhf_spi_dma_segment(&dev->tx_desc[0], DMAC_BTCTRL_SRCINC_Msk, dev->tx_buf, dev->init->dma_data_address, length, NULL);
+        uhf_spi_dma_segment(&dev->rx_desc[0], DMAC_BTCTRL_DSTINC_Msk, dev->init->dma_data_address, dev->rx_buf, length, NULL);
+    }
+    else
+    {
+        uhf_spi_dma_segment(&dev->tx_desc[0], DMAC_BTCTRL_SRCINC_Msk, dev->tx_buf, dev->init->dma_data_address, length, &dev->tx_desc[1]);
+        uhf_spi_dma_segment(&dev->rx_desc[0], DMAC_BTCTRL_DSTINC_Msk, dev->init->dma_data_address, dev->rx_buf, length, &dev->rx_desc[1]);
+        if (dev->payload_read == true)
+        {
+            /* Dummy bytes from a fixed zero, data straight to the caller */
+            uhf_spi_dma_segment(&dev->tx_desc[1], 0U, g_zero, dev->init->dma_data_address, dev->payload_length, NULL);
+            uhf_spi_dma_segment(&dev->rx_desc[1], DMAC_BTCTRL_DSTINC_Msk, dev->init->dma_data_address, dev->payload, dev->payload_length, NULL);
+        }
+        else
+        {
+            /* Data straight from the caller, received bytes discarded */
+            uhf_spi_dma_segment(&dev->tx_desc[1], DMAC_BTCTRL_SRCINC_Msk, dev->payload, dev->init->dma_data_address, dev->payload_length, NULL);
+            uhf_spi_dma_segment(&dev->rx_desc[1], 0U, dev->init->dma_data_address, &dev->rx_discard, dev->payload_length, NULL);
+        }
+    }
+
+    /* Arm RX first so that no received byte is missed once TX starts */
+    (void)DMAC_ChannelLinkedListTransfer(dev->init->dma_channel_rx, &dev->rx_desc[0]);
+    (void)DMAC_ChannelLinkedListTransfer(dev->init->dma_channel_tx, &dev->tx_desc[0]);
+#else
+    dev->init->spi_write_read(dev->tx_buf, length, dev->rx_buf, length);
+    if (dev->payload_read == true)
+    {
+        size_t offset = 0;
+        size_t chunk;
+
+        while (offset < dev->payload_length)
+        {
+            chunk = dev->payload_length - offset;
+            if (chunk > sizeof(g_zero))
+            {
+                chunk = sizeof(g_zero);
+            }
+            dev->init->spi_write_read((void *)g_zero, chunk, &dev->payload[offset], chunk);
+            offset += chunk;
+        }
+    }
+    else if (dev->payload_length != 0U)
+    {
+        dev->init->spi_write_read(dev->payload, dev->payload_length, NULL, 0);
+    }
+    else
+    {
+        /* Header only */
+    }
+    dev->transfer_done = true;
+#endif
+}
+
+#if (UHF_SPI_GUARD_TIMER_ENABLE == 1)
+static void uhf_spi_guard_timer_callback(TC_TIMER_STATUS status, uintptr_t context)
+{
+    uhf_dev_t *dev = (uhf_dev_t *)context;
+
+    /* One-shot has reached its period and stopped */
+    dev->timer_expired = true;
+}
+#endif
+
+static uint32_t uhf_spi_us_to_count(uhf_dev_t *dev, uint32_t us)
+{
+#if (UHF_SPI_GUARD_TIMER_ENABLE == 1)
+    return (dev->init->timer_frequency_get() / 1000000U) * us;
+#else
+    return SYS_TIME_USToCount(us);
+#endif
+}
+
+static void uhf_spi_timer_start(uhf_dev_t *dev, uint32_t count)
+{
+#if (UHF_SPI_GUARD_TIMER_ENABLE == 1)
+    dev->timer_expired = false;
+    /* The one-shot overflows after period + 1 counts */
+    dev->init->timer_period_set((uint16_t)(count - 1U));
+    dev->init->timer_command(TC_COMMAND_START_RETRIGGER);
+#else
+    dev->timer_start = SYS_TIME_CounterGet();
+    dev->timer_count = count;
+#endif
+}
+
+static bool uhf_spi_timer_expired(uhf_dev_t *dev)
+{
+#if (UHF_SPI_GUARD_TIMER_ENABLE == 1)
+    return dev->timer_expired;
+#else
+    return ((SYS_TIME_CounterGet() - dev->timer_start) >= dev->timer_count);
+#endif
+}
+
+/* True while the command in progress waits for an interrupt to move on */
+static bool uhf_spi_wait_interrupt(uhf_dev_t *dev)
+{
+    bool wait = false;
+
+    switch (dev->state)
+    {
+#if (UHF_SPI_DMA_ENABLE == 1)
+        case UHF_SPI_STATE_TRANSFER:
+            wait = (dev->transfer_done == false);
+            break;
+#endif
+#if (UHF_SPI_GUARD_TIMER_ENABLE == 1)
+        case UHF_SPI_STATE_CS_SETUP:
+        case UHF_SPI_STATE_CS_HOLD:
+        case UHF_SPI_STATE_CS_IDLE:
+            wait = (dev->timer_expired == false);
+            break;
+
+        case UHF_SPI_STATE_IDLE:
+            /* EEPROM job between two status polls, RSSI survey between two
+               IRQ line checks */
+            wait = (dev->eeprom_job.poll_armed == true) && (dev->timer_expired == false);
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+            wait = wait || ((dev->survey.poll_armed == true) && (dev->timer_expired == false));
+#endif
+            break;
+#endif
+        default:
+            break;
+    }
+
+    return wait;
+}
+
+/* True if WFI does not stall the instance: idle, or waiting for an interrupt */
+static bool uhf_spi_idle_or_waiting(uhf_dev_t *dev)
+{
+    bool busy;
+
+    busy = (dev->queue_count != 0U) || (dev->eeprom_job.state != UHF_SPI_EEPROM_JOB_IDLE);
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+    busy = busy || (dev->survey.state != UHF_SPI_SURVEY_IDLE);
+#endif
+
+    return (busy == false) || (uhf_spi_wait_interrupt(dev) == true);
+}
+
+#if (UHF_SPI_IRQ_EIC_ENABLE == 1)
+/* EIC interrupt, falling edge of the IRQ line */
+static void uhf_spi_irq_edge_callback(uintptr_t context)
+{
+    uhf_dev_t *dev = (uhf_dev_t *)context;
+
+    dev->irq_stamp = SYS_TIME_CounterGet();
+    dev->irq_pending = true;
+}
+#endif
+
+#if (UHF_SPI_STATS_ENABLE == 1)
+/* Charge the time since the last mark to the command in progress */
+static void uhf_spi_stats_mark(uhf_dev_t *dev)
+{
+    uint32_t now = SYS_TIME_CounterGet();
+
+    dev->stat_busy += now - dev->stat_mark;
+    dev->stat_mark = now;
+}
+
+static void uhf_spi_stats_update(uhf_dev_t *dev)
+{
+    uint32_t wall;
+
+    uhf_spi_stats_mark(dev);
+    wall = dev->stat_mark - dev->stat_start;
+
+    dev->stat_commands++;
+    dev->stat_wall_last = wall;
+    dev->stat_busy_last = dev->stat_busy;
+    dev->stat_wall_total += wall;
+    dev->stat_busy_total += dev->stat_busy;
+    if (wall > dev->stat_wall_max)
+    {
+        dev->stat_wall_max = wall;
+    }
+    if (dev->stat_busy > dev->stat_busy_max)
+    {
+        dev->stat_busy_max = dev->stat_busy;
+    }
+}
+#endif
+
+#if (UHF_SPI_TRACE_ENABLE == 1)
+/* Kept to a counter read and a few stores, it runs for every telegram */
+static inline void uhf_spi_trace_record(uhf_dev_t *dev, const uhf_spi_cmd_t *cmd)
+{
+    uhf_spi_trace_t *rec = &dev->trace[dev->trace_count & (UHF_SPI_TRACE_LENGTH - 1U)];
+
+    rec->end = dev->init->trace_counter_get();
+    rec->start = dev->trace_start;
+    rec->length = (uint16_t)dev->size + dev->payload_length;
+    rec->opcode = dev->tx_buf[0];
+    rec->system = cmd->events.system;
+    rec->trx = cmd->events.trx;
+    dev->trace_count++;
+}
+#endif
+
+/* Switch SCK to an entry of the speed table, only while no telegram runs */
+static void uhf_spi_speed_set(uhf_dev_t *dev, uint8_t index)
+{
+    SPI_TRANSFER_SETUP setup;
+
+    setup.clockFrequency = g_speed[index];
+    setup.clockPhase = SPI_CLOCK_PHASE_LEADING_EDGE;
+    setup.clockPolarity = SPI_CLOCK_POLARITY_IDLE_LOW;
+    setup.dataBits = SPI_DATA_BITS_8;
+
+    (void)dev->init->spi_setup(&setup, 0);
+    dev->speed_index = index;
+}
+
+/* Status bytes clocked at a rate the transceiver cannot follow read as all
+   ones or make it flag an SPI error. After a few in a row, step down. */
+static void uhf_spi_speed_check(uhf_dev_t *dev, const uhf_spi_cmd_t *cmd)
+{
+    if ((dev->speed_probe == true) || (dev->speed_index == 0U))
+    {
+        return;
+    }
+
+    switch (cmd->id)
+    {
+        case UHF_SPI_CMD_SYSTEM_RESET_ROM:
+        case UHF_SPI_CMD_SYSTEM_RESET:
+        case UHF_SPI_CMD_OFF:
+            /* Status of a restarting device says nothing about the bus */
+            return;
+
+        default:
+            break;
+    }
+
+    if (((cmd->events.system & UHF_SPI_EVENT_SYS_ERR) != 0U) ||
+        ((cmd->events.system == 0xFFU) && (cmd->events.trx == 0xFFU)))
+    {
+        dev->speed_errors++;
+        if (dev->speed_errors >= UHF_SPI_SPEED_ERROR_LIMIT)
+        {
+            uhf_spi_speed_set(dev, dev->speed_index - 1U);
+            dev->speed_errors = 0;
+            dev->speed_fallbacks++;
+        }
+    }
+    else
+    {
+        dev->speed_errors = 0;
+    }
+}
+
+/* Known-answer test at the current SCK rate */
+static bool uhf_spi_speed_test(uhf_dev_t *dev, uint8_t version)
+{
+    uint8_t pattern[UHF_SPI_SPEED_SCRATCH_LENGTH];
+    uint8_t readback[UHF_SPI_SPEED_SCRATCH_LENGTH];
+    uint8_t i;
+
+    for (i = 0; i < UHF_SPI_SPEED_CHECKS; i++)
+    {
+        if (uhf_spi_get_version_ROM(dev) != version)
+        {
+            return false;
+        }
+
+        /* Alternating and walking bits, different on every pass */
+        pattern[0] = 0x55U ^ i;
+        pattern[1] = 0xAAU ^ i;
+        pattern[2] = (uint8_t)(0x01U << (i & 0x07U));
+        pattern[3] = (uint8_t)~pattern[2];
+        memset(readback, 0, sizeof(readback));
+
+        uhf_spi_write_sram_reg(dev, UHF_SPI_SPEED_SCRATCH_ADDR, pattern, sizeof(pattern));
+        uhf_spi_read_sram_reg(dev, UHF_SPI_SPEED_SCRATCH_ADDR, readback, sizeof(readback));
+
+        if ((memcmp(pattern, readback, sizeof(pattern)) != 0) ||
+            ((dev->events.system & UHF_SPI_EVENT_SYS_ERR) != 0U))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Build the telegram of a command into tx_buf from its descriptor and note
+   where its result is found in rx_buf. Header layout: opcode, [length],
+   [address high, low], [parameters], [trigger key], [step bytes], dummy
+   bytes. Returns the telegram size, 0 if nothing is to be sent (unknown
+   command or payload of length 0). */
+static uint8_t uhf_spi_frame_build(uhf_dev_t *dev, uhf_spi_cmd_t *cmd)
+{
+    const uhf_spi_cmd_desc_t *desc;
+    uint8_t length = cmd->length;
+    uint8_t size = 0;
+
+    dev->rx_offset = 0;
+    dev->rx_length = 0;
+    dev->payload = cmd->data;
+    dev->payload_length = 0;
+    dev->payload_read = false;
+    dev->events_update = true;
+
+    if ((cmd->id >= UHF_SPI_CMD_DESC_COUNT) || (g_cmd_desc[cmd->id].opcode != cmd->id))
+    {
+        /* Unknown command */
+        return 0;
+    }
+    desc = &g_cmd_desc[cmd->id];
+
+    if (cmd->data == NULL)
+    {
+        /* No buffer to read into or write from */
+        length = 0;
+    }
+    else if (cmd->length_ref != NULL)
+    {
+        /* Length produced by an earlier command, limited to the buffer */
+        if (*cmd->length_ref < length)
+        {
+            length = *cmd->length_ref;
+        }
+        *cmd->length_ref = length;
+    }
+    else
+    {
+        /* Length given by the caller */
+    }
+
+    if ((desc->flags & (UHF_SPI_DESC_READ | UHF_SPI_DESC_WRITE)) != 0U)
+    {
+        if (length == 0U)
+        {
+            /* The telegram would not move any data */
+            cmd->length = 0;
+            return 0;
+        }
+        dev->payload_length = length;
+        dev->payload_read = ((desc->flags & UHF_SPI_DESC_READ) != 0U);
+    }
+
+    dev->tx_buf[size++] = desc->opcode;
+    if ((desc->flags & UHF_SPI_DESC_LENGTH) != 0U)
+    {
+        dev->tx_buf[size++] = length;
+    }
+    if ((desc->flags & UHF_SPI_DESC_ADDR) != 0U)
+    {
+        dev->tx_buf[size++] = (cmd->addr >> 0x08) & 0xFF;
+        dev->tx_buf[size++] = (cmd->addr & 0xFF);
+    }
+    if (desc->params != 0U)
+    {
+        memcpy(&dev->tx_buf[size], cmd->param, desc->params);
+        size += desc->params;
+    }
+    if ((desc->flags & UHF_SPI_DESC_KEY) != 0U)
+    {
+        memcpy(&dev->tx_buf[size], g_secure_write_key, sizeof(g_secure_write_key));
+        size += sizeof(g_secure_write_key);
+    }
+    if ((desc->flags & UHF_SPI_DESC_STEP) != 0U)
+    {
+        /* One byte per data byte, step 0x01 continues reading, the first
+           dummy byte ends it */
+        if ((length == 0U) && (cmd->length_ref != NULL))
+        {
+            /* Empty FIFO */
+            cmd->length = 0;
+            return 0;
+        }
+        if ((size + length - 1U + desc->dummy) > UHF_SPI_BUFFER_LENGTH)
+        {
+            length = UHF_SPI_BUFFER_LENGTH + 1U - size - desc->dummy;
+        }
+        if (length == 0U)
+        {
+            length = 1;
+        }
+        if (cmd->length_ref != NULL)
+        {
+            *cmd->length_ref = length;
+        }
+        memset(&dev->tx_buf[size], 0x01, length - 1U);
+        size += length - 1U;
+        dev->rx_length = length;
+    }
+    else
+    {
+        dev->rx_length = desc->rx_length;
+    }
+    memset(&dev->tx_buf[size], 0x00, desc->dummy);
+    size += desc->dummy;
+
+    dev->rx_offset = desc->rx_offset;
+    dev->events_update = ((desc->flags & UHF_SPI_DESC_NO_EVENTS) == 0U);
+
+    cmd->length = length;
+
+    return size;
+}
+
+#if (UHF_SPI_WAKE_TRACKING_ENABLE == 1)
+/* Follow the transceiver operating mode. The AVR only stays active in TX and
+   RX mode; IDLE and OFF let it sleep and polling mode duty-cycles it until a
+   telegram is found. Anything unexpected falls back to "asleep". */
+static void uhf_spi_wake_update(uhf_dev_t *dev, const uhf_spi_cmd_t *cmd)
+{
+    switch (cmd->id)
+    {
+        case UHF_SPI_CMD_SET_SYSTEM_MODE:
+            dev->opm = cmd->param[0] & UHF_SPI_OPM_MASK;
+            break;
+
+        case UHF_SPI_CMD_OFF:
+        case UHF_SPI_CMD_SYSTEM_RESET:
+        case UHF_SPI_CMD_SYSTEM_RESET_ROM:
+            dev->opm = UHF_SPI_OPM_IDLE;
+            break;
+
+        default:
+            break;
+    }
+
+    if ((cmd->events.system & (UHF_SPI_EVENT_SYS_ERR | UHF_SPI_EVENT_SYS_RDY)) != 0U)
+    {
+        /* Error or fresh start-up: device is back in IDLE */
+        dev->opm = UHF_SPI_OPM_IDLE;
+    }
+    else if ((dev->opm == UHF_SPI_OPM_POLLING) &&
+             ((cmd->events.trx & (UHF_SPI_EVENT_WCOKA | UHF_SPI_EVENT_SOTA | UHF_SPI_EVENT_WCOKB | UHF_SPI_EVENT_SOTB)) != 0U))
+    {
+        /* Polling found a telegram and stays in RX until set to IDLE */
+        dev->opm = UHF_SPI_OPM_RX;
+    }
+    else if ((dev->opm == UHF_SPI_OPM_TX) &&
+             ((cmd->events.trx & (UHF_SPI_EVENT_EOTA | UHF_SPI_EVENT_EOTB)) != 0U))
+    {
+        /* Telegram sent, device returns to IDLE */
+        dev->opm = UHF_SPI_OPM_IDLE;
+    }
+    else
+    {
+        /* No change */
+    }
+
+    dev->awake = ((dev->opm == UHF_SPI_OPM_TX) || (dev->opm == UHF_SPI_OPM_RX));
+}
+#endif
+
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+/* Fletcher-16 step */
+static void uhf_spi_shadow_sum(uhf_spi_shadow_t *shadow, uint8_t value)
+{
+    shadow->sum1 = (shadow->sum1 + value) % 255U;
+    shadow->sum2 = (shadow->sum2 + shadow->sum1) % 255U;
+}
+
+static uint16_t uhf_spi_shadow_checksum(uhf_spi_shadow_t *shadow)
+{
+    uint16_t i;
+
+    shadow->sum1 = 0;
+    shadow->sum2 = 0;
+    for (i = 0; i < shadow->used; i++)
+    {
+        uhf_spi_shadow_sum(shadow, shadow->data[i]);
+    }
+
+    return (uint16_t)((shadow->sum2 << 8) | shadow->sum1);
+}
+
+/* Shadow copy of the EEPROM byte at addr, NULL if not held */
+static uint8_t *uhf_spi_shadow_find(uhf_spi_shadow_t *shadow, uint16_t addr)
+{
+    const uhf_spi_shadow_range_t *range;
+    uint8_t i;
+
+    for (i = 0; i < shadow->count; i++)
+    {
+        range = &shadow->range[i];
+        if ((addr >= range->addr) && ((uint16_t)(addr - range->addr) < range->length))
+        {
+            return &shadow->data[range->offset + (addr - range->addr)];
+        }
+    }
+
+    return NULL;
+}
+
+/* Bytes the driver has programmed itself */
+static void uhf_spi_shadow_store(uhf_dev_t *dev, uint16_t addr, const uint8_t *data, uint16_t length)
+{
+    uhf_spi_shadow_t *shadow = &dev->shadow;
+    bool held = false;
+    uint8_t *copy;
+    uint16_t i;
+
+    if (shadow->valid == false)
+    {
+        return;
+    }
+    for (i = 0; i < length; i++)
+    {
+        copy = uhf_spi_shadow_find(shadow, addr + i);
+        if (copy != NULL)
+        {
+            *copy = data[i];
+            held = true;
+        }
+    }
+    if (held == true)
+    {
+        shadow->checksum = uhf_spi_shadow_checksum(shadow);
+    }
+}
+#endif
+
+static void uhf_spi_eeprom_job_finish(uhf_dev_t *dev, uhf_spi_eeprom_status_t status)
+{
+    uhf_spi_eeprom_job_t *job = &dev->eeprom_job;
+
+    job->state = UHF_SPI_EEPROM_JOB_IDLE;
+    job->status = status;
+    job->poll_armed = false;
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+    if (status == UHF_SPI_EEPROM_ERROR)
+    {
+        /* The failed chunk may or may not have been programmed */
+        dev->shadow.valid = false;
+    }
+#endif
+    if (job->callback != NULL)
+    {
+        job->callback(status, job->written, job->context);
+    }
+}
+
+/* Next chunk from job->offset on: the whole rest in plain mode, a read-back
+   first in differential mode */
+static void uhf_spi_eeprom_job_next(uhf_dev_t *dev)
+{
+    uhf_spi_eeprom_job_t *job = &dev->eeprom_job;
+
+    if (job->offset >= job->length)
+    {
+        uhf_spi_eeprom_job_finish(dev, UHF_SPI_EEPROM_DONE);
+    }
+    else if (job->diff == true)
+    {
+        job->state = UHF_SPI_EEPROM_JOB_COMPARE;
+    }
+    else
+    {
+        job->chunk = UHF_SPI_EEPROM_CHUNK_LENGTH;
+        if ((job->length - job->offset) < UHF_SPI_EEPROM_CHUNK_LENGTH)
+        {
+            job->chunk = (uint8_t)(job->length - job->offset);
+        }
+        job->state = UHF_SPI_EEPROM_JOB_STAGE;
+    }
+}
+
+/* Status bytes of a command completed while a chunk is programmed */
+static void uhf_spi_eeprom_job_events(uhf_dev_t *dev, uint8_t system)
+{
+    uhf_spi_eeprom_job_t *job = &dev->eeprom_job;
+
+    if ((system & UHF_SPI_EVENT_SYS_ERR) != 0U)
+    {
+        uhf_spi_eeprom_job_finish(dev, UHF_SPI_EEPROM_ERROR);
+    }
+    else if ((system & UHF_SPI_EVENT_CMD_RDY) != 0U)
+    {
+        job->program_time += SYS_TIME_CounterGet() - job->chunk_start;
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+        uhf_spi_shadow_store(dev, job->addr + job->offset, &job->data[job->offset], job->chunk);
+#endif
+        job->written += job->chunk;
+        job->offset += job->chunk;
+        job->chunk = 0;
+        uhf_spi_eeprom_job_next(dev);
+    }
+    else
+    {
+        /* Still programming */
+    }
+}
+
+/* Differential mode: the read-back window at job->offset is complete. Leading
+   unchanged bytes are skipped; a changed byte starts a chunk that takes in
+   further changed bytes of the window as long as the unchanged gap before
+   them is at most UHF_SPI_EEPROM_MERGE_GAP. */
+static void uhf_spi_eeprom_job_plan(uhf_dev_t *dev)
+{
+    uhf_spi_eeprom_job_t *job = &dev->eeprom_job;
+    const uint8_t *data = &job->data[job->offset];
+    uint8_t first = 0;
+    uint8_t last;
+    uint8_t i;
+
+    while ((first < job->current_count) && (job->current[first] == data[first]))
+    {
+        first++;
+    }
+    if (first != 0U)
+    {
+        job->skipped += first;
+        job->offset += first;
+        job->current_count -= first;
+        memmove(&job->current[0], &job->current[first], job->current_count);
+        uhf_spi_eeprom_job_next(dev);
+        return;
+    }
+
+    last = 0;
+    for (i = 1; i < job->current_count; i++)
+    {
+        if (job->current[i] != data[i])
+        {
+            if ((i - last - 1U) > UHF_SPI_EEPROM_MERGE_GAP)
+            {
+                break;
+            }
+            last = i;
+        }
+    }
+    job->chunk = last + 1U;
+    /* Known unchanged bytes behind the chunk stay for the next window */
+    job->current_count -= job->chunk;
+    memmove(&job->current[0], &job->current[job->chunk], job->current_count);
+    job->state = UHF_SPI_EEPROM_JOB_STAGE;
+}
+
+static void uhf_spi_eeprom_read_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_spi_eeprom_job_t *job = &((uhf_dev_t *)context)->eeprom_job;
+
+    job->current_count++;
+    job->reads_pending--;
+    if (job->reads_pending == 0U)
+    {
+        job->compare_time += SYS_TIME_CounterGet() - job->compare_start;
+    }
+}
+
+/* Differential mode: read back the current content of the next window */
+static void uhf_spi_eeprom_job_compare(uhf_dev_t *dev)
+{
+    uhf_spi_eeprom_job_t *job = &dev->eeprom_job;
+    uhf_spi_cmd_t cmd = { .id = UHF_SPI_CMD_READ_EEPROM, .length = 1, .callback = uhf_spi_eeprom_read_callback };
+    uint8_t window = UHF_SPI_EEPROM_CHUNK_LENGTH;
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+    const uint8_t *shadow;
+#endif
+    uint8_t i;
+
+    if (job->reads_pending != 0U)
+    {
+        return;
+    }
+    if ((job->length - job->offset) < UHF_SPI_EEPROM_CHUNK_LENGTH)
+    {
+        window = (uint8_t)(job->length - job->offset);
+    }
+    if (job->current_count >= window)
+    {
+        uhf_spi_eeprom_job_plan(dev);
+        return;
+    }
+
+    cmd.context = (uintptr_t)dev;
+    job->compare_start = SYS_TIME_CounterGet();
+    for (i = job->current_count; i < window; i++)
+    {
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+        /* Served from the shadow as long as no read is outstanding before it */
+        shadow = uhf_spi_shadow_find(&dev->shadow, job->addr + job->offset + i);
+        if ((dev->shadow.valid == true) && (shadow != NULL) && (job->reads_pending == 0U))
+        {
+            job->current[i] = *shadow;
+            job->current_count++;
+            continue;
+        }
+#endif
+        cmd.addr = job->addr + job->offset + i;
+        cmd.data = &job->current[i];
+        if (uhf_spi_submit(dev, &cmd) == false)
+        {
+            /* Queue full, the rest on a later pass */
+            break;
+        }
+        job->reads_pending++;
+    }
+}
+
+static void uhf_spi_eeprom_trigger_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_dev_t *dev = (uhf_dev_t *)context;
+    uhf_spi_eeprom_job_t *job = &dev->eeprom_job;
+
+    /* CMD_RDY is cleared from here on until the chunk is programmed */
+    job->state = UHF_SPI_EEPROM_JOB_PROGRAM;
+    job->chunk_start = SYS_TIME_CounterGet();
+    job->poll_armed = false;
+}
+
+static void uhf_spi_eeprom_poll_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    ((uhf_dev_t *)context)->eeprom_job.poll_queued = false;
+}
+
+static void uhf_spi_eeprom_sync_callback(uhf_spi_eeprom_status_t status, uint16_t written, uintptr_t context)
+{
+    *((volatile bool *)context) = true;
+}
+
+/* Queue the staging write and trigger of the chunk at job->offset */
+static void uhf_spi_eeprom_job_stage(uhf_dev_t *dev)
+{
+    uhf_spi_eeprom_job_t *job = &dev->eeprom_job;
+    uint16_t addr = job->addr + job->offset;
+    uhf_spi_cmd_t cmd = { .id = UHF_SPI_CMD_WRITE_SRAM, .addr = UHF_SPI_EEPROM_STAGE_ADDR, .data = job->stage };
+
+    if ((dev->queue_count + 2U) > UHF_SPI_QUEUE_LENGTH)
+    {
+        return;
+    }
+
+    job->stage[0] = (uint8_t)(addr >> 8);
+    job->stage[1] = (uint8_t)addr;
+    job->stage[2] = job->chunk;
+    memcpy(&job->stage[3], &job->data[job->offset], job->chunk);
+    job->chunk_timeout = SYS_TIME_USToCount(UHF_SPI_EEPROM_TIMEOUT_US * job->chunk);
+    job->chunks++;
+
+    /* Address, length and data are contiguous, one telegram stages them all */
+    cmd.length = 3U + job->chunk;
+    (void)uhf_spi_submit(dev, &cmd);
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.id = UHF_SPI_CMD_TRIG_EEPROM_SECURE_WRITE;
+    cmd.callback = uhf_spi_eeprom_trigger_callback;
+    cmd.context = (uintptr_t)dev;
+    (void)uhf_spi_submit(dev, &cmd);
+    job->state = UHF_SPI_EEPROM_JOB_TRIGGER;
+}
+
+static void uhf_spi_eeprom_job_tasks(uhf_dev_t *dev)
+{
+    uhf_spi_eeprom_job_t *job = &dev->eeprom_job;
+    uhf_spi_cmd_t cmd = { .id = UHF_SPI_CMD_READ_FILL_LEVEL_RX_FIFO, .callback = uhf_spi_eeprom_poll_callback };
+
+    switch (job->state)
+    {
+        case UHF_SPI_EEPROM_JOB_COMPARE:
+            uhf_spi_eeprom_job_compare(dev);
+            break;
+
+        case UHF_SPI_EEPROM_JOB_STAGE:
+            uhf_spi_eeprom_job_stage(dev);
+            break;
+
+        case UHF_SPI_EEPROM_JOB_PROGRAM:
+            /* Queued commands report the status bytes on their own */
+            if ((dev->queue_count != 0U) || (job->poll_queued == true))
+            {
+                break;
+            }
+            if ((SYS_TIME_CounterGet() - job->chunk_start) >= job->chunk_timeout)
+            {
+                uhf_spi_eeprom_job_finish(dev, UHF_SPI_EEPROM_ERROR);
+            }
+            else if (job->poll_armed == false)
+            {
+                /* The guard timer is free while the queue is idle */
+                uhf_spi_timer_start(dev, dev->count_poll);
+                job->poll_armed = true;
+            }
+            else if (uhf_spi_timer_expired(dev) == true)
+            {
+                job->poll_armed = false;
+                job->poll_queued = true;
+                cmd.context = (uintptr_t)dev;
+                (void)uhf_spi_submit(dev, &cmd);
+            }
+            else
+            {
+                /* Poll interval running */
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+static bool uhf_spi_eeprom_job_start(uhf_dev_t *dev, uint16_t addr, const uint8_t *data, uint16_t length, bool diff,
+                                     uhf_spi_eeprom_callback_t callback, uintptr_t context)
+{
+    uhf_spi_eeprom_job_t *job = &dev->eeprom_job;
+
+    if ((job->state != UHF_SPI_EEPROM_JOB_IDLE) || (length == 0U))
+    {
+        return false;
+    }
+
+    memset(job, 0, sizeof(uhf_spi_eeprom_job_t));
+    job->data = data;
+    job->addr = addr;
+    job->length = length;
+    job->diff = diff;
+    job->callback = callback;
+    job->context = context;
+    job->status = UHF_SPI_EEPROM_BUSY;
+    uhf_spi_eeprom_job_next(dev);
+    uhf_spi_eeprom_job_tasks(dev);
+
+    return true;
+}
+
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+/* Statistics of the channel whose samples are complete */
+static void uhf_spi_survey_channel_done(uhf_dev_t *dev)
+{
+    uhf_spi_survey_t *job = &dev->survey;
+    uhf_spi_rssi_channel_t *channel = &job->survey->channels[job->channel];
+    uint32_t sum = 0;
+    uint16_t rank;
+    uint8_t value;
+    uint8_t i;
+    uint8_t j;
+
+    /* Insertion sort, a few dozen samples at most */
+    for (i = 1; i < job->taken; i++)
+    {
+        value = job->samples[i];
+        for (j = i; (j > 0U) && (job->samples[j - 1U] > value); j--)
+        {
+            job->samples[j] = job->samples[j - 1U];
+        }
+        job->samples[j] = value;
+    }
+    for (i = 0; i < job->taken; i++)
+    {
+        sum += job->samples[i];
+    }
+    rank = (uint16_t)((((uint16_t)job->survey->percentile * job->taken) + 99U) / 100U);
+
+    channel->min = job->samples[0];
+    channel->max = job->samples[job->taken - 1U];
+    channel->percentile = job->samples[rank - 1U];
+    channel->mean = (uint16_t)(((sum << 8) + (job->taken / 2U)) / job->taken);
+    channel->samples = job->taken;
+    job->taken = 0;
+    job->channel++;
+}
+
+static void uhf_spi_survey_start_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_spi_survey_t *job = &((uhf_dev_t *)context)->survey;
+
+    job->meas_start = SYS_TIME_CounterGet();
+    job->ready = false;
+    job->poll_armed = false;
+    job->state = UHF_SPI_SURVEY_MEASURE;
+}
+
+/* Queue the measurement of the channel in progress, retried from
+   uhf_spi_tasks() while the queue is full */
+static void uhf_spi_survey_start(uhf_dev_t *dev)
+{
+    uhf_spi_survey_t *job = &dev->survey;
+    uhf_spi_cmd_t cmd = { .id = UHF_SPI_CMD_START_RSSI_MEAS, .callback = uhf_spi_survey_start_callback };
+
+    cmd.param[0] = job->survey->channels[job->channel].config;
+    cmd.context = (uintptr_t)dev;
+    job->state = (uhf_spi_submit(dev, &cmd) == true) ? UHF_SPI_SURVEY_QUEUED : UHF_SPI_SURVEY_START;
+}
+
+static void uhf_spi_survey_events_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_spi_survey_t *job = &((uhf_dev_t *)context)->survey;
+
+    /* The result may have come in right after it was read, the event read
+       clears CMD_RDY then and the IRQ line does not show it any more */
+    job->ready = ((job->events[0] & UHF_SPI_EVENT_CMD_RDY) != 0U);
+    job->poll_armed = false;
+    job->state = UHF_SPI_SURVEY_MEASURE;
+}
+
+static void uhf_spi_survey_value_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_dev_t *dev = (uhf_dev_t *)context;
+    uhf_spi_survey_t *job = &dev->survey;
+    uhf_spi_rssi_survey_t *survey = job->survey;
+    uhf_spi_rssi_channel_t *channel = &survey->channels[job->channel];
+    uhf_spi_cmd_t events = { .id = UHF_SPI_CMD_GET_EVENT_BYTES, .data = job->events,
+                             .callback = uhf_spi_survey_events_callback };
+
+    if (((cmd->events.system & UHF_SPI_EVENT_CMD_RDY) == 0U) && (job->ready == false))
+    {
+        /* IRQ of another event, release it and go on polling */
+        survey->polls++;
+        events.context = (uintptr_t)dev;
+        (void)uhf_spi_submit(dev, &events);
+        return;
+    }
+
+    job->samples[job->taken] = job->value[0];
+    job->taken++;
+    if (job->value[1] > channel->peak)
+    {
+        channel->peak = job->value[1];
+    }
+    if (job->taken >= survey->samples)
+    {
+        uhf_spi_survey_channel_done(dev);
+    }
+
+    if (job->channel < survey->count)
+    {
+        /* Right behind this command, no poll interval in between */
+        uhf_spi_survey_start(dev);
+    }
+    else
+    {
+        survey->duration_us = SYS_TIME_CountToUS(SYS_TIME_CounterGet() - job->start);
+        job->state = UHF_SPI_SURVEY_IDLE;
+        survey->done = true;
+    }
+}
+
+static void uhf_spi_survey_tasks(uhf_dev_t *dev)
+{
+    uhf_spi_survey_t *job = &dev->survey;
+    uhf_spi_cmd_t cmd = { .id = UHF_SPI_CMD_GET_RSSI_VALUE, .data = job->value, .callback = uhf_spi_survey_value_callback };
+
+    switch (job->state)
+    {
+        case UHF_SPI_SURVEY_START:
+            uhf_spi_survey_start(dev);
+            break;
+
+        case UHF_SPI_SURVEY_MEASURE:
+            /* The guard timer is free while the queue is idle */
+            if (dev->queue_count != 0U)
+            {
+                break;
+            }
+            if ((SYS_TIME_CounterGet() - job->meas_start) >= job->meas_timeout)
+            {
+                job->survey->lost++;
+                job->poll_armed = false;
+                uhf_spi_survey_start(dev);
+            }
+            else if ((job->ready == true) || (uhf_irq_get(dev) == false))
+            {
+                /* IRQ line low, no SPI traffic needed to see it */
+                job->poll_armed = false;
+                cmd.context = (uintptr_t)dev;
+                (void)uhf_spi_submit(dev, &cmd);
+                job->state = UHF_SPI_SURVEY_QUEUED;
+            }
+            else if ((job->poll_armed == false) || (uhf_spi_timer_expired(dev) == true))
+            {
+                uhf_spi_timer_start(dev, dev->count_rssi_poll);
+                job->poll_armed = true;
+            }
+            else
+            {
+                /* Poll interval running */
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+#endif
+
+static void uhf_spi_complete(uhf_dev_t *dev)
+{
+    uhf_spi_cmd_t cmd = dev->queue[dev->queue_head];
+
+    if (dev->size != 0U)
+    {
+#if (UHF_SPI_STATS_ENABLE == 1)
+        uhf_spi_stats_update(dev);
+#endif
+        if (cmd.id == UHF_SPI_CMD_GET_EVENT_BYTES)
+        {
+            memcpy(&cmd.events, dev->rx_buf, 0x04);
+        }
+        else
+        {
+            cmd.events.system = dev->rx_buf[0];
+            cmd.events.trx = dev->rx_buf[1];
+        }
+#if (UHF_SPI_TRACE_ENABLE == 1)
+        uhf_spi_trace_record(dev, &cmd);
+#endif
+        if (dev->events_update == true)
+        {
+            dev->events.system = dev->rx_buf[0];
+            dev->events.trx = dev->rx_buf[1];
+        }
+        if (dev->eeprom_job.state == UHF_SPI_EEPROM_JOB_PROGRAM)
+        {
+            uhf_spi_eeprom_job_events(dev, cmd.events.system);
+        }
+        if ((cmd.data != NULL) && (dev->rx_length != 0U))
+        {
+            memcpy(cmd.data, &dev->rx_buf[dev->rx_offset], dev->rx_length);
+        }
+#if (UHF_SPI_WAKE_TRACKING_ENABLE == 1)
+        uhf_spi_wake_update(dev, &cmd);
+#endif
+        /* Between telegrams, the only safe place to change SCK */
+        uhf_spi_speed_check(dev, &cmd);
+    }
+
+    /* Release the slot before the callback so that it may queue follow-ups */
+    dev->queue_head = (dev->queue_head + 1U) % UHF_SPI_QUEUE_LENGTH;
+    dev->queue_count--;
+    dev->state = UHF_SPI_STATE_IDLE;
+
+    if (cmd.callback != NULL)
+    {
+        cmd.callback(&cmd, cmd.context);
+    }
+}
+
+static void uhf_spi_sync_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    *((volatile bool *)context) = true;
+}
+
+/* Run the queues of all instances until the command flagging done has
+   completed, so that other transceivers keep going meanwhile */
+static void uhf_spi_wait(volatile bool *done)
+{
+    uint8_t i;
+    bool sleep;
+
+    while (*done == false)
+    {
+        for (i = 0; i < UHF_SPI_INSTANCES_NUMBER; i++)
+        {
+            if (g_dev[i].init != NULL)
+            {
+                uhf_spi_tasks(&g_dev[i]);
+            }
+        }
+
+        /* Sleep until a DMAC or guard timer interrupt lets a command move
+           on. The check is done with interrupts masked so an interrupt right
+           before WFI is not lost. Once the command is done there is
+           nothing left to wait for. */
+        __disable_irq();
+        sleep = (*done == false);
+        for (i = 0; i < UHF_SPI_INSTANCES_NUMBER; i++)
+        {
+            if ((g_dev[i].init != NULL) && (uhf_spi_idle_or_waiting(&g_dev[i]) == false))
+            {
+                sleep = false;
+            }
+        }
+        if (sleep == true)
+        {
+            __WFI();
+        }
+        __enable_irq();
+    }
+}
+
+/* Run the instance until a running EEPROM programming job has finished. Its
+   queue can be empty while it waits between CMD_RDY polls, sleep as in
+   uhf_spi_wait() meanwhile. */
+static void uhf_spi_eeprom_job_wait(uhf_dev_t *dev)
+{
+    while (dev->eeprom_job.state != UHF_SPI_EEPROM_JOB_IDLE)
+    {
+        uhf_spi_tasks(dev);
+
+        __disable_irq();
+        if ((dev->eeprom_job.state != UHF_SPI_EEPROM_JOB_IDLE) && (uhf_spi_idle_or_waiting(dev) == true))
+        {
+            __WFI();
+        }
+        __enable_irq();
+    }
+}
+
+/* Start no further telegram on the instance and run the one in progress to
+   its end, so CS is released. Sleeps as in uhf_spi_wait() meanwhile. */
+static void uhf_spi_hold(uhf_dev_t *dev)
+{
+    dev->hold = true;
+    while (dev->state != UHF_SPI_STATE_IDLE)
+    {
+        uhf_spi_tasks(dev);
+
+        __disable_irq();
+        if ((dev->state != UHF_SPI_STATE_IDLE) && (uhf_spi_idle_or_waiting(dev) == true))
+        {
+            __WFI();
+        }
+        __enable_irq();
+    }
+}
+
+/* Queue a command behind any pending ones and run the queue until it is done */
+static void uhf_spi_run(uhf_dev_t *dev, uhf_spi_cmd_t *cmd)
+{
+    volatile bool done = false;
+
+    cmd->callback = uhf_spi_sync_callback;
+    cmd->context = (uintptr_t)&done;
+
+    while (uhf_spi_submit(dev, cmd) == false)
+    {
+        uhf_spi_tasks(dev);
+    }
+
+    uhf_spi_wait(&done);
+}
+
+/* Keep the status bytes of the first fill level command of a drain */
+static void uhf_spi_drain_events_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_spi_drain_t *drain = (uhf_spi_drain_t *)context;
+
+    drain->events = cmd->events;
+}
+
+/* Append fill level + FIFO read of one FIFO to cmd[], returns the count */
+static uint8_t uhf_spi_drain_build(uhf_spi_cmd_t *cmd, uint8_t fill_id, uint8_t read_id,
+                                   uint8_t *data, uint8_t size, uint8_t *length)
+{
+    if (data == NULL)
+    {
+        return 0;
+    }
+
+    *length = 0;
+
+    cmd[0].id = fill_id;
+    cmd[0].data = length;
+    cmd[1].id = read_id;
+    cmd[1].data = data;
+    cmd[1].length = size;
+    cmd[1].length_ref = length;
+
+    return 2;
+}
+
+/* Fill level of a stream read-out, the FIFO read takes at most this */
+static void uhf_spi_stream_fill_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_spi_stream_rx_t *stream = (uhf_spi_stream_rx_t *)context;
+
+    stream->fill_events = cmd->events;
+    if (stream->fill > stream->fill_max)
+    {
+        stream->fill_max = stream->fill;
+    }
+    if ((stream->fill >= UHF_SPI_DFIFO_SIZE) || (stream->fill > (stream->size - stream->length)))
+    {
+        stream->overrun = true;
+    }
+}
+
+static void uhf_spi_stream_read(uhf_dev_t *dev, uhf_spi_stream_rx_t *stream, uint8_t space);
+
+/* Event bytes of a stream read-out: wait for the next IRQ, read on or done.
+   Reading the event bytes clears a fill level event or EOT that came up
+   during the read-out, so these are followed up here. */
+static void uhf_spi_stream_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_spi_stream_rx_t *stream = (uhf_spi_stream_rx_t *)context;
+    uhf_dev_t *dev = stream->dev;
+    uint16_t space;
+    bool more;
+
+    stream->length += stream->fill;
+    stream->reads++;
+    space = stream->size - stream->length;
+    if ((stream->events[1] & UHF_SPI_EVENT_EOTA) != 0U)
+    {
+        stream->eot = true;
+    }
+
+    if ((stream->tail == true) || (((stream->eot == true) && ((stream->fill_events.trx & UHF_SPI_EVENT_EOTA) != 0U))))
+    {
+        /* The FIFO was read after EOT */
+        stream->complete = true;
+        stream->busy = false;
+        return;
+    }
+
+    /* A fill level event already set at the fill level read is the one
+       this read-out was queued for */
+    more = (stream->eot == true) ||
+           ((stream->events[0] & (uint8_t)~stream->fill_events.system & UHF_SPI_EVENT_DFIFO) != 0U);
+    if (more == false)
+    {
+        stream->busy = false;
+    }
+    else if ((space != 0U) && ((dev->queue_count + 3U) <= UHF_SPI_QUEUE_LENGTH))
+    {
+        uhf_spi_stream_read(dev, stream, (space > 0xFFU) ? 0xFFU : (uint8_t)space);
+    }
+    else
+    {
+        /* The rest stays in the FIFO */
+        stream->overrun = true;
+        stream->complete = true;
+        stream->busy = false;
+    }
+}
+
+static void uhf_spi_stream_read(uhf_dev_t *dev, uhf_spi_stream_rx_t *stream, uint8_t space)
+{
+    uhf_spi_cmd_t cmd[3];
+    uint8_t i;
+
+    memset(cmd, 0, sizeof(cmd));
+    stream->fill = 0;
+    stream->tail = stream->eot;
+    cmd[0].id = UHF_SPI_CMD_READ_FILL_LEVEL_RX_FIFO;
+    cmd[0].data = &stream->fill;
+    cmd[0].callback = uhf_spi_stream_fill_callback;
+    cmd[0].context = (uintptr_t)stream;
+    cmd[1].id = UHF_SPI_CMD_READ_RX_FIFO;
+    cmd[1].data = &stream->data[stream->length];
+    cmd[1].length = space;
+    cmd[1].length_ref = &stream->fill;
+    cmd[2].id = UHF_SPI_CMD_GET_EVENT_BYTES;
+    cmd[2].data = &stream->events[0];
+    cmd[2].callback = uhf_spi_stream_callback;
+    cmd[2].context = (uintptr_t)stream;
+
+    for (i = 0; i < 3U; i++)
+    {
+        (void)uhf_spi_submit(dev, &cmd[i]);
+    }
+}
+
+/* Fill level of a TX refill, the write takes what fits and is left */
+static void uhf_spi_stream_tx_fill_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_spi_stream_tx_t *stream = (uhf_spi_stream_tx_t *)context;
+    uint16_t left = stream->length - stream->written;
+
+    stream->fill_events = cmd->events;
+    if ((left != 0U) && (stream->fill < stream->fill_min))
+    {
+        stream->fill_min = stream->fill;
+    }
+    stream->space = (stream->fill < UHF_SPI_DFIFO_SIZE) ? (uint8_t)(UHF_SPI_DFIFO_SIZE - stream->fill) : 0U;
+    if (stream->space > left)
+    {
+        stream->space = (uint8_t)left;
+    }
+    if ((stream->fill_events.trx & UHF_SPI_EVENT_EOTA) != 0U)
+    {
+        /* Over already, nothing more goes on air */
+        stream->space = 0;
+    }
+}
+
+static void uhf_spi_stream_tx_write_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_spi_stream_tx_t *stream = (uhf_spi_stream_tx_t *)context;
+
+    if (cmd->length != 0U)
+    {
+        stream->written += cmd->length;
+        stream->writes++;
+        if ((cmd->events.trx & UHF_SPI_EVENT_EOTA) != 0U)
+        {
+            /* Written after EOT, these bytes stay in the FIFO */
+            stream->underrun = true;
+        }
+    }
+}
+
+static void uhf_spi_stream_tx_refill(uhf_dev_t *dev, uhf_spi_stream_tx_t *stream);
+
+/* Event bytes of a TX refill: wait for the next IRQ, refill on or done */
+static void uhf_spi_stream_tx_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_spi_stream_tx_t *stream = (uhf_spi_stream_tx_t *)context;
+    uhf_dev_t *dev = stream->dev;
+
+    if (((stream->events[1] | stream->fill_events.trx) & UHF_SPI_EVENT_EOTA) != 0U)
+    {
+        if (stream->written < stream->length)
+        {
+            stream->underrun = true;
+        }
+        stream->complete = true;
+        stream->busy = false;
+    }
+    else if (((stream->events[0] & (uint8_t)~stream->fill_events.system & UHF_SPI_EVENT_DFIFO) != 0U) &&
+             ((dev->queue_count + 3U) <= UHF_SPI_QUEUE_LENGTH))
+    {
+        /* Went down to the threshold during the refill, the event read
+           cleared the IRQ for it */
+        uhf_spi_stream_tx_refill(dev, stream);
+    }
+    else
+    {
+        stream->busy = false;
+    }
+}
+
+static void uhf_spi_stream_tx_refill(uhf_dev_t *dev, uhf_spi_stream_tx_t *stream)
+{
+    uhf_spi_cmd_t cmd[3];
+    uint8_t i;
+
+    memset(cmd, 0, sizeof(cmd));
+    stream->fill = 0;
+    stream->space = 0;
+    cmd[0].id = UHF_SPI_CMD_READ_FILL_LEVEL_TX_FIFO;
+    cmd[0].data = &stream->fill;
+    cmd[0].callback = uhf_spi_stream_tx_fill_callback;
+    cmd[0].context = (uintptr_t)stream;
+    /* The driver only reads a payload that is written */
+    cmd[1].id = UHF_SPI_CMD_WRITE_TX_FIFO;
+    cmd[1].data = (uint8_t *)&stream->data[stream->written];
+    cmd[1].length = UHF_SPI_DFIFO_SIZE;
+    cmd[1].length_ref = &stream->space;
+    cmd[1].callback = uhf_spi_stream_tx_write_callback;
+    cmd[1].context = (uintptr_t)stream;
+    cmd[2].id = UHF_SPI_CMD_GET_EVENT_BYTES;
+    cmd[2].data = &stream->events[0];
+    cmd[2].callback = uhf_spi_stream_tx_callback;
+    cmd[2].context = (uintptr_t)stream;
+
+    for (i = 0; i < 3U; i++)
+    {
+        (void)uhf_spi_submit(dev, &cmd[i]);
+    }
+}
+
+static uint8_t uhf_spi_run_byte(uhf_dev_t *dev, uint8_t id)
+{
+    uint8_t value = 0;
+    uhf_spi_cmd_t cmd = { .id = id, .data = &value };
+
+    uhf_spi_run(dev, &cmd);
+
+    return value;
+}
+
+static void uhf_spi_run_param(uhf_dev_t *dev, uint8_t id, uint8_t param0, uint8_t param1)
+{
+    uhf_spi_cmd_t cmd = { .id = id, .param = { param0, param1 } };
+
+    uhf_spi_run(dev, &cmd);
+}
+
+static void uhf_spi_run_data(uhf_dev_t *dev, uint8_t id, uint16_t addr, uint8_t *data, uint8_t length)
+{
+    uhf_spi_cmd_t cmd = { .id = id, .addr = addr, .data = data, .length = length };
+
+    uhf_spi_run(dev, &cmd);
+}
+
+static void uhf_spi_dump_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_spi_dump_t *dump = (uhf_spi_dump_t *)context;
+
+    dump->completed += cmd->length;
+    dump->progress = true;
+}
+
+#if (UHF_SPI_REGMAP_ENABLE == 1)
+static bool uhf_spi_regmap_dirty(const uhf_spi_regmap_t *map, uint8_t index)
+{
+    return ((map->dirty[index / 32U] & (1UL << (index % 32U))) != 0U);
+}
+
+/* Register index follows index - 1 directly in SRAM and fits the same telegram as first */
+static bool uhf_spi_regmap_contiguous(const uhf_spi_regmap_t *map, uint8_t first, uint8_t index)
+{
+    return ((map->reg[index].addr == (map->reg[index - 1U].addr + map->reg[index - 1U].size)) &&
+            (((uint32_t)map->offset[index] + map->reg[index].size - map->offset[first]) <= 0xFFU));
+}
+
+static void uhf_spi_regmap_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_spi_regmap_t *map = &((uhf_dev_t *)context)->regmap;
+
+    map->pending--;
+    map->progress = true;
+}
+
+/* Queue one telegram moving registers first to last, sleeping while the
+   queue is full */
+static void uhf_spi_regmap_submit(uhf_dev_t *dev, uint8_t id, uint8_t first, uint8_t last)
+{
+    uhf_spi_regmap_t *map = &dev->regmap;
+    uhf_spi_cmd_t cmd = { .id = id, .callback = uhf_spi_regmap_callback };
+
+    cmd.addr = map->reg[first].addr;
+    cmd.data = &map->mirror[map->offset[first]];
+    cmd.length = (uint8_t)(map->offset[last] + map->reg[last].size - map->offset[first]);
+    cmd.context = (uintptr_t)dev;
+    while (uhf_spi_submit(dev, &cmd) == false)
+    {
+        map->progress = false;
+        uhf_spi_wait(&map->progress);
+    }
+    map->pending++;
+}
+
+static void uhf_spi_regmap_wait(uhf_dev_t *dev)
+{
+    uhf_spi_regmap_t *map = &dev->regmap;
+
+    while (map->pending != 0U)
+    {
+        map->progress = false;
+        uhf_spi_wait(&map->progress);
+    }
+}
+#endif
+
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+static void uhf_spi_shadow_read_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    uhf_spi_shadow_t *shadow = &((uhf_dev_t *)context)->shadow;
+
+    /* Reads complete in order, the sums see the bytes in data[] order */
+    uhf_spi_shadow_sum(shadow, *cmd->data);
+    shadow->pending--;
+    shadow->done = true;
+}
+
+/* Read every shadowed byte back, into data[] (fill) or through the scratch
+   ring into the sums only (verify). The reads are queued back to back
+   rather than run one by one. */
+static void uhf_spi_shadow_read(uhf_dev_t *dev, bool fill)
+{
+    uhf_spi_shadow_t *shadow = &dev->shadow;
+    uhf_spi_cmd_t cmd = { .id = UHF_SPI_CMD_READ_EEPROM, .length = 1, .callback = uhf_spi_shadow_read_callback };
+    const uhf_spi_shadow_range_t *range;
+    uint16_t n = 0;
+    uint16_t i;
+    uint8_t r;
+
+    shadow->sum1 = 0;
+    shadow->sum2 = 0;
+    shadow->pending = shadow->used;
+    cmd.context = (uintptr_t)dev;
+    for (r = 0; r < shadow->count; r++)
+    {
+        range = &shadow->range[r];
+        for (i = 0; i < range->length; i++)
+        {
+            cmd.addr = range->addr + i;
+            /* A scratch slot is free again once the queue has room */
+            cmd.data = (fill == true) ? &shadow->data[range->offset + i] : &shadow->scratch[n % UHF_SPI_QUEUE_LENGTH];
+            n++;
+            /* Queue full, sleep until a read has completed */
+            while (uhf_spi_submit(dev, &cmd) == false)
+            {
+                shadow->done = false;
+                uhf_spi_wait(&shadow->done);
+            }
+        }
+    }
+
+    while (shadow->pending != 0U)
+    {
+        shadow->done = false;
+        uhf_spi_wait(&shadow->done);
+    }
+}
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SPI_ATA8510 Global Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void delay_ms(uint32_t ms)
+{
+    SYSTICK_DelayMs(ms);
+}
+
+void delay_us(uint32_t us)
+{
+    SYSTICK_DelayUs(us);
+}
+
+uhf_dev_t *uhf_spi_initialize(uint8_t index, const uhf_spi_init_t *init)
+{
+    uhf_dev_t *dev;
+
+    if ((index >= UHF_SPI_INSTANCES_NUMBER) || (init == NULL))
+    {
+        return NULL;
+    }
+
+    dev = &g_dev[index];
+    memset(dev, 0, sizeof(uhf_dev_t));
+    dev->init = init;
+    dev->state = UHF_SPI_STATE_IDLE;
+
+    /* Guard times are converted once, not per command */
+    dev->count_setup = uhf_spi_us_to_count(dev, UHF_SPI_T0 + UHF_SPI_T1);
+    dev->count_setup_awake = uhf_spi_us_to_count(dev, UHF_SPI_T1);
+    dev->count_hold = uhf_spi_us_to_count(dev, UHF_SPI_T4);
+    dev->count_idle = uhf_spi_us_to_count(dev, UHF_SPI_T5);
+    dev->count_poll = uhf_spi_us_to_count(dev, UHF_SPI_EEPROM_POLL_US);
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+    dev->count_rssi_poll = uhf_spi_us_to_count(dev, UHF_SPI_RSSI_POLL_US);
+#endif
+
+    /* Start at the MHC rate, uhf_spi_speed_negotiate() may raise it */
+    uhf_spi_speed_set(dev, 0);
+
+#if (UHF_SPI_DMA_ENABLE == 1)
+    DMAC_ChannelCallbackRegister(dev->init->dma_channel_rx, uhf_spi_dma_rx_callback, (uintptr_t)dev);
+#endif
+#if (UHF_SPI_GUARD_TIMER_ENABLE == 1)
+    dev->init->timer_callback_register(uhf_spi_guard_timer_callback, (uintptr_t)dev);
+    /* Enable the one-shot and stop it right away, it is retriggered per guard */
+    dev->init->timer_start();
+    dev->init->timer_command(TC_COMMAND_STOP);
+#endif
+#if (UHF_SPI_TRACE_ENABLE == 1)
+    /* Free-running, shared by all instances */
+    dev->init->trace_counter_start();
+#endif
+#if (UHF_SPI_IRQ_EIC_ENABLE == 1)
+    dev->init->irq_callback_register(dev->init->irq_eic_pin, uhf_spi_irq_edge_callback, (uintptr_t)dev);
+#endif
+
+    return dev;
+}
+
+bool uhf_spi_submit(uhf_dev_t *dev, const uhf_spi_cmd_t *cmd)
+{
+    uint8_t tail;
+
+    if ((cmd == NULL) || (dev->queue_count >= UHF_SPI_QUEUE_LENGTH))
+    {
+        return false;
+    }
+
+    tail = (dev->queue_head + dev->queue_count) % UHF_SPI_QUEUE_LENGTH;
+    dev->queue[tail] = *cmd;
+    dev->queue_count++;
+
+    return true;
+}
+
+bool uhf_spi_submit_chain(uhf_dev_t *dev, const uhf_spi_cmd_t *cmds, uint8_t count)
+{
+    uint8_t i;
+
+    /* All or nothing, the caller has no way to take back a half queued chain */
+    if ((cmds == NULL) || (count == 0U) || ((dev->queue_count + count) > UHF_SPI_QUEUE_LENGTH))
+    {
+        return false;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        (void)uhf_spi_submit(dev, &cmds[i]);
+    }
+
+    return true;
+}
+
+void uhf_spi_tasks(uhf_dev_t *dev)
+{
+    bool run = true;
+
+    uhf_spi_eeprom_job_tasks(dev);
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+    uhf_spi_survey_tasks(dev);
+#endif
+
+    if (dev->queue_count == 0U)
+    {
+        return;
+    }
+
+#if (UHF_SPI_STATS_ENABLE == 1)
+    dev->stat_mark = SYS_TIME_CounterGet();
+#endif
+
+    while (run == true)
+    {
+        switch (dev->state)
+        {
+            case UHF_SPI_STATE_IDLE:
+                if ((dev->queue_count == 0U) || (dev->hold == true))
+                {
+                    run = false;
+                    break;
+                }
+                dev->size = uhf_spi_frame_build(dev, &dev->queue[dev->queue_head]);
+                if (dev->size == 0U)
+                {
+                    /* Nothing to send, complete right away */
+                    uhf_spi_complete(dev);
+                    break;
+                }
+#if (UHF_SPI_STATS_ENABLE == 1)
+                uhf_spi_stats_mark(dev);
+                dev->stat_start = dev->stat_mark;
+                dev->stat_busy = 0;
+#endif
+#if (UHF_SPI_TRACE_ENABLE == 1)
+                dev->trace_start = dev->init->trace_counter_get();
+#endif
+                SYS_PORT_PinClear(dev->init->cs_pin);
+                /* Guard timer taken over from an EEPROM job poll interval */
+                dev->eeprom_job.poll_armed = false;
+#if (UHF_SPI_WAKE_TRACKING_ENABLE == 1)
+                /* T0 only covers the AVR wake-up from sleep */
+                if (dev->awake == true)
+                {
+                    dev->wake_skipped++;
+                    uhf_spi_timer_start(dev, dev->count_setup_awake);
+                }
+                else
+                {
+                    dev->wake_paid++;
+                    uhf_spi_timer_start(dev, dev->count_setup);
+                }
+#else
+                uhf_spi_timer_start(dev, dev->count_setup);
+#endif
+                dev->state = UHF_SPI_STATE_CS_SETUP;
+                break;
+
+            case UHF_SPI_STATE_CS_SETUP:
+                if (uhf_spi_timer_expired(dev) == false)
+                {
+                    run = false;
+                    break;
+                }
+                uhf_spi_transfer_start(dev, dev->size);
+                dev->state = UHF_SPI_STATE_TRANSFER;
+                break;
+
+            case UHF_SPI_STATE_TRANSFER:
+                if (dev->transfer_done == false)
+                {
+                    run = false;
+                    break;
+                }
+                uhf_spi_timer_start(dev, dev->count_hold);
+                dev->state = UHF_SPI_STATE_CS_HOLD;
+                break;
+
+            case UHF_SPI_STATE_CS_HOLD:
+                if (uhf_spi_timer_expired(dev) == false)
+                {
+                    run = false;
+                    break;
+                }
+                SYS_PORT_PinSet(dev->init->cs_pin);
+                uhf_spi_timer_start(dev, dev->count_idle);
+                dev->state = UHF_SPI_STATE_CS_IDLE;
+                break;
+
+            case UHF_SPI_STATE_CS_IDLE:
+                if (uhf_spi_timer_expired(dev) == false)
+                {
+                    run = false;
+                    break;
+                }
+                uhf_spi_complete(dev);
+                break;
+
+            default:
+                run = false;
+                break;
+        }
+    }
+
+#if (UHF_SPI_STATS_ENABLE == 1)
+    uhf_spi_stats_mark(dev);
+#endif
+}
 
-void delay_ms(uint32_t ms)
+bool uhf_spi_is_idle(uhf_dev_t *dev)
 {
-    SYSTICK_DelayMs(ms);
+    return (dev->queue_count == 0U);
 }
 
-void delay_us(uint32_t us)
+void uhf_spi_stats_get(uhf_dev_t *dev, uhf_spi_stats_t *stats)
 {
-    SYSTICK_DelayUs(us);
+    memset(stats, 0, sizeof(uhf_spi_stats_t));
+
+#if (UHF_SPI_STATS_ENABLE == 1)
+    stats->commands = dev->stat_commands;
+    stats->wall_last = SYS_TIME_CountToUS(dev->stat_wall_last);
+    stats->busy_last = SYS_TIME_CountToUS(dev->stat_busy_last);
+    stats->wall_max = SYS_TIME_CountToUS(dev->stat_wall_max);
+    stats->busy_max = SYS_TIME_CountToUS(dev->stat_busy_max);
+    if (dev->stat_commands != 0U)
+    {
+        stats->wall_avg = SYS_TIME_CountToUS((uint32_t)(dev->stat_wall_total / dev->stat_commands));
+        stats->busy_avg = SYS_TIME_CountToUS((uint32_t)(dev->stat_busy_total / dev->stat_commands));
+    }
+#endif
+    stats->wake_paid = dev->wake_paid;
+    stats->wake_skipped = dev->wake_skipped;
+    stats->speed = g_speed[dev->speed_index];
+    stats->speed_fallbacks = dev->speed_fallbacks;
 }
 
-void uhf_power_on(void)
+void uhf_spi_stats_reset(uhf_dev_t *dev)
 {
-    /* clear UHF NPWRON1 line to wake-up device */
-    UHF_NPWRON1_CLEAR;
-    /* clear and set NRES pin to initialize device */
-    UHF_NRESET_CLEAR;
-    delay_us(1000);
-    UHF_NRESET_SET;
-    delay_us(5000);
+    dev->stat_commands = 0;
+    dev->stat_wall_last = 0;
+    dev->stat_busy_last = 0;
+    dev->stat_wall_max = 0;
+    dev->stat_busy_max = 0;
+    dev->stat_wall_total = 0;
+    dev->stat_busy_total = 0;
+    dev->wake_paid = 0;
+    dev->wake_skipped = 0;
+    dev->speed_fallbacks = 0;
 }
 
-uint8_t uhf_spi_read_fill_level_rx_fifo(void)
+#if (UHF_SPI_TRACE_ENABLE == 1)
+uint32_t uhf_spi_trace_get(uhf_dev_t *dev, uhf_spi_trace_t *records, uint32_t size)
 {
-    UHF_SPI_CS_ENABLE;
-    
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
-    
-    g_tx_buf[0] = UHF_SPI_CMD_READ_FILL_LEVEL_RX_FIFO;
-    g_tx_buf[1] = g_tx_buf[2] = 0;
-
-    UHF_SPI_TRANSFER(g_tx_buf,0x03, g_rx_buf, 0x03);
+    uint32_t first = 0;
+    uint32_t count = dev->trace_count;
+    uint32_t i;
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+    if (count > UHF_SPI_TRACE_LENGTH)
+    {
+        first = count - UHF_SPI_TRACE_LENGTH;
+        count = UHF_SPI_TRACE_LENGTH;
+    }
+    if (count > size)
+    {
+        count = size;
+    }
+    for (i = 0; i < count; i++)
+    {
+        records[i] = dev->trace[(first + i) & (UHF_SPI_TRACE_LENGTH - 1U)];
+    }
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
-    
-    return g_rx_buf[2];
+    return count;
 }
 
-uint8_t uhf_spi_read_fill_level_tx_fifo(void)
+void uhf_spi_trace_dump(uhf_dev_t *dev)
 {
-    UHF_SPI_CS_ENABLE;
-    
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
-    
-    g_tx_buf[0] = UHF_SPI_CMD_READ_FILL_LEVEL_TX_FIFO;
-    g_tx_buf[1] = g_tx_buf[2] = 0;
+    uhf_spi_trace_t rec;
+    char line[80];
+    uint32_t first = 0;
+    uint32_t count = dev->trace_count;
+    uint32_t ticks_per_us = dev->init->trace_frequency_get() / 1000000UL;
+    uint32_t ticks;
+    uint32_t i;
+    int n;
+
+    if (count > UHF_SPI_TRACE_LENGTH)
+    {
+        first = count - UHF_SPI_TRACE_LENGTH;
+        count = UHF_SPI_TRACE_LENGTH;
+    }
+    if (ticks_per_us == 0U)
+    {
+        ticks_per_us = 1U;
+    }
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x03, g_rx_buf, 0x03);
+    n = snprintf(line, sizeof(line), "\r\nSPI trace %lu of %lu\r\n  op len    start  ticks    us sys trx\r\n",
+        (unsigned long)count, (unsigned long)dev->trace_count);
+    dev->init->trace_write(line, (size_t)n);
+    for (i = 0; i < count; i++)
+    {
+        rec = dev->trace[(first + i) & (UHF_SPI_TRACE_LENGTH - 1U)];
+        ticks = (rec.end - rec.start) & dev->init->trace_counter_mask;
+        n = snprintf(line, sizeof(line), "  %02X %3u %08lX %6lu %5lu  %02X  %02X\r\n",
+            rec.opcode, rec.length, (unsigned long)rec.start, (unsigned long)ticks,
+            (unsigned long)(ticks / ticks_per_us), rec.system, rec.trx);
+        dev->init->trace_write(line, (size_t)n);
+    }
+
+    dev->trace_count = 0;
+}
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
-   
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
-    
-    return g_rx_buf[2];
+void uhf_spi_trace_reset(uhf_dev_t *dev)
+{
+    dev->trace_count = 0;
 }
+#endif
 
-uint8_t uhf_spi_read_fill_level_rssi_fifo(void)
+uint32_t uhf_spi_speed_negotiate(uhf_dev_t *dev)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
-    
-    g_tx_buf[0] = UHF_SPI_CMD_READ_FILL_LEVEL_RSSI_FIFO;
-    g_tx_buf[1] = g_tx_buf[2] = 0;
+    uint8_t scratch[UHF_SPI_SPEED_SCRATCH_LENGTH];
+    uint8_t version;
+    uint8_t index;
+    uint8_t passed = 0;
+    bool found = false;
+
+    /* SCK must not change under a queued telegram, and the SRAM scratch
+       area must not be touched while a job stages EEPROM data in SRAM */
+    uhf_spi_eeprom_job_wait(dev);
+    while (uhf_spi_is_idle(dev) == false)
+    {
+        uhf_spi_tasks(dev);
+    }
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x03, g_rx_buf, 0x03);
+    dev->speed_probe = true;
+    uhf_spi_speed_set(dev, 0);
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
-    
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+    /* Reference values at the slowest rate */
+    version = uhf_spi_get_version_ROM(dev);
+    uhf_spi_read_sram_reg(dev, UHF_SPI_SPEED_SCRATCH_ADDR, scratch, sizeof(scratch));
 
-    return g_rx_buf[2];
-}
+    for (index = 0; index < UHF_SPI_SPEED_COUNT; index++)
+    {
+        uhf_spi_speed_set(dev, index);
+        if (uhf_spi_speed_test(dev, version) == false)
+        {
+            break;
+        }
+        passed = index;
+        found = true;
+    }
 
-void uhf_spi_get_event_bytes(uint8_t *events)
-{
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    /* Stay a margin below the fastest rate that passed */
+    if ((found == false) || (passed < UHF_SPI_SPEED_MARGIN))
+    {
+        passed = 0;
+    }
+    else
+    {
+        passed -= UHF_SPI_SPEED_MARGIN;
+    }
+    uhf_spi_speed_set(dev, passed);
+
+    uhf_spi_write_sram_reg(dev, UHF_SPI_SPEED_SCRATCH_ADDR, scratch, sizeof(scratch));
 
-    g_tx_buf[0] = UHF_SPI_CMD_GET_EVENT_BYTES;
-    memset(&g_tx_buf[1], 0x00, 0x03);
+    dev->speed_errors = 0;
+    dev->speed_probe = false;
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x04, g_rx_buf, 0x04);
+    return g_speed[passed];
+}
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
-    
-    memcpy(events, g_rx_buf, 0x04);
+uint32_t uhf_spi_speed_get(uhf_dev_t *dev)
+{
+    return g_speed[dev->speed_index];
 }
 
-void uhf_spi_read_rssi_fifo(uint8_t *data, uint8_t length)
+bool uhf_spi_drain_submit(uhf_dev_t *dev, uhf_spi_drain_t *drain, uhf_spi_callback_t callback, uintptr_t context)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    uhf_spi_cmd_t cmd[4];
+    uint8_t count;
+    uint8_t i;
 
-    g_tx_buf[0] = UHF_SPI_CMD_READ_RSSI_FIFO;
-    g_tx_buf[1] = length;
-    /* Dummy bytes; extra one dummy byte in addition to length of data */
-    memset(&g_tx_buf[2], 0x00, length + 1);
+    if (drain == NULL)
+    {
+        return false;
+    }
+
+    memset(cmd, 0, sizeof(cmd));
+    count = uhf_spi_drain_build(&cmd[0], UHF_SPI_CMD_READ_FILL_LEVEL_RX_FIFO,
+                                (drain->byte_int == true) ? UHF_SPI_CMD_READ_RX_BUFFER_BYTE_INT : UHF_SPI_CMD_READ_RX_FIFO,
+                                drain->rx_data, drain->rx_size, &drain->rx_length);
+    count += uhf_spi_drain_build(&cmd[count], UHF_SPI_CMD_READ_FILL_LEVEL_RSSI_FIFO,
+                                 (drain->byte_int == true) ? UHF_SPI_CMD_READ_RSSI_BUFFER_BYTE_INT : UHF_SPI_CMD_READ_RSSI_FIFO,
+                                 drain->rssi_data, drain->rssi_size, &drain->rssi_length);
+
+    /* All or nothing, a half queued drain would leave a FIFO behind */
+    if ((count == 0U) || ((dev->queue_count + count) > UHF_SPI_QUEUE_LENGTH))
+    {
+        return false;
+    }
 
-    UHF_SPI_TRANSFER(g_tx_buf, length+3, g_rx_buf, length+3);
+    cmd[0].callback = uhf_spi_drain_events_callback;
+    cmd[0].context = (uintptr_t)drain;
+    cmd[count - 1U].callback = callback;
+    cmd[count - 1U].context = context;
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+    for (i = 0; i < count; i++)
+    {
+        (void)uhf_spi_submit(dev, &cmd[i]);
+    }
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
-    /* g_rx_buf[2] is a dummy byte */
-    memcpy(data, &g_rx_buf[3], length);
+    return true;
 }
 
-void uhf_spi_read_rx_fifo(uint8_t *data, uint8_t length)
+uint8_t uhf_spi_drain_rx(uhf_dev_t *dev, uint8_t *data, uint8_t size)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    uhf_spi_drain_t drain = { .rx_data = data, .rx_size = size };
 
-    g_tx_buf[0] = UHF_SPI_CMD_READ_RX_FIFO;
-    g_tx_buf[1] = length;
-    /* Dummy bytes; extra one dummy byte in addition to length of data */
-    memset(&g_tx_buf[2], 0x00, length + 1);
+    uhf_spi_drain(dev, &drain);
 
-    UHF_SPI_TRANSFER(g_tx_buf, length+3, g_rx_buf, length+3);
-    
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+    return drain.rx_length;
+}
+
+uint8_t uhf_spi_drain_rssi(uhf_dev_t *dev, uint8_t *data, uint8_t size)
+{
+    uhf_spi_drain_t drain = { .rssi_data = data, .rssi_size = size };
+
+    uhf_spi_drain(dev, &drain);
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
-    /* g_rx_buf[2] is a dummy byte */
-    memcpy(data, &g_rx_buf[3], length);    
+    return drain.rssi_length;
 }
 
-void uhf_spi_write_sram_reg(uint16_t addr, uint8_t *data, uint8_t length)
+void uhf_spi_drain(uhf_dev_t *dev, uhf_spi_drain_t *drain)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    volatile bool done = false;
 
-    g_tx_buf[0] = UHF_SPI_CMD_WRITE_SRAM;
-    g_tx_buf[1] = length;
-    /* High byte of address */
-    g_tx_buf[2] = (addr >> 0x08) & 0xFF;
-    /* Low byte of address */
-    g_tx_buf[3] = (addr & 0xFF);
-    memcpy(&g_tx_buf[4], data, length);
+    if ((drain == NULL) || ((drain->rx_data == NULL) && (drain->rssi_data == NULL)))
+    {
+        return;
+    }
 
-    UHF_SPI_TRANSFER(g_tx_buf, length+4, g_rx_buf, length+4);
+    while (uhf_spi_drain_submit(dev, drain, uhf_spi_sync_callback, (uintptr_t)&done) == false)
+    {
+        uhf_spi_tasks(dev);
+    }
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+    uhf_spi_wait(&done);
+}
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
-    /* All other are dummy bytes */
+void uhf_spi_stream_rx_init(uhf_spi_stream_rx_t *stream, uint8_t *data, uint16_t size)
+{
+    memset(stream, 0, sizeof(uhf_spi_stream_rx_t));
+    stream->data = data;
+    stream->size = size;
 }
 
-void uhf_spi_read_sram_reg(uint16_t addr, uint8_t *data, uint8_t length)
+bool uhf_spi_stream_rx_submit(uhf_dev_t *dev, uhf_spi_stream_rx_t *stream)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    uint16_t space;
+
+    if ((stream == NULL) || (stream->busy == true) || (stream->complete == true) ||
+        ((dev->queue_count + 3U) > UHF_SPI_QUEUE_LENGTH))
+    {
+        return false;
+    }
+
+    stream->busy = true;
+    stream->dev = dev;
+    space = stream->size - stream->length;
+    uhf_spi_stream_read(dev, stream, (space > 0xFFU) ? 0xFFU : (uint8_t)space);
 
-    g_tx_buf[0] = UHF_SPI_CMD_READ_SRAM;
-    g_tx_buf[1] = length;
-    /* High byte of address */
-    g_tx_buf[2] = (addr >> 0x08) & 0xFF;
-    /* Low byte of address */
-    g_tx_buf[3] = (addr & 0xFF);
-    memset(&g_tx_buf[4], 0x00, length + 1);
+    return true;
+}
 
-    UHF_SPI_TRANSFER(g_tx_buf, length+5, g_rx_buf, length+5);
+bool uhf_spi_stream_tx_start(uhf_dev_t *dev, uhf_spi_stream_tx_t *stream, const uint8_t *data, uint16_t length,
+                             uint8_t mode, uint8_t config)
+{
+    uhf_spi_cmd_t cmd[2];
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+    if ((stream == NULL) || (data == NULL) || (length == 0U) ||
+        ((dev->queue_count + 2U) > UHF_SPI_QUEUE_LENGTH))
+    {
+        return false;
+    }
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
-    /* g_rx_buf[2...4] are dummy bytes */
-    memcpy(data, &g_rx_buf[5], length);
+    memset(stream, 0, sizeof(uhf_spi_stream_tx_t));
+    stream->data = data;
+    stream->length = length;
+    stream->fill_min = UHF_SPI_DFIFO_SIZE;
+    stream->dev = dev;
+
+    memset(cmd, 0, sizeof(cmd));
+    cmd[0].id = UHF_SPI_CMD_WRITE_TX_FIFO;
+    cmd[0].data = (uint8_t *)data;
+    cmd[0].length = (length > UHF_SPI_DFIFO_SIZE) ? UHF_SPI_DFIFO_SIZE : (uint8_t)length;
+    cmd[1].id = UHF_SPI_CMD_SET_SYSTEM_MODE;
+    cmd[1].param[0] = mode;
+    cmd[1].param[1] = config;
+    (void)uhf_spi_submit(dev, &cmd[0]);
+    (void)uhf_spi_submit(dev, &cmd[1]);
+    stream->written = cmd[0].length;
+    stream->writes = 1;
+
+    return true;
 }
 
-void uhf_spi_write_eeprom(uint16_t addr, uint8_t data)
+bool uhf_spi_stream_tx_submit(uhf_dev_t *dev, uhf_spi_stream_tx_t *stream)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    if ((stream == NULL) || (stream->busy == true) || (stream->complete == true) ||
+        ((dev->queue_count + 3U) > UHF_SPI_QUEUE_LENGTH))
+    {
+        return false;
+    }
 
-    g_tx_buf[0] = UHF_SPI_CMD_WRITE_EEPROM;
-    g_tx_buf[1] = (addr >> 0x08) & 0xFF;
-    g_tx_buf[2] = (addr & 0xFF);
-    g_tx_buf[3] = data;
+    stream->busy = true;
+    uhf_spi_stream_tx_refill(dev, stream);
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x04, g_rx_buf, 0x04);
+    return true;
+}
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+const events_struct_t *uhf_spi_events_get(uhf_dev_t *dev)
+{
+    return &dev->events;
+}
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+bool uhf_irq_get(uhf_dev_t *dev)
+{
+    return SYS_PORT_PinRead(dev->init->irq_pin);
 }
 
-void uhf_spi_write_eeprom_block(uint16_t addr, uint8_t *data, uint8_t len)
+#if (UHF_SPI_IRQ_EIC_ENABLE == 1)
+bool uhf_spi_irq_take(uhf_dev_t *dev, uint32_t *stamp)
 {
-    uint8_t i = 0;
-    uint8_t tmpLen;
+    uint32_t edge;
 
-    while(i < len)
+    if (dev->irq_pending == false)
     {
-        uhf_spi_write_sram_reg(0x02E9, (uint8_t *)&addr + 1, 1);/* high addr */
-        uhf_spi_write_sram_reg(0x02EA, (uint8_t *)&addr, 1);    /* low addr */
-        if((i + 7) <= len)
-        {
-            tmpLen = 7;
-            uhf_spi_write_sram_reg(0x02EB, &tmpLen, 1);         /* len */
-            uhf_spi_write_sram_reg(0x02EC, &data[i], 7);        /* data */
-        }
-        else
-        {
-            tmpLen = len - i;
-            uhf_spi_write_sram_reg(0x02EB, &tmpLen, 1);         /* len */
-            uhf_spi_write_sram_reg(0x02EC, &data[i], len - i);  /* data */
-        }
-        i += tmpLen;
-        addr += tmpLen;
-        uhf_spi_trigger_eeprom_secure_write();
-        delay_us(10000 * tmpLen);
+        return false;
     }
+
+    /* The interrupt writes the stamp before the flag: if it hits between
+       reading the stamp and clearing the flag, the stamp changed and is
+       read again, otherwise the flag stays set for the newer edge */
+    do
+    {
+        edge = dev->irq_stamp;
+        dev->irq_pending = false;
+    } while (edge != dev->irq_stamp);
+    *stamp = edge;
+
+    return true;
 }
+#endif
 
-uint8_t uhf_spi_read_eeprom(uint16_t addr)
+bool uhf_spi_sleep_allowed(uhf_dev_t *dev)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
-
-    g_tx_buf[0] = UHF_SPI_CMD_READ_EEPROM;
-    g_tx_buf[1] = (addr >> 0x08) & 0xFF;
-    g_tx_buf[2] = (addr & 0xFF);
-    /*/ Two dummy bytes */
-    g_tx_buf[3] = 0x00;
-    g_tx_buf[4] = 0x00;
+    return uhf_spi_idle_or_waiting(dev);
+}
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x05, g_rx_buf, 0x05);
+void uhf_power_on(uhf_dev_t *dev)
+{
+    /* clear UHF NPWRON1 line to wake-up device */
+    SYS_PORT_PinClear(dev->init->npwron_pin);
+    /* clear and set NRES pin to initialize device */
+    SYS_PORT_PinClear(dev->init->nreset_pin);
+    delay_us(1000);
+    SYS_PORT_PinSet(dev->init->nreset_pin);
+    delay_us(5000);
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+    /* Device starts in IDLE with the AVR asleep */
+    dev->opm = UHF_SPI_OPM_IDLE;
+    dev->awake = false;
+}
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+uint8_t uhf_spi_read_fill_level_rx_fifo(uhf_dev_t *dev)
+{
+    return uhf_spi_run_byte(dev, UHF_SPI_CMD_READ_FILL_LEVEL_RX_FIFO);
+}
 
-    return g_rx_buf[4];
+uint8_t uhf_spi_read_fill_level_tx_fifo(uhf_dev_t *dev)
+{
+    return uhf_spi_run_byte(dev, UHF_SPI_CMD_READ_FILL_LEVEL_TX_FIFO);
 }
 
-void uhf_spi_write_tx_fifo(uint8_t *data, uint8_t length)
+uint8_t uhf_spi_read_fill_level_rssi_fifo(uhf_dev_t *dev)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    return uhf_spi_run_byte(dev, UHF_SPI_CMD_READ_FILL_LEVEL_RSSI_FIFO);
+}
 
-    g_tx_buf[0] = UHF_SPI_CMD_WRITE_TX_FIFO;
-    g_tx_buf[1] = length;
-    memcpy(&g_tx_buf[2], data, length);
+void uhf_spi_get_event_bytes(uhf_dev_t *dev, uint8_t *events)
+{
+    uhf_spi_run_data(dev, UHF_SPI_CMD_GET_EVENT_BYTES, 0, events, 0x04);
+}
 
-    UHF_SPI_TRANSFER(g_tx_buf, length+2, g_rx_buf, length+2);
+void uhf_spi_read_rssi_fifo(uhf_dev_t *dev, uint8_t *data, uint8_t length)
+{
+    uhf_spi_run_data(dev, UHF_SPI_CMD_READ_RSSI_FIFO, 0, data, length);
+}
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+void uhf_spi_read_rx_fifo(uhf_dev_t *dev, uint8_t *data, uint8_t length)
+{
+    uhf_spi_run_data(dev, UHF_SPI_CMD_READ_RX_FIFO, 0, data, length);
+}
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+void uhf_spi_write_sram_reg(uhf_dev_t *dev, uint16_t addr, uint8_t *data, uint8_t length)
+{
+    uhf_spi_run_data(dev, UHF_SPI_CMD_WRITE_SRAM, addr, data, length);
+}
 
-    /* All other are dummy bytes */
+void uhf_spi_read_sram_reg(uhf_dev_t *dev, uint16_t addr, uint8_t *data, uint8_t length)
+{
+    uhf_spi_run_data(dev, UHF_SPI_CMD_READ_SRAM, addr, data, length);
 }
 
-void uhf_spi_write_tx_preamble_fifo(uint8_t *data, uint8_t length)
+void uhf_spi_write_eeprom(uhf_dev_t *dev, uint16_t addr, uint8_t data)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    uhf_spi_cmd_t cmd = { .id = UHF_SPI_CMD_WRITE_EEPROM, .addr = addr, .param = { data, 0 } };
+
+    uhf_spi_run(dev, &cmd);
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+    uhf_spi_shadow_store(dev, addr, &data, 1);
+#endif
+}
 
-    g_tx_buf[0] = UHF_SPI_CMD_WRITE_TX_PREAMBLE_FIFO;
-    g_tx_buf[1] = length;
-    memcpy(&g_tx_buf[2], data, length);
+bool uhf_spi_write_eeprom_block(uhf_dev_t *dev, uint16_t addr, uint8_t *data, uint8_t len)
+{
+    volatile bool done = false;
 
-    UHF_SPI_TRANSFER(g_tx_buf, length+2, g_rx_buf, length+2);
+    /* A background job has to finish first, the block is not skipped */
+    uhf_spi_eeprom_job_wait(dev);
+    if (uhf_spi_eeprom_write_submit(dev, addr, data, len, uhf_spi_eeprom_sync_callback, (uintptr_t)&done) == false)
+    {
+        return false;
+    }
+    uhf_spi_wait(&done);
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+    return (dev->eeprom_job.status == UHF_SPI_EEPROM_DONE);
+}
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+bool uhf_spi_eeprom_write_submit(uhf_dev_t *dev, uint16_t addr, const uint8_t *data, uint16_t length,
+                                 uhf_spi_eeprom_callback_t callback, uintptr_t context)
+{
+    return uhf_spi_eeprom_job_start(dev, addr, data, length, false, callback, context);
+}
 
-    /* All other bytes are dummy */
+bool uhf_spi_eeprom_update_submit(uhf_dev_t *dev, uint16_t addr, const uint8_t *data, uint16_t length,
+                                  uhf_spi_eeprom_callback_t callback, uintptr_t context)
+{
+    return uhf_spi_eeprom_job_start(dev, addr, data, length, true, callback, context);
 }
 
-void uhf_spi_set_system_mode(uint8_t system_mode_config, uint8_t service_channel_config)
+bool uhf_spi_update_eeprom_block(uhf_dev_t *dev, uint16_t addr, uint8_t *data, uint8_t len)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
-    
-    g_tx_buf[0] = UHF_SPI_CMD_SET_SYSTEM_MODE;
-    g_tx_buf[1] = system_mode_config;
-    g_tx_buf[2] = service_channel_config;
-    
-    UHF_SPI_TRANSFER(g_tx_buf, 0x03, g_rx_buf, 0x03);
+    volatile bool done = false;
+
+    /* A background job has to finish first, the block is not skipped */
+    uhf_spi_eeprom_job_wait(dev);
+    if (uhf_spi_eeprom_update_submit(dev, addr, data, len, uhf_spi_eeprom_sync_callback, (uintptr_t)&done) == false)
+    {
+        return false;
+    }
+    uhf_spi_wait(&done);
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
-    
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+    return (dev->eeprom_job.status == UHF_SPI_EEPROM_DONE);
 }
 
-void uhf_spi_calibrate_and_check(uint8_t tune_check_config, uint8_t service_channel_config)
+uhf_spi_eeprom_status_t uhf_spi_eeprom_write_status(uhf_dev_t *dev, uint16_t *written)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
-    
-    g_tx_buf[0] = UHF_SPI_CMD_CALIBRATE_AND_CHECK;
-    g_tx_buf[1] = tune_check_config;
-    g_tx_buf[2] = service_channel_config;
+    if (written != NULL)
+    {
+        *written = dev->eeprom_job.written;
+    }
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x03, g_rx_buf, 0x03);
+    return dev->eeprom_job.status;
+}
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
-    
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+void uhf_spi_eeprom_report_get(uhf_dev_t *dev, uhf_spi_eeprom_report_t *report)
+{
+    const uhf_spi_eeprom_job_t *job = &dev->eeprom_job;
+    uint32_t per_byte = UHF_SPI_EEPROM_TIMEOUT_US;
+    uint32_t full;
+    uint32_t used;
+
+    report->length = job->length;
+    report->written = job->written;
+    report->skipped = job->skipped;
+    report->chunks = job->chunks;
+    report->compare_us = SYS_TIME_CountToUS(job->compare_time);
+    report->program_us = SYS_TIME_CountToUS(job->program_time);
+
+    /* Against programming all bytes at the rate seen for the written ones */
+    if (job->written != 0U)
+    {
+        per_byte = report->program_us / job->written;
+    }
+    full = per_byte * job->length;
+    used = report->compare_us + report->program_us;
+    report->saved_us = (full > used) ? (full - used) : 0U;
 }
 
-void uhf_spi_patch_spi(uint8_t parameter)
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+bool uhf_spi_eeprom_shadow_add(uhf_dev_t *dev, uint16_t addr, uint16_t length)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
-    
-    g_tx_buf[0] = UHF_SPI_CMD_PATCH_SPI;
-    g_tx_buf[1] = parameter;
+    uhf_spi_shadow_t *shadow = &dev->shadow;
+    uhf_spi_shadow_range_t range[UHF_SPI_EEPROM_SHADOW_RANGES + 1];
+    uint32_t end;
+    uint16_t used = 0;
+    uint8_t count = 0;
+    uint8_t i;
+
+    if ((length == 0U) || (((uint32_t)addr + length) > 0x10000UL))
+    {
+        return false;
+    }
+
+    /* Insert sorted by address */
+    memcpy(range, shadow->range, shadow->count * sizeof(uhf_spi_shadow_range_t));
+    i = shadow->count;
+    while ((i != 0U) && (range[i - 1U].addr > addr))
+    {
+        range[i] = range[i - 1U];
+        i--;
+    }
+    range[i].addr = addr;
+    range[i].length = length;
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x02, g_rx_buf, 0x02);
+    /* Merge overlapping or adjacent ranges, no byte is read twice */
+    for (i = 0; i <= shadow->count; i++)
+    {
+        end = (uint32_t)range[i].addr + range[i].length;
+        if ((count != 0U) && (range[i].addr <= ((uint32_t)range[count - 1U].addr + range[count - 1U].length)))
+        {
+            if (end > ((uint32_t)range[count - 1U].addr + range[count - 1U].length))
+            {
+                range[count - 1U].length = (uint16_t)(end - range[count - 1U].addr);
+            }
+        }
+        else
+        {
+            range[count] = range[i];
+            count++;
+        }
+    }
+    if (count > UHF_SPI_EEPROM_SHADOW_RANGES)
+    {
+        return false;
+    }
+    for (i = 0; i < count; i++)
+    {
+        range[i].offset = used;
+        used += range[i].length;
+        if (used > UHF_SPI_EEPROM_SHADOW_SIZE)
+        {
+            return false;
+        }
+    }
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+    memcpy(shadow->range, range, count * sizeof(uhf_spi_shadow_range_t));
+    shadow->count = count;
+    shadow->used = used;
+    shadow->valid = false;
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+    return true;
 }
 
-void uhf_spi_system_reset_ROM(void)
+bool uhf_spi_eeprom_shadow_fill(uhf_dev_t *dev)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
-    
-    g_tx_buf[0] = UHF_SPI_CMD_SYSTEM_RESET_ROM;
-    g_tx_buf[1] = 0x00;
-    
-    UHF_SPI_TRANSFER(g_tx_buf, 0x02, g_rx_buf, 0x02);
+    uhf_spi_shadow_t *shadow = &dev->shadow;
+
+    shadow->valid = false;
+    if ((shadow->used == 0U) || (dev->eeprom_job.state != UHF_SPI_EEPROM_JOB_IDLE))
+    {
+        return false;
+    }
+
+    uhf_spi_shadow_read(dev, true);
+    shadow->checksum = (uint16_t)((shadow->sum2 << 8) | shadow->sum1);
+    shadow->valid = true;
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+    return true;
 }
 
-uint8_t uhf_spi_get_version_ROM(void)
+bool uhf_spi_eeprom_shadow_verify(uhf_dev_t *dev)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    uhf_spi_shadow_t *shadow = &dev->shadow;
+
+    if ((shadow->valid == false) || (dev->eeprom_job.state != UHF_SPI_EEPROM_JOB_IDLE))
+    {
+        return false;
+    }
+
+    uhf_spi_shadow_read(dev, false);
+    if (((uint16_t)((shadow->sum2 << 8) | shadow->sum1) != shadow->checksum) ||
+        (uhf_spi_shadow_checksum(shadow) != shadow->checksum))
+    {
+        /* Reprogrammed behind the driver's back, or RAM corrupted */
+        shadow->valid = false;
+        return false;
+    }
 
-    g_tx_buf[0] = UHF_SPI_CMD_GET_VERSION_ROM;
-    g_tx_buf[1] = g_tx_buf[2] = 0;
+    return true;
+}
+#endif
+
+uint32_t uhf_spi_dump(uhf_dev_t *dev, uhf_spi_dump_space_t space, uint16_t addr, uint32_t length,
+                      uhf_spi_dump_sink_t sink, uintptr_t context)
+{
+    uhf_spi_dump_t dump;
+    uhf_spi_cmd_t cmd = { .callback = uhf_spi_dump_callback };
+    uint32_t requested = 0;
+    uint32_t delivered = 0;
+    uint16_t n;
+    uint8_t size;
+    bool more;
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+    const uint8_t *shadow;
+#endif
+
+    if ((sink == NULL) || (((uint32_t)addr + length) > 0x10000UL))
+    {
+        return 0;
+    }
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x03, g_rx_buf, 0x03);
+    dump.completed = 0;
+    cmd.id = (space == UHF_SPI_DUMP_SRAM) ? UHF_SPI_CMD_READ_SRAM : UHF_SPI_CMD_READ_EEPROM;
+    cmd.context = (uintptr_t)&dump;
+    while (delivered < length)
+    {
+        n = UHF_SPI_DUMP_CHUNK_LENGTH;
+        if ((length - delivered) < n)
+        {
+            n = (uint16_t)(length - delivered);
+        }
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+        /* Read the block, queueing as many reads as the queue takes */
+        while (dump.completed < (delivered + n))
+        {
+            while (requested < (delivered + n))
+            {
+                cmd.addr = addr + requested;
+                cmd.data = &dump.data[requested - delivered];
+                size = 1;
+                if (space == UHF_SPI_DUMP_SRAM)
+                {
+                    size = (uint8_t)((delivered + n) - requested);
+                }
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+                /* Taken from the shadow as long as no read is outstanding before it */
+                shadow = uhf_spi_shadow_find(&dev->shadow, cmd.addr);
+                if ((space == UHF_SPI_DUMP_EEPROM) && (dev->shadow.valid == true) && (shadow != NULL) &&
+                    (dump.completed == requested))
+                {
+                    *cmd.data = *shadow;
+                    dump.completed++;
+                    requested++;
+                    continue;
+                }
+#endif
+                cmd.length = size;
+                if (uhf_spi_submit(dev, &cmd) == false)
+                {
+                    break;
+                }
+                requested += size;
+            }
+            if (dump.completed < requested)
+            {
+                dump.progress = false;
+                uhf_spi_wait(&dump.progress);
+            }
+            else if (dump.completed < (delivered + n))
+            {
+                /* Queue full with commands of others */
+                uhf_spi_tasks(dev);
+            }
+        }
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+        /* The queue may have started a telegram of someone else behind the
+           last read; finish it and start no other, so CS is not held low
+           while the sink runs */
+        uhf_spi_hold(dev);
+        more = sink(space, (uint16_t)(addr + delivered), dump.data, n, context);
+        dev->hold = false;
+        delivered += n;
+        if (more == false)
+        {
+            break;
+        }
+    }
 
-    return g_rx_buf[2];
+    return delivered;
 }
 
-uint8_t uhf_spi_get_version_flash(uint8_t flash_version[], uint8_t *customer)
+bool uhf_spi_dump_buffer_sink(uhf_spi_dump_space_t space, uint16_t addr, const uint8_t *data, uint16_t length,
+                              uintptr_t context)
 {
-    uint8_t version = 0x00;
-    
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    uhf_spi_dump_buffer_t *buffer = (uhf_spi_dump_buffer_t *)context;
 
-    g_tx_buf[0] = UHF_SPI_CMD_GET_VERSION_FLASH;
-    memset(&g_tx_buf[1], 0x00, 0x05);
+    if ((buffer->size - buffer->length) < length)
+    {
+        length = (uint16_t)(buffer->size - buffer->length);
+    }
+    memcpy(&buffer->data[buffer->length], data, length);
+    buffer->length += length;
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x06, g_rx_buf, 0x06);
+    return (buffer->length < buffer->size);
+}
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+#if (UHF_SPI_REGMAP_ENABLE == 1)
+bool uhf_spi_regmap_init(uhf_dev_t *dev, const uhf_spi_reg_t *reg, uint8_t count)
+{
+    uhf_spi_regmap_t *map = &dev->regmap;
+    uint16_t used = 0;
+    uint8_t i;
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
-    /* 2 bytes of version */
-    version = g_rx_buf[2];
-    flash_version[0] = g_rx_buf[3];
-    flash_version[1] = g_rx_buf[4];
-    *customer = g_rx_buf[5];
-    
-    return version;
+    if ((reg == NULL) || (count == 0U) || (count > UHF_SPI_REGMAP_REGISTERS))
+    {
+        return false;
+    }
+    for (i = 0; i < count; i++)
+    {
+        if ((reg[i].size == 0U) || (reg[i].size > 4U) ||
+            ((i != 0U) && (reg[i].addr < (reg[i - 1U].addr + reg[i - 1U].size))))
+        {
+            return false;
+        }
+        used += reg[i].size;
+    }
+    if (used > UHF_SPI_REGMAP_SIZE)
+    {
+        return false;
+    }
+
+    memset(map, 0, sizeof(uhf_spi_regmap_t));
+    map->reg = reg;
+    map->count = count;
+    used = 0;
+    for (i = 0; i < count; i++)
+    {
+        map->offset[i] = used;
+        used += reg[i].size;
+    }
+
+    return true;
 }
 
-void uhf_spi_customer_conf_cmd(void)
+void uhf_spi_regmap_load(uhf_dev_t *dev)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
-    
-    g_tx_buf[0] = UHF_SPI_CMD_CUST_CONF;
-    g_tx_buf[1] = 0x00;
-    
-    UHF_SPI_TRANSFER(g_tx_buf, 0x02, g_rx_buf, 0x02);
+    uhf_spi_regmap_t *map = &dev->regmap;
+    uint8_t first = 0;
+    uint8_t i;
+
+    if (map->count == 0U)
+    {
+        return;
+    }
+
+    for (i = 1; i <= map->count; i++)
+    {
+        if ((i == map->count) || (uhf_spi_regmap_contiguous(map, first, i) == false))
+        {
+            uhf_spi_regmap_submit(dev, UHF_SPI_CMD_READ_SRAM, first, i - 1U);
+            first = i;
+        }
+    }
+    uhf_spi_regmap_wait(dev);
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
-    
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+    memset(map->dirty, 0, sizeof(map->dirty));
+    map->loaded = true;
 }
 
-void uhf_spi_system_reset(void)
+void uhf_spi_regmap_set(uhf_dev_t *dev, uint8_t index, uint32_t value)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
-    
-    g_tx_buf[0] = UHF_SPI_CMD_SYSTEM_RESET;
-    g_tx_buf[1] = 0x00;
-    
-    UHF_SPI_TRANSFER(g_tx_buf, 0x02, g_rx_buf, 0x02);
+    uhf_spi_regmap_t *map = &dev->regmap;
+    uint8_t *mirror;
+    uint8_t i;
+
+    if (index >= map->count)
+    {
+        return;
+    }
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+    mirror = &map->mirror[map->offset[index]];
+    for (i = 0; i < map->reg[index].size; i++)
+    {
+        if (mirror[i] != (uint8_t)value)
+        {
+            mirror[i] = (uint8_t)value;
+            map->dirty[index / 32U] |= (1UL << (index % 32U));
+        }
+        value >>= 8;
+    }
 }
 
-void uhf_spi_trigger_eeprom_secure_write(void)
+uint32_t uhf_spi_regmap_get(uhf_dev_t *dev, uint8_t index)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    const uhf_spi_regmap_t *map = &dev->regmap;
+    uint32_t value = 0;
+    uint8_t i;
 
-    g_tx_buf[0] = UHF_SPI_CMD_TRIG_EEPROM_SECURE_WRITE;
-    /* Trigger Sequence bytes: 0xAA, 0xCC, 0xF0 */
-    g_tx_buf[1] = 0xAA;
-    g_tx_buf[2] = 0xCC;
-    g_tx_buf[3] = 0xF0;
+    if (index >= map->count)
+    {
+        return 0;
+    }
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x04, g_rx_buf, 0x04);
+    for (i = map->reg[index].size; i != 0U; i--)
+    {
+        value = (value << 8) | map->mirror[map->offset[index] + i - 1U];
+    }
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
-    
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+    return value;
 }
 
-void uhf_spi_set_voltage_monitor(uint8_t reg_vmcsr)
+uint8_t uhf_spi_regmap_flush(uhf_dev_t *dev)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    uhf_spi_regmap_t *map = &dev->regmap;
+    uint8_t telegrams = 0;
+    uint8_t first;
+    uint8_t last;
+    uint8_t gap;
+    uint8_t i = 0;
+    uint8_t j;
+
+    while (i < map->count)
+    {
+        if (uhf_spi_regmap_dirty(map, i) == false)
+        {
+            i++;
+            continue;
+        }
 
-    g_tx_buf[0] = UHF_SPI_CMD_SET_VOLTAGE_MONITOR;
-    g_tx_buf[1] = reg_vmcsr;
+        /* Extend over the following contiguous registers, dirty ones and,
+           with a loaded mirror, a few clean bytes leading to another dirty one */
+        first = i;
+        last = i;
+        gap = 0;
+        for (j = i + 1U; (j < map->count) && (uhf_spi_regmap_contiguous(map, first, j) == true); j++)
+        {
+            if (uhf_spi_regmap_dirty(map, j) == true)
+            {
+                last = j;
+                gap = 0;
+            }
+            else
+            {
+                gap += map->reg[j].size;
+                if ((map->loaded == false) || (gap > UHF_SPI_REGMAP_MERGE_GAP))
+                {
+                    break;
+                }
+            }
+        }
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x02, g_rx_buf, 0x02);
+        uhf_spi_regmap_submit(dev, UHF_SPI_CMD_WRITE_SRAM, first, last);
+        telegrams++;
+        for (j = first; j <= last; j++)
+        {
+            map->dirty[j / 32U] &= ~(1UL << (j % 32U));
+        }
+        i = last + 1U;
+    }
+    uhf_spi_regmap_wait(dev);
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
-    
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+    return telegrams;
 }
+#endif
 
-void uhf_spi_off_command(void)
+uint8_t uhf_spi_read_eeprom(uhf_dev_t *dev, uint16_t addr)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    uint8_t value = 0;
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+    const uint8_t *shadow = uhf_spi_shadow_find(&dev->shadow, addr);
+
+    if ((dev->shadow.valid == true) && (shadow != NULL))
+    {
+        return *shadow;
+    }
+#endif
 
-    g_tx_buf[0] = UHF_SPI_CMD_OFF;
-    g_tx_buf[1] = 0;
+    uhf_spi_run_data(dev, UHF_SPI_CMD_READ_EEPROM, addr, &value, 1);
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x02, g_rx_buf, 0x02);
+    return value;
+}
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+void uhf_spi_write_tx_fifo(uhf_dev_t *dev, uint8_t *data, uint8_t length)
+{
+    uhf_spi_run_data(dev, UHF_SPI_CMD_WRITE_TX_FIFO, 0, data, length);
 }
 
-uint16_t uhf_spi_read_temperature_value(void)
+void uhf_spi_write_tx_preamble_fifo(uhf_dev_t *dev, uint8_t *data, uint8_t length)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    uhf_spi_run_data(dev, UHF_SPI_CMD_WRITE_TX_PREAMBLE_FIFO, 0, data, length);
+}
 
-    g_tx_buf[0] = UHF_SPI_CMD_READ_TEMP_VALUE;
-    /* 3 dummy bytes */
-    memset(&g_tx_buf[1], 0x00, 0x03);
+void uhf_spi_set_system_mode(uhf_dev_t *dev, uint8_t system_mode_config, uint8_t service_channel_config)
+{
+    uhf_spi_run_param(dev, UHF_SPI_CMD_SET_SYSTEM_MODE, system_mode_config, service_channel_config);
+}
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x04, g_rx_buf, 0x04);
+void uhf_spi_calibrate_and_check(uhf_dev_t *dev, uint8_t tune_check_config, uint8_t service_channel_config)
+{
+    uhf_spi_run_param(dev, UHF_SPI_CMD_CALIBRATE_AND_CHECK, tune_check_config, service_channel_config);
+}
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+void uhf_spi_patch_spi(uhf_dev_t *dev, uint8_t parameter)
+{
+    uhf_spi_run_param(dev, UHF_SPI_CMD_PATCH_SPI, parameter, 0);
+}
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+void uhf_spi_system_reset_ROM(uhf_dev_t *dev)
+{
+    uhf_spi_run_param(dev, UHF_SPI_CMD_SYSTEM_RESET_ROM, 0, 0);
+}
 
-    return (((uint16_t)g_rx_buf[2]) << 8) | (g_rx_buf[3]);
+uint8_t uhf_spi_get_version_ROM(uhf_dev_t *dev)
+{
+    return uhf_spi_run_byte(dev, UHF_SPI_CMD_GET_VERSION_ROM);
 }
 
-void uhf_spi_init_sram_service(uint8_t sram_service_nr, uint8_t eep_service_nr)
+uint8_t uhf_spi_get_version_flash(uhf_dev_t *dev, uint8_t flash_version[], uint8_t *customer)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    uint8_t version[4] = { 0 };
 
-    g_tx_buf[0] = UHF_SPI_CMD_INIT_SRAM_SERVICE;
-    g_tx_buf[1] = sram_service_nr;
-    g_tx_buf[2] = eep_service_nr;
+    uhf_spi_run_data(dev, UHF_SPI_CMD_GET_VERSION_FLASH, 0, version, 0);
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x03, g_rx_buf, 0x03);
+    /* 2 bytes of version */
+    flash_version[0] = version[1];
+    flash_version[1] = version[2];
+    *customer = version[3];
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+    return version[0];
+}
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+void uhf_spi_customer_conf_cmd(uhf_dev_t *dev)
+{
+    uhf_spi_run_param(dev, UHF_SPI_CMD_CUST_CONF, 0, 0);
 }
 
-void uhf_spi_start_rssi_meas(uint8_t service_channel_config)
+void uhf_spi_system_reset(uhf_dev_t *dev)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
-    
-    g_tx_buf[0] = UHF_SPI_CMD_START_RSSI_MEAS;
-    g_tx_buf[1] = service_channel_config;
+    uhf_spi_run_param(dev, UHF_SPI_CMD_SYSTEM_RESET, 0, 0);
+}
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x02, g_rx_buf, 0x02);
+void uhf_spi_trigger_eeprom_secure_write(uhf_dev_t *dev)
+{
+    uhf_spi_run_param(dev, UHF_SPI_CMD_TRIG_EEPROM_SECURE_WRITE, 0, 0);
+}
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
-    
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+void uhf_spi_set_voltage_monitor(uhf_dev_t *dev, uint8_t reg_vmcsr)
+{
+    uhf_spi_run_param(dev, UHF_SPI_CMD_SET_VOLTAGE_MONITOR, reg_vmcsr, 0);
 }
 
-uint16_t uhf_spi_get_rssi_value(void)
+void uhf_spi_off_command(uhf_dev_t *dev)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    uhf_spi_run_param(dev, UHF_SPI_CMD_OFF, 0, 0);
+}
 
-    g_tx_buf[0] = UHF_SPI_CMD_GET_RSSI_VALUE;
-    /* 3 dummy bytes */
-    memset(&g_tx_buf[1], 0x00, 0x03);
+uint16_t uhf_spi_read_temperature_value(uhf_dev_t *dev)
+{
+    uint8_t value[2] = { 0 };
 
-    UHF_SPI_TRANSFER(g_tx_buf, 0x04, g_rx_buf, 0x04);
+    uhf_spi_run_data(dev, UHF_SPI_CMD_READ_TEMP_VALUE, 0, value, 0);
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+    return (((uint16_t)value[0]) << 8) | (value[1]);
+}
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
+void uhf_spi_init_sram_service(uhf_dev_t *dev, uint8_t sram_service_nr, uint8_t eep_service_nr)
+{
+    uhf_spi_run_param(dev, UHF_SPI_CMD_INIT_SRAM_SERVICE, sram_service_nr, eep_service_nr);
+}
 
-    return (((uint16_t)g_rx_buf[2]) << 8) | (g_rx_buf[3]);
+void uhf_spi_start_rssi_meas(uhf_dev_t *dev, uint8_t service_channel_config)
+{
+    uhf_spi_run_param(dev, UHF_SPI_CMD_START_RSSI_MEAS, service_channel_config, 0);
 }
 
-void uhf_spi_read_rx_fifo_byte_int(uint8_t *data, uint8_t length)
+uint16_t uhf_spi_get_rssi_value(uhf_dev_t *dev)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    uint8_t value[2] = { 0 };
+
+    uhf_spi_run_data(dev, UHF_SPI_CMD_GET_RSSI_VALUE, 0, value, 0);
 
-    g_tx_buf[0] = UHF_SPI_CMD_READ_RX_BUFFER_BYTE_INT;
-    /* parameter step of 0x01 to continue reading depending on length */
-    memset(&g_tx_buf[1], 0x01, length - 1);
-    g_tx_buf[length] = 0x00;
-    g_tx_buf[length + 1] = 0x00;
+    return (((uint16_t)value[0]) << 8) | (value[1]);
+}
 
-    UHF_SPI_TRANSFER(g_tx_buf, length+2, g_rx_buf, length+2);
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+bool uhf_spi_rssi_survey_submit(uhf_dev_t *dev, uhf_spi_rssi_survey_t *survey)
+{
+    uhf_spi_survey_t *job = &dev->survey;
+    uhf_spi_rssi_channel_t *channel;
+    uint8_t i;
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+    if ((job->state != UHF_SPI_SURVEY_IDLE) || (survey == NULL) || (survey->channels == NULL) ||
+        (survey->count == 0U) || (survey->samples == 0U) || (survey->samples > UHF_SPI_RSSI_SURVEY_SAMPLES) ||
+        (survey->percentile == 0U) || (survey->percentile > 100U))
+    {
+        return false;
+    }
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
-    memcpy(data, &g_rx_buf[2], length);
+    for (i = 0; i < survey->count; i++)
+    {
+        channel = &survey->channels[i];
+        channel->min = 0;
+        channel->max = 0;
+        channel->percentile = 0;
+        channel->mean = 0;
+        channel->peak = 0;
+        channel->samples = 0;
+    }
+    survey->lost = 0;
+    survey->polls = 0;
+    survey->duration_us = 0;
+    survey->done = false;
+
+    memset(job, 0, sizeof(uhf_spi_survey_t));
+    job->survey = survey;
+    job->meas_timeout = SYS_TIME_USToCount(UHF_SPI_RSSI_TIMEOUT_US);
+    job->start = SYS_TIME_CounterGet();
+    uhf_spi_survey_start(dev);
+
+    return true;
 }
 
-void uhf_spi_read_rssi_fifo_byte_int(uint8_t *data, uint8_t length)
+bool uhf_spi_rssi_survey(uhf_dev_t *dev, uhf_spi_rssi_survey_t *survey)
 {
-    UHF_SPI_CS_ENABLE;
-    delay_us(UHF_SPI_T0);
-    delay_us(UHF_SPI_T1);
+    if (uhf_spi_rssi_survey_submit(dev, survey) == false)
+    {
+        return false;
+    }
 
-    g_tx_buf[0] = UHF_SPI_CMD_READ_RSSI_BUFFER_BYTE_INT;
-    /* parameter step of 0x01 to continue reading depending on length */
-    memset(&g_tx_buf[1], 0x01, length - 1);
-    g_tx_buf[length] = 0x00;
-    g_tx_buf[length + 1] = 0x00;
+    uhf_spi_wait(&survey->done);
 
-    UHF_SPI_TRANSFER(g_tx_buf, length+2, g_rx_buf, length+2);
+    return true;
+}
+#endif
 
-    delay_us(UHF_SPI_T4);
-    UHF_SPI_CS_DISABLE;
-    delay_us(UHF_SPI_T5);
+void uhf_spi_read_rx_fifo_byte_int(uhf_dev_t *dev, uint8_t *data, uint8_t length)
+{
+    uhf_spi_run_data(dev, UHF_SPI_CMD_READ_RX_BUFFER_BYTE_INT, 0, data, length);
+}
 
-    g_events.system = g_rx_buf[0];
-    g_events.trx = g_rx_buf[1];
-    memcpy(data, &g_rx_buf[2], length);
+void uhf_spi_read_rssi_fifo_byte_int(uhf_dev_t *dev, uint8_t *data, uint8_t length)
+{
+    uhf_spi_run_data(dev, UHF_SPI_CMD_READ_RSSI_BUFFER_BYTE_INT, 0, data, length);
 }
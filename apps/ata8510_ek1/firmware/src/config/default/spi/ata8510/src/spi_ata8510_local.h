@@ -65,35 +65,292 @@
 /* SPI buffer length */
 #define UHF_SPI_BUFFER_LENGTH 32
 
-/* SPI command IDs */
-#define UHF_SPI_CMD_READ_FILL_LEVEL_RX_FIFO     (0x01)
-#define UHF_SPI_CMD_READ_FILL_LEVEL_TX_FIFO     (0x02)
-#define UHF_SPI_CMD_READ_FILL_LEVEL_RSSI_FIFO   (0x03)
-#define UHF_SPI_CMD_GET_EVENT_BYTES             (0x04)
-#define UHF_SPI_CMD_READ_RSSI_FIFO              (0x05)
-#define UHF_SPI_CMD_READ_RX_FIFO                (0x06)
-#define UHF_SPI_CMD_WRITE_SRAM                  (0x07)
-#define UHF_SPI_CMD_READ_SRAM                   (0x08)
-#define UHF_SPI_CMD_WRITE_EEPROM                (0x09)
-#define UHF_SPI_CMD_READ_EEPROM                 (0x0A)
-#define UHF_SPI_CMD_WRITE_TX_FIFO               (0x0B)
-#define UHF_SPI_CMD_WRITE_TX_PREAMBLE_FIFO      (0x0C)
-#define UHF_SPI_CMD_SET_SYSTEM_MODE             (0x0D)
-#define UHF_SPI_CMD_CALIBRATE_AND_CHECK         (0x0E)
-#define UHF_SPI_CMD_PATCH_SPI                   (0x0F)
-#define UHF_SPI_CMD_SYSTEM_RESET_ROM            (0x10)
-#define UHF_SPI_CMD_GET_VERSION_ROM             (0x12)
-#define UHF_SPI_CMD_GET_VERSION_FLASH           (0x13)
-#define UHF_SPI_CMD_CUST_CONF                   (0x14)
-#define UHF_SPI_CMD_SYSTEM_RESET                (0x15)
-#define UHF_SPI_CMD_TRIG_EEPROM_SECURE_WRITE    (0x16)
-#define UHF_SPI_CMD_SET_VOLTAGE_MONITOR         (0x17)
-#define UHF_SPI_CMD_OFF                         (0x18)
-#define UHF_SPI_CMD_READ_TEMP_VALUE             (0x19)
-#define UHF_SPI_CMD_INIT_SRAM_SERVICE           (0x1A)
-#define UHF_SPI_CMD_START_RSSI_MEAS             (0x1B)
-#define UHF_SPI_CMD_GET_RSSI_VALUE              (0x1C)
-#define UHF_SPI_CMD_READ_RX_BUFFER_BYTE_INT     (0x1D)
-#define UHF_SPI_CMD_READ_RSSI_BUFFER_BYTE_INT   (0x1E)
+/* Transceiver data FIFO (DFIFO) bytes */
+#define UHF_SPI_DFIFO_SIZE 32
+
+/* Bytes of the scratch SRAM area used by the speed negotiation */
+#define UHF_SPI_SPEED_SCRATCH_LENGTH 4
+
+/* EEPROM secure write: SRAM staging area (address high, low, length, data)
+   and bytes programmed per trigger */
+#define UHF_SPI_EEPROM_STAGE_ADDR       (0x02E9)
+#define UHF_SPI_EEPROM_CHUNK_LENGTH     7
+
+#if (UHF_SPI_TRACE_ENABLE == 1) && ((UHF_SPI_TRACE_LENGTH & (UHF_SPI_TRACE_LENGTH - 1)) != 0)
+#error "UHF_SPI_TRACE_LENGTH must be a power of 2"
+#endif
+
+#if (UHF_SPI_DUMP_CHUNK_LENGTH < 1) || (UHF_SPI_DUMP_CHUNK_LENGTH > 255)
+#error "UHF_SPI_DUMP_CHUNK_LENGTH must be 1 to 255, the range of the Read SRAM length byte"
+#endif
+
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1) && ((UHF_SPI_RSSI_SURVEY_SAMPLES < 1) || (UHF_SPI_RSSI_SURVEY_SAMPLES > 255))
+#error "UHF_SPI_RSSI_SURVEY_SAMPLES must be 1 to 255"
+#endif
+
+/* Longest interval of the 16 bit one-shot guard timer at 48 MHz */
+#define UHF_SPI_GUARD_TIMER_MAX_US      1365
+
+#if (UHF_SPI_GUARD_TIMER_ENABLE == 1) && ((UHF_SPI_EEPROM_POLL_US < 1) || (UHF_SPI_EEPROM_POLL_US > UHF_SPI_GUARD_TIMER_MAX_US))
+#error "UHF_SPI_EEPROM_POLL_US must be 1 to 1365 with the guard timer"
+#endif
+
+#if (UHF_SPI_GUARD_TIMER_ENABLE == 1) && (UHF_SPI_RSSI_SURVEY_ENABLE == 1) && \
+    ((UHF_SPI_RSSI_POLL_US < 1) || (UHF_SPI_RSSI_POLL_US > UHF_SPI_GUARD_TIMER_MAX_US))
+#error "UHF_SPI_RSSI_POLL_US must be 1 to 1365 with the guard timer"
+#endif
+
+/* System mode configuration, operating mode field */
+#define UHF_SPI_OPM_MASK        (0x03)
+#define UHF_SPI_OPM_IDLE        (0x00)
+#define UHF_SPI_OPM_TX          (0x01)
+#define UHF_SPI_OPM_RX          (0x02)
+#define UHF_SPI_OPM_POLLING     (0x03)
+
+/* Event bytes */
+#define UHF_SPI_EVENT_SYS_ERR   (0x80)  // events.system
+#define UHF_SPI_EVENT_CMD_RDY   (0x40)  // events.system
+#define UHF_SPI_EVENT_SYS_RDY   (0x20)  // events.system
+#define UHF_SPI_EVENT_DFIFO     (0x02)  // events.system, DFIFO fill level reached
+#define UHF_SPI_EVENT_WCOKA     (0x40)  // events.trx
+#define UHF_SPI_EVENT_SOTA      (0x20)  // events.trx
+#define UHF_SPI_EVENT_EOTA      (0x10)  // events.trx
+#define UHF_SPI_EVENT_WCOKB     (0x04)  // events.trx
+#define UHF_SPI_EVENT_SOTB      (0x02)  // events.trx
+#define UHF_SPI_EVENT_EOTB      (0x01)  // events.trx
+
+/* Command descriptor flags */
+#define UHF_SPI_DESC_LENGTH     (0x01)  // length byte after the opcode
+#define UHF_SPI_DESC_ADDR       (0x02)  // address high and low byte
+#define UHF_SPI_DESC_READ       (0x04)  // payload clocked into the caller buffer
+#define UHF_SPI_DESC_WRITE      (0x08)  // payload clocked from the caller buffer
+#define UHF_SPI_DESC_KEY        (0x10)  // EEPROM secure write trigger sequence
+#define UHF_SPI_DESC_STEP       (0x20)  // byte-int read, one step byte per data byte
+#define UHF_SPI_DESC_NO_EVENTS  (0x40)  // status bytes are not the event bytes
+
+/* Telegram layout of one SPI command */
+typedef struct
+{
+    uint8_t             opcode;         // UHF_SPI_CMD_xxx, 0 for an unused entry
+    uint8_t             flags;          // UHF_SPI_DESC_xxx
+    uint8_t             params;         // bytes taken from the descriptor param[]
+    uint8_t             dummy;          // dummy bytes ending the header
+    uint8_t             rx_offset;      // position of the result in rx_buf
+    uint8_t             rx_length;      // result length (byte-int reads: data length)
+} uhf_spi_cmd_desc_t;
+
+/* Command state machine */
+typedef enum
+{
+    UHF_SPI_STATE_IDLE = 0,
+    UHF_SPI_STATE_CS_SETUP,         // CS low, waiting T0 + T1
+    UHF_SPI_STATE_TRANSFER,         // telegram on the bus
+    UHF_SPI_STATE_CS_HOLD,          // waiting T4 before CS high
+    UHF_SPI_STATE_CS_IDLE,          // CS high, waiting T5
+} uhf_spi_state_t;
+
+/* EEPROM programming job state machine */
+typedef enum
+{
+    UHF_SPI_EEPROM_JOB_IDLE = 0,
+    UHF_SPI_EEPROM_JOB_COMPARE,     // reading back the current content (differential mode)
+    UHF_SPI_EEPROM_JOB_STAGE,       // next chunk to be staged and triggered
+    UHF_SPI_EEPROM_JOB_TRIGGER,     // staging write and trigger queued
+    UHF_SPI_EEPROM_JOB_PROGRAM,     // chunk being programmed, waiting for CMD_RDY
+} uhf_spi_eeprom_job_state_t;
+
+/* EEPROM programming job, see uhf_spi_eeprom_write_submit() */
+typedef struct
+{
+    uhf_spi_eeprom_job_state_t state;
+    uhf_spi_eeprom_status_t status;
+    const uint8_t       *data;
+    uint16_t            addr;           // EEPROM address of data[0]
+    uint16_t            length;
+    bool                diff;           // skip bytes that already hold the data
+    uint16_t            offset;         // data index of the chunk in progress
+    uint8_t             chunk;          // bytes of the chunk in progress
+    uint8_t             stage[3 + UHF_SPI_EEPROM_CHUNK_LENGTH];
+    uint8_t             current[UHF_SPI_EEPROM_CHUNK_LENGTH];  // read-back from offset on
+    uint8_t             current_count;
+    uint8_t             reads_pending;
+    /* Report, times in SYS_TIME counts */
+    uint16_t            written;        // bytes programmed so far
+    uint16_t            skipped;        // bytes left alone, already up to date
+    uint16_t            chunks;
+    uint32_t            compare_start;
+    uint32_t            compare_time;
+    uint32_t            program_time;
+    bool                poll_armed;     // guard timer runs the poll interval
+    bool                poll_queued;    // status poll command in the queue
+    uint32_t            chunk_start;    // SYS_TIME counts at the trigger
+    uint32_t            chunk_timeout;
+    uhf_spi_eeprom_callback_t callback;
+    uintptr_t           context;
+} uhf_spi_eeprom_job_t;
+
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+/* RSSI survey state machine */
+typedef enum
+{
+    UHF_SPI_SURVEY_IDLE = 0,
+    UHF_SPI_SURVEY_START,           // "Start RSSI Measurement" to be queued
+    UHF_SPI_SURVEY_MEASURE,         // measurement running, polling the IRQ line
+    UHF_SPI_SURVEY_QUEUED,          // commands of the survey in the queue
+} uhf_spi_survey_state_t;
+
+/* RSSI survey, see uhf_spi_rssi_survey_submit() */
+typedef struct
+{
+    uhf_spi_survey_state_t state;
+    uhf_spi_rssi_survey_t *survey;
+    uint8_t             channel;        // index of the channel being measured
+    uint8_t             taken;          // samples taken on it
+    uint8_t             samples[UHF_SPI_RSSI_SURVEY_SAMPLES];   // RSSI averages of the channel
+    uint8_t             value[2];       // "Get RSSI Value" result, average and peak
+    uint8_t             events[4];      // event bytes read on an IRQ other than CMD_RDY
+    bool                ready;          // CMD_RDY seen in event bytes read on the way
+    bool                poll_armed;     // guard timer runs the poll interval
+    uint32_t            meas_start;     // SYS_TIME counts at the measurement start
+    uint32_t            meas_timeout;
+    uint32_t            start;          // SYS_TIME counts at the survey start
+} uhf_spi_survey_t;
+#endif
+
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+/* EEPROM range held by the shadow, sorted by address, neither overlapping
+   nor adjacent */
+typedef struct
+{
+    uint16_t            addr;
+    uint16_t            length;
+    uint16_t            offset;         // index of addr in data[]
+} uhf_spi_shadow_range_t;
+
+/* RAM copy of EEPROM ranges, see uhf_spi_eeprom_shadow_add() */
+typedef struct
+{
+    uhf_spi_shadow_range_t range[UHF_SPI_EEPROM_SHADOW_RANGES];
+    uint8_t             count;
+    uint16_t            used;           // bytes of data[] in use
+    bool                valid;          // data[] filled and coherent
+    uint16_t            checksum;       // Fletcher-16 of data[]
+    /* Verify pass, the read-back is folded into the sums in order */
+    uint8_t             scratch[UHF_SPI_QUEUE_LENGTH];
+    uint16_t            sum1;
+    uint16_t            sum2;
+    uint16_t            pending;        // reads not completed yet
+    volatile bool       done;           // a read has completed
+    uint8_t             data[UHF_SPI_EEPROM_SHADOW_SIZE];
+} uhf_spi_shadow_t;
+#endif
+
+/* Bulk dump in progress, see uhf_spi_dump() */
+typedef struct
+{
+    uint8_t             data[UHF_SPI_DUMP_CHUNK_LENGTH];
+    uint32_t            completed;      // bytes read, reads complete in order
+    volatile bool       progress;       // a read has completed
+} uhf_spi_dump_t;
+
+#if (UHF_SPI_REGMAP_ENABLE == 1)
+/* SRAM register map, see uhf_spi_regmap_init(). The mirror holds the
+   registers in table order, so address-contiguous registers are contiguous
+   in the mirror as well and go out as one payload. */
+typedef struct
+{
+    const uhf_spi_reg_t *reg;
+    uint8_t             count;
+    bool                loaded;         // mirror read from the transceiver
+    uint16_t            offset[UHF_SPI_REGMAP_REGISTERS];   // into mirror[]
+    uint32_t            dirty[(UHF_SPI_REGMAP_REGISTERS + 31U) / 32U];
+    uint8_t             mirror[UHF_SPI_REGMAP_SIZE];
+    uint8_t             pending;        // telegrams not completed yet
+    volatile bool       progress;       // a telegram has completed
+} uhf_spi_regmap_t;
+#endif
+
+/* Driver instance, one per transceiver */
+struct uhf_dev_t
+{
+    const uhf_spi_init_t *init;         // bus, timer and pin mapping, NULL if unused
+    uint8_t             tx_buf[UHF_SPI_BUFFER_LENGTH];
+    uint8_t             rx_buf[UHF_SPI_BUFFER_LENGTH];
+    events_struct_t     events;         // status bytes of the last command
+#if (UHF_SPI_DMA_ENABLE == 1)
+    /* Header and payload segments of the telegram in progress */
+    dmac_descriptor_registers_t tx_desc[2] __ALIGNED(16);
+    dmac_descriptor_registers_t rx_desc[2] __ALIGNED(16);
+    uint8_t             rx_discard;     // sink for the bytes received while a payload is written
+#endif
+    uhf_spi_state_t     state;
+    uhf_spi_cmd_t       queue[UHF_SPI_QUEUE_LENGTH];
+    uint8_t             queue_head;
+    uint8_t             queue_count;
+    bool                hold;           // no telegram is started, see uhf_spi_dump()
+    /* Telegram of the command in progress */
+    uint8_t             size;
+    uint8_t             rx_offset;
+    uint8_t             rx_length;
+    uint8_t             *payload;       // caller buffer clocked after the header
+    uint8_t             payload_length;
+    bool                payload_read;
+    bool                events_update;
+    volatile bool       transfer_done;
+    /* Guard time bookkeeping, in guard timer counts */
+    volatile bool       timer_expired;
+    uint32_t            timer_start;
+    uint32_t            timer_count;
+    uint32_t            count_setup;
+    uint32_t            count_setup_awake;
+    uint32_t            count_hold;
+    uint32_t            count_idle;
+    uint32_t            count_poll;
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+    uint32_t            count_rssi_poll;
+#endif
+    /* Transceiver wake state, derived from mode commands and event bytes */
+    uint8_t             opm;
+    bool                awake;
+    uint32_t            wake_paid;
+    uint32_t            wake_skipped;
+    /* SCK rate, index into the UHF_SPI_SPEED_LIST table */
+    uint8_t             speed_index;
+    uint8_t             speed_errors;   // consecutive failed status sanity checks
+    bool                speed_probe;    // negotiation running, no fallback
+    uint32_t            speed_fallbacks;
+#if (UHF_SPI_IRQ_EIC_ENABLE == 1)
+    /* Last falling IRQ edge, written by the EIC interrupt */
+    volatile uint32_t   irq_stamp;      // SYS_TIME counter at the edge
+    volatile bool       irq_pending;    // set by the edge, cleared by uhf_spi_irq_take()
+#endif
+    uhf_spi_eeprom_job_t eeprom_job;
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+    uhf_spi_survey_t    survey;
+#endif
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+    uhf_spi_shadow_t    shadow;
+#endif
+#if (UHF_SPI_REGMAP_ENABLE == 1)
+    uhf_spi_regmap_t    regmap;
+#endif
+#if (UHF_SPI_TRACE_ENABLE == 1)
+    /* Trace ring, the oldest record is overwritten */
+    uhf_spi_trace_t     trace[UHF_SPI_TRACE_LENGTH];
+    uint32_t            trace_count;    // records written since the last reset
+    uint32_t            trace_start;    // trace counter at CS assert
+#endif
+    /* Timing statistics, in SYS_TIME counts */
+    uint32_t            stat_start;
+    uint32_t            stat_mark;
+    uint32_t            stat_busy;
+    uint32_t            stat_commands;
+    uint32_t            stat_wall_last;
+    uint32_t            stat_busy_last;
+    uint32_t            stat_wall_max;
+    uint32_t            stat_busy_max;
+    uint64_t            stat_wall_total;
+    uint64_t            stat_busy_total;
+};
 
 #endif //#ifndef _SPI_ATA8510_LOCAL_H
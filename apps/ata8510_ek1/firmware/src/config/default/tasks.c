@@ -75,7 +75,7 @@ void SYS_Tasks ( void )
     
 
     /* Maintain Device Drivers */
-    
+    uhf_spi_tasks(sysObj.uhfSpi0);
 
     /* Maintain Middleware & Other Libraries */
     
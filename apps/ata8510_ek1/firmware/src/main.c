@@ -31,12 +31,14 @@
 #include <stdlib.h>                     // Defines EXIT_FAILURE
 #include <stdio.h>
 #include <oled/oled.h>
+#include <node/node_table.h>
 #include "definitions.h"                // SYS function prototypes
 
 #define RF_SENSORCHANNEL    0x40
 #define RF_NODATA           0x14
 #define RF_LOWBATT          0x19
 #define RF_TEMPDATA         0x64
+#define RF_TEMPDATA_ID      0x65    // temperature data with sensor ID
 #define RF_RSSIDATA         0x60
 
 #define RF_TXMODE           0x31
@@ -44,6 +46,21 @@
 #define RF_POLLINGMODE      0x23
 #define RF_TXSERVICE        0x40
 
+#define RF_EEPROM_SIZE      0x0400  // ATA8510 EEPROM bytes
+#define RF_EEPROM_DUMP      1       // holding button 3 dumps the ATA8510 EEPROM (UART only)
+#define RF_TEMPDATA_LENGTH  4       // code, temperature low / high, checksum
+#define RF_TEMPDATA_ID_LENGTH 6     // code, sensor ID low / high, temperature low / high, checksum
+#define RF_RSSI_AVERAGE     5       // RSSI samples averaged per telegram
+#define RF_BYTE_INT_LENGTH  30      // max. bytes of a byte-int FIFO read, see uhf_spi_drain_submit()
+#define RF_EOT_TIMEOUT_US   100000  // SOT seen, give up waiting for EOT
+#define RF_ACK_TX_TIMEOUT_US 30000  // acknowledge started, give up waiting for its EOT
+#define RF_REPLY_TIMEOUT_US 40000   // RX mode after the acknowledge, give up waiting for the sensor's reply
+#define RF_SURVEY_HOLD      10      // holding button 1 this many 100ms steps runs an RSSI survey
+#define RF_DUMP_HOLD        10      // holding button 3 this many 100ms steps runs the EEPROM dump
+#define RF_SURVEY_SAMPLES   16      // RSSI measurements per channel
+#define RF_SURVEY_PERCENTILE 90     // level exceeded 10% of the time
+#define RF_RING_LENGTH      4       // packet records between RF handling and presentation, power of 2
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Main Entry Point
@@ -78,7 +95,88 @@ union {
 
 // to keep track of the timer counter hit.
 volatile long unsigned int _timer_counter;
+// free running 10ms ticks, last-seen times of the node table
+volatile uint32_t rf_ticks = 0;
 struct rfstruct rf;
+// ATA8510 driver instance
+uhf_dev_t *rf_dev = NULL;
+// RX chain state: queued on IRQ, evaluated once its last command completed
+bool rf_rx_busy = false;
+volatile bool rf_rx_ready = false;
+uhf_spi_drain_t rf_drain;
+unsigned char rf_event[4];
+// cut-through: head read at SOT, acknowledge prepared in RAM, queued at EOT
+bool rf_rx_head = false;
+bool rf_ack_armed = false;
+uint8_t rf_rx_expect = 0;
+bool rf_ack_queued = false;
+uint8_t rf_ack_preamble = 0;
+// acknowledge TX FIFO / preamble writes and TX mode, built once by rf_ack_init()
+uhf_spi_cmd_t rf_ack_cmd[3];
+// RX -> ACK -> RX handshake, see rf_handshake_tasks()
+typedef enum
+{
+    RF_STATE_POLLING = 0,       // polling mode, RX chain queued on IRQ
+    RF_STATE_RX_DONE,           // telegram in RAM, evaluate and acknowledge
+    RF_STATE_ACK_TX,            // acknowledge on air, wait for its EOT
+    RF_STATE_WAIT_REPLY,        // RX mode, wait for the sensor's RSSI telegram
+    RF_STATE_COMMIT,            // hand the packet record over to the presentation
+    RF_STATE_IDLE,              // idle mode, polling mode again after 1ms
+} rf_state_t;
+typedef enum
+{
+    RF_REPORT_NONE = 0,
+    RF_REPORT_REPLY,            // reply in rf_packet_t.reply
+    RF_REPORT_NO_REPLY,
+    RF_REPORT_TX_ERROR,
+    RF_REPORT_WRONG_TELEGRAM,
+} rf_report_t;
+volatile rf_state_t rf_state = RF_STATE_POLLING;
+volatile bool rf_hs_done = true;    // last command chain of a handshake step completed
+uint32_t rf_hs_start = 0;           // SYS_TIME counter when the step started
+node_t *rf_hs_node = NULL;          // sensor of the handshake, NULL if not in the node table
+// packet record, filled by the RF handling and shown by rf_present_tasks()
+typedef struct
+{
+    uint32_t        stamp;                      // SYS_TIME counter at the IRQ of the sensor telegram
+    unsigned long   dtim;                       // time since the previous telegram, 10ms
+    rf_report_t     report;                     // outcome of the handshake
+    uint16_t        node;                       // sensor ID, 0 for RF_TEMPDATA
+    unsigned char   event[4];                   // event bytes of the sensor telegram
+    unsigned char   rx_buffer[32];              // sensor telegram
+    unsigned char   rssi_buffer[32];            // its RSSI samples
+    unsigned char   rx_len;
+    unsigned char   rssi_len;
+    unsigned char   reply[RF_TEMPDATA_LENGTH];  // sensor's RSSI telegram
+} rf_packet_t;
+#if ((RF_RING_LENGTH & (RF_RING_LENGTH - 1)) != 0) || (RF_RING_LENGTH > 128)
+#error "RF_RING_LENGTH must be a power of 2, 128 at most"
+#endif
+// single producer (RF handling) / single consumer (presentation) ring, free running indices
+rf_packet_t rf_ring[RF_RING_LENGTH];
+volatile uint8_t rf_ring_head = 0;          // written by the producer only
+volatile uint8_t rf_ring_tail = 0;          // written by the consumer only
+uint32_t rf_ring_overflows = 0;             // packets dropped on a full ring
+rf_packet_t *rf_packet = NULL;              // record being filled, NULL if dropped
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+// service 0 on path A, channels 0 - 3
+uhf_spi_rssi_channel_t rf_survey_channels[] = {
+    { .config = 0x40 }, { .config = 0x50 }, { .config = 0x60 }, { .config = 0x70 },
+};
+#endif
+// IRQ to RX / RSSI payload in RAM latency, SYS_TIME counts
+uint32_t rf_irq_stamp = 0;
+uint32_t rf_latency_last = 0;
+uint32_t rf_latency_max = 0;
+uint32_t rf_latency_count = 0;
+uint64_t rf_latency_total = 0;
+// IRQ edge to RX chain queued, SYS_TIME counts; without the EIC the stamp is taken here, so 0
+uint32_t rf_handler_last = 0;
+uint32_t rf_handler_max = 0;
+// EOT IRQ to TX mode set for the acknowledge, SYS_TIME counts
+uint32_t rf_eot_stamp = 0;
+uint32_t rf_turnaround_last = 0;
+uint32_t rf_turnaround_max = 0;
 
 /***********************************************************************************************************************
 * Function Name: cleaner()
@@ -92,6 +190,41 @@ void cleaner(void){
 }
 
 
+#if (RF_EEPROM_DUMP == 1)
+/***********************************************************************************************************************
+* Function Name: rf_dump_sink()
+* Description : prints a transceiver memory block on the UART, 16 bytes per line ("EEPROM 0000: 2A 07 ...");
+*               host_sim/tools/dump2eep.c turns the UART log into the programming_files .eep layout
+* Arguments : space: SRAM or EEPROM, addr: address of data[0], data: bytes read, length: their number,
+*             context: not used
+* Return Value : TRUE=go on with the dump
+***********************************************************************************************************************/
+static bool rf_dump_sink(uhf_spi_dump_space_t space, uint16_t addr, const uint8_t *data, uint16_t length, uintptr_t context)
+{
+    uint16_t i;
+    int n = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        if ((i == 0) || (((addr + i) % 16) == 0))
+        {
+            if (n != 0)
+            {
+                SERCOM4_USART_Write(&string[0], n);
+            }
+            n = sprintf(string, "\r\n%s %04X:", (space == UHF_SPI_DUMP_SRAM) ? "SRAM" : "EEPROM", addr + i);
+        }
+        n += sprintf(&string[n], " %02X", data[i]);
+    }
+    if (n != 0)
+    {
+        SERCOM4_USART_Write(&string[0], n);
+    }
+
+    return true;
+}
+#endif
+
 /***********************************************************************************************************************
 * Function Name: TC0_cb_InterruptHandler()
 * Description : Timer Counter 0 callback function
@@ -101,6 +234,7 @@ void cleaner(void){
 static void TC0_cb_InterruptHandler(TC_TIMER_STATUS status, uintptr_t context)
 {
     _timer_counter++;
+    rf_ticks++;
 }
 
 /***********************************************************************************************************************
@@ -113,7 +247,7 @@ static void TC2_cb_InterruptHandler(TC_TIMER_STATUS status, uintptr_t context)
 {
     static uint8_t cntr = 0;
     /*If RF Packet not received*/
-    if((ATA5831_IRQ_Get() == true) && (rf_packets_received == 0))
+    if((uhf_irq_get(rf_dev) == true) && (rf_packets_received == 0))
     {
         if(cntr == 0)
         {
@@ -187,6 +321,36 @@ uint8_t at_test_btn(uint8_t btn)
     return(true);
 }
 
+/***********************************************************************************************************************
+* Function Name:    rf_ack_init()
+* Description :     builds the acknowledge packet and its command descriptors once, so an RF_TEMPDATA telegram only
+*                   has to queue them
+* Arguments :       none
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_ack_init(void)
+{
+    uint8_t index;
+
+    for (index=0; index < 6; index++)rf.tx_buffer[index] = 0xFF;
+    rf.tx_buffer[6] =0xFE;          // end of tx preamble
+    rf.tx_buffer[7] = RF_RSSIDATA;
+    rf.tx_buffer[8] = RF_RSSIDATA;  // for checksum
+    rf.tx_len = 9;
+    rf_ack_preamble = 0;
+
+    memset(rf_ack_cmd, 0, sizeof(rf_ack_cmd));
+    rf_ack_cmd[0].id = UHF_SPI_CMD_WRITE_TX_FIFO;
+    rf_ack_cmd[0].data = &rf.tx_buffer[0];
+    rf_ack_cmd[0].length = rf.tx_len;
+    rf_ack_cmd[1].id = UHF_SPI_CMD_WRITE_TX_PREAMBLE_FIFO;
+    rf_ack_cmd[1].data = &rf_ack_preamble;
+    rf_ack_cmd[1].length = 1;
+    rf_ack_cmd[2].id = UHF_SPI_CMD_SET_SYSTEM_MODE;
+    rf_ack_cmd[2].param[0] = RF_TXMODE;
+    rf_ack_cmd[2].param[1] = RF_TXSERVICE;
+}
+
 /***********************************************************************************************************************
 * Function Name:    rf_ata5831_init()
 * Description :     initialization of ATA5831 device and rf structure.
@@ -214,14 +378,18 @@ void rf_ata5831_init(void)
     rf.rx_len = 0;
     rf.tx_len = 0;
     rf.rssi_len = 0;
+    rf_ack_init();
+
+    uhf_power_on(rf_dev);
 
-    uhf_power_on();
+    // raise the SPI clock as far as the transceiver reliably follows
+    uhf_spi_speed_negotiate(rf_dev);
 
     // read status to clear event
-    uhf_spi_get_event_bytes(&rf.event[0]);
+    uhf_spi_get_event_bytes(rf_dev, &rf.event[0]);
 
     // read ROM version
-    ver = uhf_spi_get_version_ROM();
+    ver = uhf_spi_get_version_ROM(rf_dev);
     rf.version[0] = ((ver & 0xF0) >> 4);
     rf.version[1] = (ver & 0x0F);
 
@@ -248,6 +416,890 @@ uint8_t checksum(uint8_t data[], uint8_t len)
     return (0xFF - sum + 1);
 }
 
+/***********************************************************************************************************************
+* Function Name:    rf_rx_latency()
+* Description :     records the IRQ to payload in RAM latency
+* Arguments :       none
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_rx_latency(void)
+{
+    rf_latency_last = SYS_TIME_CounterGet() - rf_irq_stamp;
+    if(rf_latency_last > rf_latency_max) rf_latency_max = rf_latency_last;
+    rf_latency_total += rf_latency_last;
+    rf_latency_count++;
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_rx_classify()
+* Description :     looks at the telegram type once the first byte is in and arms the acknowledge prepared by
+*                   rf_ack_init(), so it only has to be queued at EOT. The TX FIFO itself is not touched while
+*                   the telegram is still being received, RX and TX share the DFIFO.
+* Arguments :       none
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_rx_classify(void)
+{
+    if((rf.rx_len == 0) || (rf_ack_armed == true)) return;
+
+    if(rf.rx_buffer[0] == RF_TEMPDATA)
+    {
+        rf_rx_expect = RF_TEMPDATA_LENGTH;
+        rf_ack_armed = true;
+    }
+    else if(rf.rx_buffer[0] == RF_TEMPDATA_ID)
+    {
+        rf_rx_expect = RF_TEMPDATA_ID_LENGTH;
+        rf_ack_armed = true;
+    }
+    // RF_LOWBATT, RF_NODATA and unknown telegrams are not acknowledged
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_rx_done_cb()
+* Description :     completion callback of the last command of the RX chain
+* Arguments :       cmd: completed command, context: not used
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_rx_done_cb(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    rf_rx_ready = true;
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_rx_ack_cb()
+* Description :     completion callback of the TX mode command of an acknowledge queued by rf_rx_finish()
+* Arguments :       cmd: completed command, context: not used
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_rx_ack_cb(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    rf_turnaround_last = SYS_TIME_CounterGet() - rf_eot_stamp;
+    if(rf_turnaround_last > rf_turnaround_max) rf_turnaround_max = rf_turnaround_last;
+    rf_rx_ready = true;
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_ack_submit()
+* Description :     queues the acknowledge built by rf_ack_init(). Right after the read-out at EOT the transceiver
+*                   is still in RX with the AVR awake, so TX FIFO and preamble are staged without a T0 wake-up
+*                   and idle mode is set between them and TX mode.
+* Arguments :       idle: set idle mode before TX mode, callback: completion of TX mode
+* Return Value :    TRUE=queued, FALSE=queue full, nothing queued
+***********************************************************************************************************************/
+static bool rf_ack_submit(bool idle, uhf_spi_callback_t callback)
+{
+    const uhf_spi_cmd_t idle_mode = { .id = UHF_SPI_CMD_SET_SYSTEM_MODE, .param = { 0x00, 0x00 } };
+    uhf_spi_cmd_t chain[4];
+    uint8_t count = 0;
+
+    chain[count++] = rf_ack_cmd[0];
+    chain[count++] = rf_ack_cmd[1];
+    if(idle == true) chain[count++] = idle_mode;
+    chain[count] = rf_ack_cmd[2];
+    chain[count++].callback = callback;
+
+    // all or nothing, a half queued acknowledge would write the TX FIFO twice on the retry
+    return(uhf_spi_submit_chain(rf_dev, &chain[0], count));
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_rx_finish()
+* Description :     telegram complete in RAM: a valid telegram with an armed acknowledge gets it queued right here,
+*                   without a round trip through the main loop. Anything else only gets idle mode.
+* Arguments :       none
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_rx_finish(void)
+{
+    const uhf_spi_cmd_t idle = { .id = UHF_SPI_CMD_SET_SYSTEM_MODE, .param = { 0x00, 0x00 }, .callback = rf_rx_done_cb };
+
+    rf_rx_classify();
+    if((rf_ack_armed == true) && (rf.rx_len > 1) &&
+       (rf.rx_buffer[rf.rx_len - 1] == checksum(rf.rx_buffer, rf.rx_len - 1)))
+    {
+        // a full queue leaves the acknowledge to the main loop
+        rf_ack_queued = rf_ack_submit(true, rf_rx_ack_cb);
+        if(rf_ack_queued == true) return;
+    }
+    // set idle mode to clear status
+    if(uhf_spi_submit(rf_dev, &idle) == false) rf_rx_ready = true;
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_rx_tail_cb()
+* Description :     completion callback of the read-out after EOT, the payload is complete in RAM
+* Arguments :       cmd: completed command, context: not used
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_rx_tail_cb(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    rf.rx_len += rf_drain.rx_length;
+    rf.rssi_len += rf_drain.rssi_length;
+    rf_rx_latency();
+    rf_rx_finish();
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_rx_event_cb()
+* Description :     event bytes of the RX chain are in. SOT without EOT (SOT IRQ enabled in the transceiver EEPROM):
+*                   the header read so far is classified and the next IRQ, at EOT, continues the read-out.
+*                   EOT: whatever arrived after the FIFO read-out is picked up, then rf_rx_finish().
+* Arguments :       cmd: completed command, context: not used
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_rx_event_cb(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    bool tail;
+
+    // the SOT event and config byte came with the head, keep them for the evaluation at EOT
+    rf.event[0] = rf_event[0];
+    rf.event[1] |= rf_event[1];
+    rf.event[2] = rf_event[2];
+    if(rf_rx_head == false) rf.event[3] = rf_event[3];
+    tail = ((rf_drain.events.trx & 0x10) == 0) || (rf_drain.rx_length == RF_BYTE_INT_LENGTH);
+    rf.rx_len += rf_drain.rx_length;
+    rf.rssi_len += rf_drain.rssi_length;
+
+    if((rf_event[1] & 0x10) == 0)
+    {
+        // SOT: wait for the EOT IRQ
+        rf_rx_classify();
+        rf_rx_head = true;
+        rf_rx_busy = false;
+        return;
+    }
+
+    rf_rx_head = false;
+    rf_drain.byte_int = false;
+    if(tail == true)
+    {
+        // EOT came after the fill level was read or the byte-int read was cut short
+        rf_drain.rx_data = &rf.rx_buffer[rf.rx_len];
+        rf_drain.rx_size = sizeof(rf.rx_buffer) - rf.rx_len;
+        rf_drain.rssi_data = &rf.rssi_buffer[rf.rssi_len];
+        rf_drain.rssi_size = sizeof(rf.rssi_buffer) - rf.rssi_len;
+        if(uhf_spi_drain_submit(rf_dev, &rf_drain, rf_rx_tail_cb, (uintptr_t)NULL) == false) rf_rx_ready = true;
+        return;
+    }
+
+    rf_rx_latency();
+    rf_rx_finish();
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_rx_chain_submit()
+* Description :     queue RX FIFO, RSSI FIFO read-out and event bytes as one command chain. The FIFOs are drained
+*                   first so the payload is in RAM as early as possible; the event bytes read afterwards still
+*                   deliver the config byte and release the IRQ line. At SOT the FIFOs are read with the
+*                   byte-int commands and the bytes appended at EOT.
+* Arguments :       none
+* Return Value :    TRUE=chain queued, FALSE=queue full
+***********************************************************************************************************************/
+bool rf_rx_chain_submit(void)
+{
+    const uhf_spi_cmd_t events = { .id = UHF_SPI_CMD_GET_EVENT_BYTES, .data = &rf_event[0], .callback = rf_rx_event_cb };
+
+    rf_rx_ready = false;
+    if(rf_rx_head == false)
+    {
+        rf.rx_len = 0;
+        rf.rssi_len = 0;
+        memset(rf.event, 0, sizeof(rf.event));
+        rf_ack_armed = false;
+        rf_ack_queued = false;
+        rf_rx_expect = 0;
+    }
+    rf_drain.rx_data = &rf.rx_buffer[rf.rx_len];
+    rf_drain.rx_size = sizeof(rf.rx_buffer) - rf.rx_len;
+    rf_drain.rssi_data = &rf.rssi_buffer[rf.rssi_len];
+    rf_drain.rssi_size = sizeof(rf.rssi_buffer) - rf.rssi_len;
+    rf_drain.byte_int = true;
+    if((rf_rx_head == true) && (rf_rx_expect > rf.rx_len))
+    {
+        // the telegram type told the length, the tail is read without asking for the fill level
+        const uhf_spi_cmd_t tail = { .id = UHF_SPI_CMD_READ_RX_BUFFER_BYTE_INT, .data = rf_drain.rx_data,
+                                     .length = rf_rx_expect - rf.rx_len };
+
+        if(uhf_spi_submit(rf_dev, &tail) == false) return(false);
+        rf_drain.rx_data = NULL;
+        rf_drain.rx_length = tail.length;
+    }
+    if(uhf_spi_drain_submit(rf_dev, &rf_drain, NULL, (uintptr_t)NULL) == false) return(false);
+
+    return(uhf_spi_submit(rf_dev, &events));
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_ring_count()
+* Description :     number of packet records waiting for the presentation
+* Arguments :       none
+* Return Value :    records in the ring
+***********************************************************************************************************************/
+uint8_t rf_ring_count(void)
+{
+    return((uint8_t)(rf_ring_head - rf_ring_tail));
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_ring_reserve()
+* Description :     producer side: the next free record, filled in place and handed over by rf_ring_commit(). A full
+*                   ring drops the packet and counts the overflow.
+* Arguments :       none
+* Return Value :    record to fill, NULL if the ring is full
+***********************************************************************************************************************/
+static rf_packet_t *rf_ring_reserve(void)
+{
+    if(rf_ring_count() >= RF_RING_LENGTH)
+    {
+        rf_ring_overflows++;
+        return(NULL);
+    }
+
+    return(&rf_ring[rf_ring_head & (RF_RING_LENGTH - 1)]);
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_ring_commit()
+* Description :     producer side: publishes the record returned by rf_ring_reserve()
+* Arguments :       none
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_ring_commit(void)
+{
+    // the record is complete in RAM before the index hands it over
+    __DMB();
+    rf_ring_head++;
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_ring_peek()
+* Description :     consumer side: the oldest record, stays valid until rf_ring_release()
+* Arguments :       none
+* Return Value :    oldest record, NULL if the ring is empty
+***********************************************************************************************************************/
+static const rf_packet_t *rf_ring_peek(void)
+{
+    if(rf_ring_count() == 0) return(NULL);
+    // the index is read before the record it publishes
+    __DMB();
+
+    return(&rf_ring[rf_ring_tail & (RF_RING_LENGTH - 1)]);
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_ring_release()
+* Description :     consumer side: gives the record returned by rf_ring_peek() back to the producer
+* Arguments :       none
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_ring_release(void)
+{
+    // done reading the record before the producer may overwrite it
+    __DMB();
+    rf_ring_tail++;
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_hs_finish()
+* Description :     ends the handshake: counts errors and completes the packet record, which rf_handshake_tasks()
+*                   hands over to the presentation right before the receiver is re-armed
+* Arguments :       report: outcome of the handshake
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_hs_finish(rf_report_t report)
+{
+    // anything but sensor data in the reply is an error
+    if((report != RF_REPORT_REPLY) || (rf.rx_buffer[0] != RF_RSSIDATA))
+    {
+        // increase error message counter
+        err_count++;
+    }
+    if(rf_hs_node != NULL)
+    {
+        if(report == RF_REPORT_NO_REPLY) node_table_result(rf_hs_node, NODE_RESULT_ACK_MISS);
+        else if((report == RF_REPORT_REPLY) && (rf.rx_buffer[0] == RF_RSSIDATA)) node_table_result(rf_hs_node, NODE_RESULT_VALID);
+        else node_table_result(rf_hs_node, NODE_RESULT_ERROR);
+        rf_hs_node = NULL;
+    }
+    if(rf_packet != NULL)
+    {
+        rf_packet->report = report;
+        if(report == RF_REPORT_REPLY) memcpy(rf_packet->reply, rf.rx_buffer, sizeof(rf_packet->reply));
+    }
+    rf_state = RF_STATE_COMMIT;
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_hs_done_cb()
+* Description :     completion callback of the last command of a handshake step
+* Arguments :       cmd: completed command, context: not used
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_hs_done_cb(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    rf_hs_done = true;
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_hs_reply_cb()
+* Description :     completion callback of the read-out of the sensor's reply
+* Arguments :       cmd: completed command, context: not used
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_hs_reply_cb(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    rf.rx_len = rf_drain.rx_length;
+    rf.rssi_len = rf_drain.rssi_length;
+    rf_hs_finish(RF_REPORT_REPLY);
+    rf_hs_done = true;
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_hs_event_cb()
+* Description :     event bytes read on an IRQ during the handshake. With the SOT IRQ enabled the start of a
+*                   telegram raises the IRQ first and is skipped. EOT of the acknowledge switches to RX mode,
+*                   EOT of the reply reads it out, both queued right here.
+* Arguments :       cmd: completed command, context: not used
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_hs_event_cb(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    const uhf_spi_cmd_t rx[] =
+    {
+        // set idle mode to clear status, then start receive mode
+        { .id = UHF_SPI_CMD_SET_SYSTEM_MODE, .param = { 0x00, 0x00 } },
+        { .id = UHF_SPI_CMD_SET_SYSTEM_MODE, .param = { RF_RXMODE, RF_TXSERVICE }, .callback = rf_hs_done_cb },
+    };
+
+    if((rf.event[1] & 0x10) == 0)
+    {
+        rf_hs_done = true;
+    }
+    else if(rf_state == RF_STATE_ACK_TX)
+    {
+        rf_state = RF_STATE_WAIT_REPLY;
+        rf_hs_start = SYS_TIME_CounterGet();
+        if((uhf_spi_submit(rf_dev, &rx[0]) == false) || (uhf_spi_submit(rf_dev, &rx[1]) == false))
+        {
+            // the queue is drained before each step, not expected
+            rf_hs_done = true;
+        }
+    }
+    else
+    {
+        // RF answer received, read RX and RSSI buffer
+        rf_drain.rx_data = &rf.rx_buffer[0];
+        rf_drain.rx_size = sizeof(rf.rx_buffer);
+        rf_drain.rssi_data = &rf.rssi_buffer[0];
+        rf_drain.rssi_size = sizeof(rf.rssi_buffer);
+        rf_drain.byte_int = false;
+        if(uhf_spi_drain_submit(rf_dev, &rf_drain, rf_hs_reply_cb, (uintptr_t)NULL) == false) rf_hs_done = true;
+    }
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_hs_polling_cb()
+* Description :     polling mode is set again, the handshake is over
+* Arguments :       cmd: completed command, context: not used
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_hs_polling_cb(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    rf_rx_busy = false;
+    rf_hs_done = true;
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_sensor_decode()
+* Description :     sensor ID and temperature of a temperature telegram. RF_TEMPDATA carries no ID and is taken as
+*                   sensor 0.
+* Arguments :       telegram: RX buffer, length: its bytes, id / value: sensor ID and temperature in 0.1'C
+* Return Value :    TRUE=temperature telegram of the right length, FALSE=anything else
+***********************************************************************************************************************/
+static bool rf_sensor_decode(const unsigned char *telegram, uint8_t length, uint16_t *id, int16_t *value)
+{
+    if((telegram[0] == RF_TEMPDATA) && (length >= RF_TEMPDATA_LENGTH))
+    {
+        *id = 0;
+        *value = (int16_t)(telegram[1] | (telegram[2] << 8));
+        return(true);
+    }
+    if((telegram[0] == RF_TEMPDATA_ID) && (length >= RF_TEMPDATA_ID_LENGTH))
+    {
+        *id = (uint16_t)(telegram[1] | (telegram[2] << 8));
+        *value = (int16_t)(telegram[3] | (telegram[4] << 8));
+        return(true);
+    }
+
+    return(false);
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_rssi_average()
+* Description :     average of the first RF_RSSI_AVERAGE RSSI samples of a telegram
+* Arguments :       rssi: RSSI buffer, length: its samples
+* Return Value :    RSSI, 0 without samples
+***********************************************************************************************************************/
+static uint8_t rf_rssi_average(const unsigned char *rssi, uint8_t length)
+{
+    uint16_t sum = 0;
+    uint8_t index;
+
+    if(length > RF_RSSI_AVERAGE) length = RF_RSSI_AVERAGE;
+    if(length == 0) return(0);
+    for(index = 0; index < length; index++) sum += rssi[index];
+
+    return((uint8_t)(sum / length));
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_rx_evaluate()
+* Description :     RX_DONE: evaluates the telegram in RAM and copies it into a free packet record. Valid temperature
+*                   data is acknowledged, the acknowledge is normally already queued by rf_rx_finish(), and updates
+*                   the sensor's node. Anything else is reported or dropped.
+* Arguments :       none
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_rx_evaluate(void)
+{
+    uint16_t id = 0;
+    int16_t value = 0;
+    bool sensor;
+
+    rf_packet = NULL;
+    rf_hs_node = NULL;
+    // if WCO, SOT and EOT is set for path A, channel 0 and service 0 evaluate ...
+    if(((rf.event[1]&0x70) != 0x70) || (rf.event[3] != 0x40))
+    {
+        // not for this receiver, nothing shown
+        rf_state = RF_STATE_COMMIT;
+        return;
+    }
+
+    tot_count++;
+    rf_packet = rf_ring_reserve();
+    if(rf_packet != NULL)
+    {
+        rf_packet->stamp = rf_irq_stamp;
+        rf_packet->dtim = dtim;
+        rf_packet->report = RF_REPORT_NONE;
+        rf_packet->node = 0;
+        memcpy(rf_packet->event, rf.event, sizeof(rf_packet->event));
+        memcpy(rf_packet->rx_buffer, rf.rx_buffer, rf.rx_len);
+        memcpy(rf_packet->rssi_buffer, rf.rssi_buffer, rf.rssi_len);
+        rf_packet->rx_len = rf.rx_len;
+        rf_packet->rssi_len = rf.rssi_len;
+    }
+
+    // check received bytes with checksum and set err receive flag if wrong data, an EOT with an empty
+    // DFIFO leaves no checksum at all; if valid temperature data ...
+    sensor = rf_sensor_decode(rf.rx_buffer, rf.rx_len, &id, &value);
+    if((rf.rx_len <= 1) || (rf.rx_buffer[rf.rx_len - 1] != checksum(rf.rx_buffer, rf.rx_len - 1)) || (sensor == false))
+    {
+        rf_hs_finish(RF_REPORT_WRONG_TELEGRAM);
+        return;
+    }
+    msg_count++;
+    rf_hs_node = node_table_seen(id, rf_ticks);
+    if(rf_hs_node != NULL) node_table_sample(rf_hs_node, value, rf_rssi_average(rf.rssi_buffer, rf.rssi_len));
+    if(rf_packet != NULL) rf_packet->node = id;
+
+    rf_state = RF_STATE_ACK_TX;
+    rf_hs_start = SYS_TIME_CounterGet();
+    if(rf_ack_queued == false)
+    {
+        // the RX chain is complete, so the queue normally has room for the acknowledge; already in idle mode.
+        // Otherwise rf_handshake_tasks() retries until RF_ACK_TX_TIMEOUT_US.
+        rf_rx_classify();
+        rf_ack_queued = rf_ack_submit(false, rf_hs_done_cb);
+        if(rf_ack_queued == true) rf_hs_done = false;
+    }
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_present_tasks()
+* Description :     shows the oldest packet record on the OLED and the UART and releases it. Called while the
+*                   receiver is polling, so the blocking UART output never delays a telegram.
+* Arguments :       none
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_present_tasks(void)
+{
+    const rf_packet_t *packet = rf_ring_peek();
+    unsigned long dtim_shown;
+    uint16_t rssi;
+    uint8_t offset;
+    uint8_t dt;
+    char line[33];
+
+    if(packet == NULL) return;
+
+    switch(packet->report)
+    {
+        case RF_REPORT_REPLY:
+            if (packet->reply[0] == RF_RSSIDATA)
+            {
+                rssi = rf_rssi_average(packet->rssi_buffer, packet->rssi_len);
+                dtim_shown = packet->dtim;
+                if(dtim_shown > 99900L) dtim_shown = 99900L;
+                dt = (unsigned int) dtim_shown / 100L;
+                // show receive string
+                cleaner();
+
+                //convert received sensor data, the sensor ID comes first if there is one
+                offset = (packet->rx_buffer[0] == RF_TEMPDATA_ID) ? 3 : 1;
+                data.b[0] = packet->rx_buffer[offset];
+                data.b[1] = packet->rx_buffer[offset + 1];
+                if(data.i[0] & 0x00008000)
+                {
+                    data.i[0] |= 0xFFFF0000;
+                }
+                else
+                {
+                    data.i[0] &= 0x00007FFF;
+                }
+                if(offset == 3) sprintf(line, "          node=%5u           ", packet->node);
+                else sprintf(line, "                                ");
+                sprintf(string,"\r     dt=%3ds    rssi=%3d   \r\n%s\r\n          T=%3d'C            \r\n          RSSI=%3d         \r\n",
+                dt, rssi, line, data.i[0] / 10, packet->reply[2]);
+                oled_string(string, 0, 0);
+                SERCOM4_USART_Write(&string[0], sizeof(string));
+            }
+            // if no sensor data available ...
+            else if(packet->reply[0] == RF_NODATA)
+            {
+                cleaner();
+                sprintf(string,"!!!!!!!!!!!!!!!!!!!!!\r\n Sensor error:         \r\n Invalid sensor data! \r\n!!!!!!!!!!!!!!!!!!!!!\r\n");
+                oled_string(string, 0, 0);
+                SERCOM4_USART_Write(&string[0], sizeof(string));
+            }
+            // sensor has low battery voltage
+            else if(packet->reply[0] == RF_LOWBATT)
+            {
+                cleaner();
+                sprintf(string,"!!!!!!!!!!!!!!!!!!!!!\r\n Sensor error:         \r\n Low battery voltage! \r\n!!!!!!!!!!!!!!!!!!!!!\r\n");
+                oled_string(string, 0, 0);
+                SERCOM4_USART_Write(&string[0], sizeof(string));
+            }
+            else
+            {
+                cleaner();
+                sprintf(string,":::::::::::::::::::::\r\n RF telegram error:   \r\n Wrong ACK telegram!  \r\n:::::::::::::::::::::\r\n");
+                oled_string(string, 0, 0);
+                SERCOM4_USART_Write(&string[0], sizeof(string));
+            }
+            break;
+
+        case RF_REPORT_NO_REPLY:
+            cleaner();
+            sprintf(string,"::::::::::::::::::::::\r\n RF telegram error:  \r\n No RF ACK telegram!   \r\n:::::::::::::::::::::\r\n");
+            oled_string(string, 0, 0);
+            SERCOM4_USART_Write(&string[0], sizeof(string));
+            break;
+
+        case RF_REPORT_TX_ERROR:
+            cleaner();
+            sprintf(string,":::::::::::::::::::::\r\n RF channel error:   \r\n RF TX telegram err!  \r\n:::::::::::::::::::::\r\n");
+            oled_string(string, 0, 0);
+            SERCOM4_USART_Write(&string[0], sizeof(string));
+            break;
+
+        case RF_REPORT_WRONG_TELEGRAM:
+            cleaner();
+            sprintf(string,":::::::::::::::::::::\r\n RF channel error:  \r\n Wrong ACK telegram! \r\n:::::::::::::::::::::\r\n");
+            oled_string(string, 0, 0);
+            SERCOM4_USART_Write(&string[0], sizeof(string));
+            break;
+
+        default:
+            break;
+    }
+    rf_ring_release();
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_nodes_print()
+* Description :     prints the node table statistics and one line per sensor node: ID, last temperature, RSSI
+*                   average, valid / error / ACK-miss counts, inter-arrival time average / min / max and the time
+*                   since it was last heard, all times in 10ms ticks
+* Arguments :       none
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_nodes_print(void)
+{
+    node_table_stats_t stats;
+    const node_t *node;
+    uint32_t now = rf_ticks;
+    uint16_t index;
+
+    node_table_stats_get(&stats);
+    sprintf(string,"\rnodes %u evictions %lu\r\nprobes avg/max %lu.%02lu/%u\r\n", stats.nodes,
+    (unsigned long)stats.evictions,
+    (unsigned long)((stats.lookups != 0) ? stats.probes / stats.lookups : 0),
+    (unsigned long)((stats.lookups != 0) ? ((stats.probes % stats.lookups) * 100) / stats.lookups : 0),
+    stats.probes_max);
+    SERCOM4_USART_Write(&string[0], strlen(string));
+    for(index = 0; index < NODE_TABLE_CAPACITY; index++)
+    {
+        node = node_table_at(index);
+        if(node == NULL) continue;
+        sprintf(string,"\rnode %5u T=%4d rssi=%3u ok/err/miss %u/%u/%u gap %u/%u/%u age %lu\r\n",
+        node->id, node->value, (node->rssi_ewma + 0x80) >> 8, node->valid, node->errors, node->ack_misses,
+        node->gap_ewma, node->gap_min, node->gap_max, (unsigned long)(now - node->last_seen));
+        SERCOM4_USART_Write(&string[0], strlen(string));
+    }
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_rx_tasks()
+* Description :     POLLING: queues the RX chain on an IRQ and hands the telegram over to rf_handshake_tasks() once
+*                   the chain completed. A head read at SOT without its EOT is dropped after RF_EOT_TIMEOUT_US.
+* Arguments :       none
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_rx_tasks(void)
+{
+#if (UHF_SPI_IRQ_EIC_ENABLE == 1)
+    uint32_t irq_edge = 0;
+    bool irq_posted;
+#endif
+
+    if(rf_state != RF_STATE_POLLING) return;
+
+    if((rf_rx_busy == false) && (uhf_irq_get(rf_dev) == false))
+    {
+        /*To stop blink the RF wait dots */
+        rf_packets_received = 1;
+        // the IRQ of the last RX chain is the EOT
+        rf_eot_stamp = SYS_TIME_CounterGet();
+#if (UHF_SPI_IRQ_EIC_ENABLE == 1)
+        // edge posted by the EIC interrupt, stamped when it happened
+        irq_posted = uhf_spi_irq_take(rf_dev, &irq_edge);
+        if(irq_posted == true) rf_eot_stamp = irq_edge;
+#endif
+        if(rf_rx_head == false)
+        {
+            // read and set current timer value = 0
+            dtim = at_read_timer();
+            rf_irq_stamp = rf_eot_stamp;
+            rf_handler_last = SYS_TIME_CounterGet() - rf_irq_stamp;
+            if(rf_handler_last > rf_handler_max) rf_handler_max = rf_handler_last;
+        }
+
+        // queue RX / RSSI FIFO read-out and event read; buttons stay serviced meanwhile
+        rf_rx_busy = rf_rx_chain_submit();
+    }
+    else if((rf_rx_busy == false) && (rf_rx_head == true) &&
+            (SYS_TIME_CountToUS(SYS_TIME_CounterGet() - rf_irq_stamp) > RF_EOT_TIMEOUT_US))
+    {
+        // SOT without EOT, dropped by rf_rx_evaluate() as a broken telegram
+        rf_rx_head = false;
+        rf_rx_busy = true;
+        rf_rx_ready = true;
+    }
+    else if(rf_rx_ready == true)
+    {
+        // RX chain complete, rf_handshake_tasks() takes over
+        rf_rx_ready = false;
+        rf_rx_head = false;
+        rf_state = RF_STATE_RX_DONE;
+    }
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_handshake_tasks()
+* Description :     RX -> ACK -> RX handshake, one step per main loop pass. IRQ events are picked up as soon as the
+*                   line goes low, the waits for the acknowledge EOT and the reply end on SYS_TIME timeouts.
+*                   Steps that only move on when a command chain completes are taken in its callback.
+* Arguments :       none
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_handshake_tasks(void)
+{
+    const uhf_spi_cmd_t events = { .id = UHF_SPI_CMD_GET_EVENT_BYTES, .data = &rf.event[0], .callback = rf_hs_event_cb };
+    const uhf_spi_cmd_t idle = { .id = UHF_SPI_CMD_SET_SYSTEM_MODE, .param = { 0x00, 0x00 }, .callback = rf_hs_done_cb };
+    const uhf_spi_cmd_t polling = { .id = UHF_SPI_CMD_SET_SYSTEM_MODE, .param = { RF_POLLINGMODE, 0x00 },
+                                    .callback = rf_hs_polling_cb };
+    uint32_t elapsed = SYS_TIME_CountToUS(SYS_TIME_CounterGet() - rf_hs_start);
+
+    if(rf_hs_done == false) return;
+
+    switch(rf_state)
+    {
+        case RF_STATE_RX_DONE:
+            rf_rx_evaluate();
+            break;
+
+        case RF_STATE_ACK_TX:
+        case RF_STATE_WAIT_REPLY:
+            if((rf_state == RF_STATE_ACK_TX) && (rf_ack_queued == false))
+            {
+                // acknowledge not queued yet by rf_rx_evaluate()
+                rf_ack_queued = rf_ack_submit(false, rf_hs_done_cb);
+                if(rf_ack_queued == true) rf_hs_done = false;
+                else if(elapsed > RF_ACK_TX_TIMEOUT_US) rf_hs_finish(RF_REPORT_TX_ERROR);
+            }
+            else if(uhf_irq_get(rf_dev) == false)
+            {
+                // a full queue is retried on the next pass
+                if(uhf_spi_submit(rf_dev, &events) == true) rf_hs_done = false;
+            }
+            else if(elapsed > ((rf_state == RF_STATE_ACK_TX) ? RF_ACK_TX_TIMEOUT_US : RF_REPLY_TIMEOUT_US))
+            {
+                rf_hs_finish((rf_state == RF_STATE_ACK_TX) ? RF_REPORT_TX_ERROR : RF_REPORT_NO_REPLY);
+            }
+            break;
+
+        case RF_STATE_COMMIT:
+            // switch transceiver into idle mode, polling mode 1ms later; a full queue is retried on the next pass
+            if(uhf_spi_submit(rf_dev, &idle) == false) break;
+            // the record goes to the presentation, the receiver is re-armed without waiting for it
+            if(rf_packet != NULL) rf_ring_commit();
+            rf_packet = NULL;
+            rf_state = RF_STATE_IDLE;
+            rf_hs_start = SYS_TIME_CounterGet();
+            rf_hs_done = false;
+            break;
+
+        case RF_STATE_IDLE:
+            if((elapsed >= 1000) && (uhf_spi_submit(rf_dev, &polling) == true))
+            {
+                rf_state = RF_STATE_POLLING;
+                rf_hs_done = false;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_wait_ms()
+* Description :     waits while a button is held, reception, handshake and the SPI queue keep going. Packet records
+*                   pile up in the ring and are shown once the button is released.
+* Arguments :       ms: time to wait
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_wait_ms(uint32_t ms)
+{
+    uint32_t start = SYS_TIME_CounterGet();
+
+    while(SYS_TIME_CountToMS(SYS_TIME_CounterGet() - start) < ms)
+    {
+        rf_rx_tasks();
+        rf_handshake_tasks();
+        SYS_Tasks();
+    }
+}
+
+/***********************************************************************************************************************
+* Function Name:    rf_sleep_allowed()
+* Description :     tells whether the RF handling waits for an interrupt only: IRQ edge, SPI command completion or
+*                   the TC0 tick for the timeouts. Called with interrupts disabled.
+* Arguments :       none
+* Return Value :    TRUE=nothing to do until the next interrupt
+***********************************************************************************************************************/
+static bool rf_sleep_allowed(void)
+{
+    bool waiting;
+
+    switch(rf_state)
+    {
+        case RF_STATE_POLLING:
+            waiting = (rf_rx_ready == false) && ((rf_rx_busy == true) ||
+                      ((uhf_irq_get(rf_dev) == true) && (rf_ring_count() == 0)));
+            break;
+
+        case RF_STATE_ACK_TX:
+        case RF_STATE_WAIT_REPLY:
+            waiting = (rf_hs_done == false) || (uhf_irq_get(rf_dev) == true);
+            break;
+
+        default:
+            // evaluation, hand-over and the 1ms in idle mode run without a wake-up source
+            waiting = false;
+            break;
+    }
+
+    return(waiting && uhf_spi_sleep_allowed(rf_dev));
+}
+
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+/***********************************************************************************************************************
+* Function Name:    rf_survey()
+* Description :     measures the RSSI of all rf_survey_channels in idle mode, lists the statistics on the UART and
+*                   draws the mean of each channel as a bar on the OLED, the cleanest channel (lowest percentile)
+*                   with a marker line above it.
+* Arguments :       none
+* Return Value :    none
+***********************************************************************************************************************/
+static void rf_survey(void)
+{
+    uhf_spi_rssi_survey_t survey = {
+        .channels = rf_survey_channels,
+        .count = sizeof(rf_survey_channels) / sizeof(rf_survey_channels[0]),
+        .samples = RF_SURVEY_SAMPLES,
+        .percentile = RF_SURVEY_PERCENTILE,
+    };
+    uhf_spi_rssi_channel_t *channel;
+    uint8_t best = 0;
+    uint8_t width;
+    uint8_t height;
+    uint8_t index;
+    uint8_t x;
+    uint32_t column;
+    char px[4];
+    int n;
+
+    uhf_spi_set_system_mode(rf_dev, 0x00, 0x00);
+    if(uhf_spi_rssi_survey(rf_dev, &survey) == false) return;
+    // the last CMD_RDY still holds the IRQ line
+    uhf_spi_get_event_bytes(rf_dev, &rf_event[0]);
+
+    n = sprintf(string, "\r\nRSSI survey, %u samples per channel, P%u\r\n", survey.samples, survey.percentile);
+    SERCOM4_USART_Write(&string[0], n);
+    for(index = 0; index < survey.count; index++)
+    {
+        channel = &rf_survey_channels[index];
+        if(channel->percentile < rf_survey_channels[best].percentile) best = index;
+        // mean in 8.8 fixed point, two decimals
+        n = sprintf(string, "0x%02X min %3u mean %3u.%02u P%u %3u max %3u peak %3u\r\n",
+        channel->config, channel->min, channel->mean >> 8, ((channel->mean & 0xFF) * 100U) >> 8,
+        survey.percentile, channel->percentile, channel->max, channel->peak);
+        SERCOM4_USART_Write(&string[0], n);
+    }
+    n = sprintf(string, "cleanest 0x%02X, %lu us per sample, lost %u\r\n", rf_survey_channels[best].config,
+    (unsigned long)(survey.duration_us / ((uint32_t)survey.count * survey.samples)), survey.lost);
+    SERCOM4_USART_Write(&string[0], n);
+
+    // bar graph, 128 x 32 pixels, LSB of a page is its top row
+    cleaner();
+    width = 128 / survey.count;
+    for(index = 0; index < survey.count; index++)
+    {
+        channel = &rf_survey_channels[index];
+        height = (uint8_t)((channel->mean >> 11) + 1);
+        if(height > 30) height = 30;
+        column = 0xFFFFFFFFUL << (32 - height);
+        if(index == best) column |= 0x01;
+        px[0] = (char)column;
+        px[1] = (char)(column >> 8);
+        px[2] = (char)(column >> 16);
+        px[3] = (char)(column >> 24);
+        for(x = 1; x < (width - 1); x++)
+        {
+            oled_pixel(px, (uint8_t)(index * width + x));
+        }
+    }
+
+    // back to listening
+    delay_ms(1);
+    uhf_spi_set_system_mode(rf_dev, RF_POLLINGMODE, 0x00);
+}
+#endif
+
 /***********************************************************************************************************************
 * Function Name: main()
 * Description : main function
@@ -256,13 +1308,15 @@ uint8_t checksum(uint8_t data[], uint8_t len)
 ***********************************************************************************************************************/
 int main ( void )
 {
-    uint16_t timeout = 0;
-    uint16_t rssi = 0;
-    uint8_t dt = 0;
-    uint8_t index = 0;
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1) || (RF_EEPROM_DUMP == 1)
+    uint8_t hold = 0;
+#endif
+    uhf_spi_stats_t spi_stats;
     /* Initialize all modules */
     SYS_Initialize ( NULL );
+    rf_dev = sysObj.uhfSpi0;
     oled_init();
+    node_table_init();
     /* Initialize ATA5831 transceiver */
     rf_ata5831_init();
     sprintf(string,"\rATA8510-EK1 Demo Kit \r\n(c)2022 Microchip V4.0\r\nwaiting for RF signal \r\n.....       \r\n");
@@ -276,7 +1330,7 @@ int main ( void )
     OLED_LED3_Set();
 
     // switch transceiver into polling mode
-    uhf_spi_set_system_mode(RF_POLLINGMODE, 0x00);
+    uhf_spi_set_system_mode(rf_dev, RF_POLLINGMODE, 0x00);
     delay_us(200);
 
     TC0_TimerCallbackRegister(TC0_cb_InterruptHandler, (uintptr_t)NULL);
@@ -290,173 +1344,14 @@ int main ( void )
 
     while ( true )
     {
-        if(ATA5831_IRQ_Get() == false)
-        {
-            /*To stop blink the RF wait dots */
-            rf_packets_received = 1;
-            // read and set current timer value = 0
-            dtim = at_read_timer();
-
-            // read status to clear event
-            uhf_spi_get_event_bytes(&rf.event[0]);
+        // RF reception, acknowledge and reply, ahead of the buttons so an IRQ is picked up first
+        rf_rx_tasks();
+        rf_handshake_tasks();
 
-            // if WCO, SOT and EOT is set for path A, channel 0 and service 0 evaluate ...
-            if(((rf.event[1]&0x70) == 0x70) && (rf.event[3] == 0x40))
-            {
-                // read RX buffer
-                rf.rx_len = uhf_spi_read_fill_level_rx_fifo();
-                uhf_spi_read_rx_fifo(&rf.rx_buffer[0], rf.rx_len);
-                // read RSSI buffer
-                rf.rssi_len= uhf_spi_read_fill_level_rssi_fifo();
-                uhf_spi_read_rssi_fifo(&rf.rssi_buffer[0], rf.rssi_len);
-                // set idle mode to clear status
-                uhf_spi_set_system_mode(0x00, 0x00);
-                // evaluate data
-                rssi = 0;
-                if(rf.rssi_len > 5) rf.rssi_len = 5;
-                for(index = 0; index < rf.rssi_len; index++) rssi += rf.rssi_buffer[index];
-                rssi /= rf.rssi_len;
-                tot_count++;
-                // check received bytes with checksum and set err receive flag if wrong data
-                if(rf.rx_buffer[rf.rx_len - 1] != checksum(rf.rx_buffer, rf.rx_len - 1))
-                    rf.rx_buffer[0] = RF_NODATA;
-
-                // if valid temperature data ...
-                if(rf.rx_buffer[0] == RF_TEMPDATA)
-                {
-                    //convert received sensor data
-                    data.b[0] = rf.rx_buffer[1];
-                    data.b[1] = rf.rx_buffer[2];
-                    msg_count++;
-
-                    // prepare acknowledge packet
-                    // set TX buffer and start tx for acknowledge
-                    for (index=0; index < 6; index++)rf.tx_buffer[index] = 0xFF;
-                    rf.tx_buffer[6] =0xFE;          // end of tx preamble
-                    rf.tx_buffer[7] = RF_RSSIDATA;
-                    rf.tx_buffer[8] = RF_RSSIDATA;  // for checksum
-                    uhf_spi_write_tx_fifo(&rf.tx_buffer[0], 9);
-                    rf.rssi_buffer[0] = 0;
-                    uhf_spi_write_tx_preamble_fifo(&rf.rssi_buffer[0], 1);
-                    uhf_spi_set_system_mode(RF_TXMODE, RF_TXSERVICE);
-                    timeout=0;
-                    do
-                    {
-                        timeout++;
-                        delay_us(100);
-                    } while((ATA5831_IRQ_Get() != 0) && (timeout < 300));
-                    uhf_spi_get_event_bytes(&rf.event[0]);
-                    // set idle mode to clear status
-                    uhf_spi_set_system_mode(0x00, 0x00);
-
-                    if(timeout < 300)
-                    {
-                        //start receive mode
-                        uhf_spi_set_system_mode(RF_RXMODE, RF_TXSERVICE);
-                        timeout=0;
-                        do
-                        {
-                            timeout++;
-                            delay_us(100);
-                        } while((ATA5831_IRQ_Get() != 0) && (timeout < 400));
-                        uhf_spi_get_event_bytes(&rf.event[0]);
-
-                        if(timeout < 400)
-                        {
-                            // RF answer received
-                            // read RX buffer
-                            rf.rx_len = uhf_spi_read_fill_level_rx_fifo();
-                            uhf_spi_read_rx_fifo(&rf.rx_buffer[0], rf.rx_len);
-                            // read RSSI buffer
-                            rf.rssi_len= uhf_spi_read_fill_level_rssi_fifo();
-                            uhf_spi_read_rssi_fifo(&rf.rssi_buffer[0], rf.rssi_len);
-
-                            if (rf.rx_buffer[0] == RF_RSSIDATA)
-                            {
-                                if(dtim > 99900L) dtim = 99900L;
-                                dt = (unsigned int) dtim / 100L;
-                                // show receive string
-                                cleaner();
-
-                                if(data.i[0] & 0x00008000)
-                                {    
-                                    data.i[0] |= 0xFFFF0000;
-                                }
-                                else
-                                {
-                                    data.i[0] &= 0x00007FFF;
-                                }
-                                sprintf(string,"\r     dt=%3ds    rssi=%3d   \r\n                                \r\n          T=%3d'C            \r\n          RSSI=%3d         \r\n",
-                                dt, rssi, data.i[0] / 10, rf.rx_buffer[2]);
-                                oled_string(string, 0, 0);
-                                SERCOM4_USART_Write(&string[0], sizeof(string));
-                            }
-                            // if no sensor data available ...
-                            else if(rf.rx_buffer[0] == RF_NODATA)
-                            {
-                                cleaner();
-                                sprintf(string,"!!!!!!!!!!!!!!!!!!!!!\r\n Sensor error:         \r\n Invalid sensor data! \r\n!!!!!!!!!!!!!!!!!!!!!\r\n");
-                                oled_string(string, 0, 0);
-                                SERCOM4_USART_Write(&string[0], sizeof(string));
-                                // increase error message counter
-                                err_count++;
-                            }
-                            // sensor has low battery voltage
-                            else if(rf.rx_buffer[0] == RF_LOWBATT)
-                            {
-                                cleaner();
-                                sprintf(string,"!!!!!!!!!!!!!!!!!!!!!\r\n Sensor error:         \r\n Low battery voltage! \r\n!!!!!!!!!!!!!!!!!!!!!\r\n");
-                                oled_string(string, 0, 0);
-                                SERCOM4_USART_Write(&string[0], sizeof(string));
-                                // increase error message counter
-                                err_count++;
-                            }
-                            else
-                            {
-                                cleaner();
-                                sprintf(string,":::::::::::::::::::::\r\n RF telegram error:   \r\n Wrong ACK telegram!  \r\n:::::::::::::::::::::\r\n");
-                                oled_string(string, 0, 0);
-                                SERCOM4_USART_Write(&string[0], sizeof(string));
-                                // increase error message counter
-                                err_count++;
-                            }
-                        }
-                        else
-                        {
-                            cleaner();
-                            sprintf(string,"::::::::::::::::::::::\r\n RF telegram error:  \r\n No RF ACK telegram!   \r\n:::::::::::::::::::::\r\n");
-                            oled_string(string, 0, 0);
-                            SERCOM4_USART_Write(&string[0], sizeof(string));
-                            // increase error message counter
-                            err_count++;
-                        }
-                    }
-                    else
-                    {
-                        cleaner();
-                        sprintf(string,":::::::::::::::::::::\r\n RF channel error:   \r\n RF TX telegram err!  \r\n:::::::::::::::::::::\r\n");
-                        oled_string(string, 0, 0);
-                        SERCOM4_USART_Write(&string[0], sizeof(string));
-                        // increase error message counter
-                        err_count++;
-                    }
-                }
-                else
-                {
-                    cleaner();
-                    sprintf(string,":::::::::::::::::::::\r\n RF channel error:  \r\n Wrong ACK telegram! \r\n:::::::::::::::::::::\r\n");
-                    oled_string(string, 0, 0);
-                    SERCOM4_USART_Write(&string[0], sizeof(string));
-                    // increase error message counter
-                    err_count++;
-                }
-            }
-            // switch transceiver into idle mode
-            uhf_spi_set_system_mode(0x00, 0x00);
-            // wait for 1ms after idle mode
-            delay_ms(1);
-            // switch transceiver into polling mode
-            uhf_spi_set_system_mode(RF_POLLINGMODE, 0x00);
+        // received packets, shown while the receiver is polling
+        if((rf_state == RF_STATE_POLLING) && (rf_rx_busy == false) && (rf_ring_count() != 0))
+        {
+            rf_present_tasks();
         }
         // check for button1 event
         else if(at_test_btn(OLED_BTN1_PIN))
@@ -471,10 +1366,24 @@ int main ( void )
             sprintf(string,"\rRF-Channel 433.92MHz \r\nData Rate 8kBit/s       \r\nFSK deviation +/-8kHz \r\nManchester Coding     \r\n");
             oled_string(string, 0, 0);
             SERCOM4_USART_Write(&string[0], sizeof(string));
-            // check if button is released
+            // check if button is released, a long press runs the RSSI survey
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+            hold = 0;
+#endif
             while(at_test_btn(OLED_BTN1_PIN))
             {
-                delay_ms(100);
+                rf_wait_ms(100);
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+                // not while a telegram is being handled (SOT to the end of the handshake), the survey changes
+                // the system mode; a long press waits for the receiver to be polling again, one survey per press
+                if(hold < RF_SURVEY_HOLD) hold++;
+                if((hold == RF_SURVEY_HOLD) && (rf_rx_busy == false) && (rf_rx_head == false) &&
+                   (rf_state == RF_STATE_POLLING))
+                {
+                    hold++;
+                    rf_survey();
+                }
+#endif
             }
         }
         // check for button2 event
@@ -493,7 +1402,7 @@ int main ( void )
             // check if button is released
             while(at_test_btn( OLED_BTN2_PIN ))
             {
-                delay_ms(100);
+                rf_wait_ms(100);
             }
         }
         // check for button3 event
@@ -509,15 +1418,75 @@ int main ( void )
             sprintf(string,"\rReceiver statistics:  \r\nvalid# %10d    \r\nerror# %10d    \r\ntotal# %10d    \r\n",msg_count,err_count,tot_count);
             oled_string(string, 0, 0);
             SERCOM4_USART_Write(&string[0], sizeof(string));
-            // check if button is released
+            // SPI command timing (UART only)
+            uhf_spi_stats_get(rf_dev, &spi_stats);
+            sprintf(string,"\rSPI commands# %10lu  \r\nwall avg/max %5lu/%5lu us\r\nbusy avg/max %5lu/%5lu us\r\nT0 paid/skipped %lu/%lu\r\n",
+            (unsigned long)spi_stats.commands, (unsigned long)spi_stats.wall_avg, (unsigned long)spi_stats.wall_max,
+            (unsigned long)spi_stats.busy_avg, (unsigned long)spi_stats.busy_max,
+            (unsigned long)spi_stats.wake_paid, (unsigned long)spi_stats.wake_skipped);
+            SERCOM4_USART_Write(&string[0], sizeof(string));
+            sprintf(string,"\rSPI clock %7lu Hz\r\nSPI clock fallbacks %lu\r\n",
+            (unsigned long)spi_stats.speed, (unsigned long)spi_stats.speed_fallbacks);
+            SERCOM4_USART_Write(&string[0], sizeof(string));
+            // IRQ to payload in RAM latency (UART only)
+            sprintf(string,"\rIRQ->payload last %5lu us\r\nIRQ->payload avg  %5lu us\r\nIRQ->payload max  %5lu us\r\n",
+            (unsigned long)SYS_TIME_CountToUS(rf_latency_last),
+            (unsigned long)((rf_latency_count != 0) ? SYS_TIME_CountToUS((uint32_t)(rf_latency_total / rf_latency_count)) : 0),
+            (unsigned long)SYS_TIME_CountToUS(rf_latency_max));
+            SERCOM4_USART_Write(&string[0], sizeof(string));
+            sprintf(string,"\rIRQ->handler last %5lu us\r\nIRQ->handler max  %5lu us\r\nring overflows %lu\r\n",
+            (unsigned long)SYS_TIME_CountToUS(rf_handler_last), (unsigned long)SYS_TIME_CountToUS(rf_handler_max),
+            (unsigned long)rf_ring_overflows);
+            SERCOM4_USART_Write(&string[0], sizeof(string));
+            sprintf(string,"\rEOT->ACK last %5lu us\r\nEOT->ACK max  %5lu us\r\n",
+            (unsigned long)SYS_TIME_CountToUS(rf_turnaround_last), (unsigned long)SYS_TIME_CountToUS(rf_turnaround_max));
+            SERCOM4_USART_Write(&string[0], sizeof(string));
+            // sensor nodes (UART only)
+            rf_nodes_print();
+#if (UHF_SPI_TRACE_ENABLE == 1)
+            // last SPI telegrams (UART only)
+            uhf_spi_trace_dump(rf_dev);
+#endif
+            // check if button is released, a long press dumps the EEPROM
+#if (RF_EEPROM_DUMP == 1)
+            hold = 0;
+#endif
             while(at_test_btn(OLED_BTN3_PIN))
             {
-                delay_ms(100);
+                rf_wait_ms(100);
+#if (RF_EEPROM_DUMP == 1)
+                // the dump blocks the RF handling for about 2s, not while a telegram is being handled;
+                // one dump per press
+                if(hold < RF_DUMP_HOLD) hold++;
+                if((hold == RF_DUMP_HOLD) && (rf_rx_busy == false) && (rf_rx_head == false) &&
+                   (rf_state == RF_STATE_POLLING))
+                {
+                    hold++;
+                    // ATA8510 EEPROM image (UART only)
+                    sprintf(string, "\r\nEEPROM dump:");
+                    SERCOM4_USART_Write(&string[0], strlen(string));
+                    sprintf(string, "\r\nEEPROM dump end, %lu bytes\r\n",
+                    (unsigned long)uhf_spi_dump(rf_dev, UHF_SPI_DUMP_EEPROM, 0x0000, RF_EEPROM_SIZE, rf_dump_sink, 0));
+                    SERCOM4_USART_Write(&string[0], strlen(string));
+                }
+#endif
             }
         }
 
         /* Maintain state machines of all polled MPLAB Harmony modules. */
         SYS_Tasks();
+
+#if (UHF_SPI_IRQ_EIC_ENABLE == 1)
+        // sleep (IDLE) until the next interrupt: IRQ edge (EIC), SPI DMA or guard
+        // timer, TC0 tick for the buttons and the timeouts. Checked with
+        // interrupts masked so an edge right before WFI still wakes it.
+        __disable_irq();
+        if(rf_sleep_allowed() == true)
+        {
+            __WFI();
+        }
+        __enable_irq();
+#endif
     }
 
     /* Execution should not come here during normal operation */
@@ -0,0 +1,340 @@
+/***********************************************************************************************************************
+* Copyright (c) 2022 Microchip Corporation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+* following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+*    disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+*    following disclaimer in the documentation and/or other materials provided with the distribution.
+*
+* 3. The name of Microchip may not be used to endorse or promote products derived from this software without specific
+*    prior written permission.
+*
+* 4. This software may only be redistributed and used in connection with an Microchip microcontroller product.
+*
+* THIS SOFTWARE IS PROVIDED BY Microchip "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE EXPRESSLY AND
+* SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+* OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+***********************************************************************************************************************/
+
+/***********************************************************************************************************************
+* File Name    : (node_table.c)
+* Version      : (v1.0)
+* Device(s)    : (SAMC21)
+* OS           : (none)
+* H/W Platform : (ATA8510-EK1)
+* Description  : (Sensor node table: two-choice bucketed hashing in static RAM, bounded probes, LRU eviction)
+***********************************************************************************************************************/
+
+
+#include <string.h>
+#include "node_table.h"
+
+static node_t node_table[NODE_TABLE_CAPACITY];
+static node_table_stats_t node_stats;
+
+#define NODE_BUCKETS            (NODE_TABLE_CAPACITY >> NODE_BUCKET_BITS)
+#define NODE_BUCKETS_BITS       (NODE_TABLE_BITS - NODE_BUCKET_BITS)
+
+/**
+ * \brief First bucket of a sensor ID, Fibonacci hashing: the top bits of
+ * id * 2^16 / golden ratio spread consecutive IDs over the whole table.
+ */
+static uint16_t node_hash1(uint16_t id)
+{
+    return (uint16_t)((uint16_t)(id * 40503U) >> (16 - NODE_BUCKETS_BITS));
+}
+
+/**
+ * \brief Second bucket, from the ID mixed with xorshift steps so it does not
+ * follow the first one. Never the first bucket.
+ */
+static uint16_t node_hash2(uint16_t id, uint16_t first)
+{
+    uint16_t x = id;
+    uint16_t bucket;
+
+    x ^= (uint16_t)(x >> 7);
+    x = (uint16_t)(x * 0x2F6BU);
+    x ^= (uint16_t)(x >> 8);
+    bucket = (uint16_t)((uint16_t)(x * 40503U) >> (16 - NODE_BUCKETS_BITS));
+
+    return (bucket != first) ? bucket : (uint16_t)(first ^ 1U);
+}
+
+/**
+ * \brief Weighted moving average, new samples weighted 1 / 2^NODE_EWMA_SHIFT.
+ */
+static uint16_t node_ewma(uint16_t average, uint16_t sample)
+{
+    uint32_t sum = ((uint32_t)average << NODE_EWMA_SHIFT) - average + sample;
+
+    return (uint16_t)((sum + (1U << (NODE_EWMA_SHIFT - 1))) >> NODE_EWMA_SHIFT);
+}
+
+static void node_count(uint16_t *counter)
+{
+    if (*counter != 0xFFFF)
+    {
+        (*counter)++;
+    }
+}
+
+/**
+ * \brief Looks at the two buckets of a sensor ID, two-choice hashing: a new
+ * sensor goes to the bucket with fewer nodes, which keeps both buckets below
+ * NODE_BUCKET_SIZE nodes for 256 sensors. Nodes are never removed, only
+ * replaced in place, so a bucket fills from its first slot on and a free
+ * slot ends the search in that bucket.
+ *
+ * \param[in]  id      Sensor ID
+ * \param[in]  now     Time, to find the least recently seen node
+ * \param[out] slot    Free slot of the emptier bucket, or the least recently
+ *                     seen node of both if they are full
+ *
+ * \return The node of id, NULL if it is not in the table.
+ */
+static node_t *node_probe(uint16_t id, uint32_t now, node_t **slot)
+{
+    uint16_t bucket[2];
+    uint8_t fill[2];
+    node_t *free_slot[2];
+    node_t *oldest = NULL;
+    node_t *found = NULL;
+    node_t *node;
+    uint8_t probes = 0;
+    uint8_t choice;
+    uint8_t index;
+
+    bucket[0] = node_hash1(id);
+    bucket[1] = node_hash2(id, bucket[0]);
+    for (choice = 0; (choice < 2) && (found == NULL); choice++)
+    {
+        fill[choice] = NODE_BUCKET_SIZE;
+        free_slot[choice] = NULL;
+        for (index = 0; index < NODE_BUCKET_SIZE; index++)
+        {
+            node = &node_table[(bucket[choice] << NODE_BUCKET_BITS) + index];
+            probes++;
+            if (node->id == id)
+            {
+                found = node;
+                break;
+            }
+            if (node->id == NODE_ID_NONE)
+            {
+                fill[choice] = index;
+                free_slot[choice] = node;
+                break;
+            }
+            if ((oldest == NULL) || ((now - node->last_seen) > (now - oldest->last_seen)))
+            {
+                oldest = node;
+            }
+        }
+    }
+
+    node_stats.lookups++;
+    node_stats.probes += probes;
+    if (probes > node_stats.probes_max)
+    {
+        node_stats.probes_max = probes;
+    }
+
+    if (found == NULL)
+    {
+        if ((free_slot[0] != NULL) && (fill[0] <= fill[1]))
+        {
+            *slot = free_slot[0];
+        }
+        else if (free_slot[1] != NULL)
+        {
+            *slot = free_slot[1];
+        }
+        else
+        {
+            *slot = oldest;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * \brief Empties the table and clears the statistics.
+ */
+void node_table_init(void)
+{
+    uint16_t index;
+
+    memset(node_table, 0, sizeof(node_table));
+    for (index = 0; index < NODE_TABLE_CAPACITY; index++)
+    {
+        node_table[index].id = NODE_ID_NONE;
+    }
+    memset(&node_stats, 0, sizeof(node_stats));
+}
+
+/**
+ * \brief Looks a sensor up, at most NODE_TABLE_PROBES slots.
+ *
+ * \param[in] id       Sensor ID
+ *
+ * \return The node, NULL if the sensor is not in the table.
+ */
+node_t *node_table_find(uint16_t id)
+{
+    node_t *slot;
+
+    if (id == NODE_ID_NONE)
+    {
+        return NULL;
+    }
+
+    return node_probe(id, 0, &slot);
+}
+
+/**
+ * \brief A telegram of a sensor has been received: looks the sensor up or
+ * adds it, and updates last-seen time and inter-arrival statistics. A new
+ * sensor whose buckets are both full replaces the node of the two that has
+ * not been heard of for the longest time.
+ *
+ * \param[in] id       Sensor ID, not NODE_ID_NONE
+ * \param[in] now      Time of the telegram, 10ms ticks
+ *
+ * \return The node, NULL for NODE_ID_NONE.
+ */
+node_t *node_table_seen(uint16_t id, uint32_t now)
+{
+    node_t *node;
+    node_t *slot;
+    uint32_t gap;
+
+    if (id == NODE_ID_NONE)
+    {
+        return NULL;
+    }
+
+    node = node_probe(id, now, &slot);
+    if (node == NULL)
+    {
+        node = slot;
+        if (node->id != NODE_ID_NONE)
+        {
+            node_stats.evictions++;
+            node_stats.nodes--;
+        }
+        memset(node, 0, sizeof(*node));
+        node->id = id;
+        node->last_seen = now;
+        node->gap_ewma = NODE_GAP_NONE;
+        node->gap_min = NODE_GAP_NONE;
+        node_stats.nodes++;
+        return node;
+    }
+
+    gap = now - node->last_seen;
+    if (gap > (NODE_GAP_NONE - 1U))
+    {
+        gap = NODE_GAP_NONE - 1U;
+    }
+    if (node->gap_min == NODE_GAP_NONE)
+    {
+        node->gap_ewma = (uint16_t)gap;
+        node->gap_min = (uint16_t)gap;
+        node->gap_max = (uint16_t)gap;
+    }
+    else
+    {
+        node->gap_ewma = node_ewma(node->gap_ewma, (uint16_t)gap);
+        if (gap < node->gap_min)
+        {
+            node->gap_min = (uint16_t)gap;
+        }
+        if (gap > node->gap_max)
+        {
+            node->gap_max = (uint16_t)gap;
+        }
+    }
+    node->last_seen = now;
+
+    return node;
+}
+
+/**
+ * \brief Stores the sensor value and adds the RSSI to its average.
+ *
+ * \param[in] node     Node returned by node_table_seen()
+ * \param[in] value    Temperature, 0.1'C
+ * \param[in] rssi     RSSI of the telegram
+ */
+void node_table_sample(node_t *node, int16_t value, uint8_t rssi)
+{
+    node->value = value;
+    if (node->rssi_ewma == 0)
+    {
+        node->rssi_ewma = (uint16_t)rssi << 8;
+    }
+    else
+    {
+        node->rssi_ewma = node_ewma(node->rssi_ewma, (uint16_t)rssi << 8);
+    }
+}
+
+/**
+ * \brief Counts the outcome of a handshake with the sensor.
+ *
+ * \param[in] node     Node returned by node_table_seen()
+ * \param[in] result   Outcome
+ */
+void node_table_result(node_t *node, node_result_t result)
+{
+    switch (result)
+    {
+        case NODE_RESULT_VALID:
+            node_count(&node->valid);
+            break;
+
+        case NODE_RESULT_ERROR:
+            node_count(&node->errors);
+            break;
+
+        case NODE_RESULT_ACK_MISS:
+            node_count(&node->ack_misses);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * \brief Walks the table, for listings.
+ *
+ * \param[in] index    Slot, 0 to NODE_TABLE_CAPACITY - 1
+ *
+ * \return The node in that slot, NULL if it is free.
+ */
+const node_t *node_table_at(uint16_t index)
+{
+    if ((index >= NODE_TABLE_CAPACITY) || (node_table[index].id == NODE_ID_NONE))
+    {
+        return NULL;
+    }
+
+    return &node_table[index];
+}
+
+void node_table_stats_get(node_table_stats_t *stats)
+{
+    *stats = node_stats;
+}
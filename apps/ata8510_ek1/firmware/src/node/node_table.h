@@ -0,0 +1,94 @@
+/***********************************************************************************************************************
+* Copyright (c) 2022 Microchip Corporation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+* following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+*    disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+*    following disclaimer in the documentation and/or other materials provided with the distribution.
+*
+* 3. The name of Microchip may not be used to endorse or promote products derived from this software without specific
+*    prior written permission.
+*
+* 4. This software may only be redistributed and used in connection with an Microchip microcontroller product.
+*
+* THIS SOFTWARE IS PROVIDED BY Microchip "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE EXPRESSLY AND
+* SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+* OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+***********************************************************************************************************************/
+
+/***********************************************************************************************************************
+* File Name    : (node_table.h)
+* Version      : (v1.0)
+* Device(s)    : (SAMC21)
+* OS           : (none)
+* H/W Platform : (ATA8510-EK1)
+* Description  : (Declaration header file for the sensor node table)
+***********************************************************************************************************************/
+
+
+
+#ifndef NODE_TABLE_H
+#define NODE_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define NODE_TABLE_BITS         9                           // 512 entries, room for 256 sensors at half load
+#define NODE_TABLE_CAPACITY     (1U << NODE_TABLE_BITS)
+#define NODE_BUCKET_BITS        3                           // 8 entries per bucket, 64 buckets
+#define NODE_BUCKET_SIZE        (1U << NODE_BUCKET_BITS)
+#define NODE_TABLE_PROBES       (2U * NODE_BUCKET_SIZE)     // slots a lookup looks at, at most: both buckets
+#define NODE_ID_NONE            0xFFFF                      // free slot
+#define NODE_EWMA_SHIFT         3                           // new samples weighted 1/8
+#define NODE_GAP_NONE           0xFFFF                      // no inter-arrival time yet
+
+// Outcome of a handshake, counted by node_table_result()
+typedef enum
+{
+    NODE_RESULT_VALID = 0,      // sensor data acknowledged and answered
+    NODE_RESULT_ERROR,          // sensor error or wrong reply
+    NODE_RESULT_ACK_MISS,       // acknowledge sent, no reply
+} node_result_t;
+
+// One sensor. Times in 10ms ticks, counters saturate.
+typedef struct
+{
+    uint16_t    id;             // sensor ID, NODE_ID_NONE for a free slot
+    int16_t     value;          // last temperature, 0.1'C
+    uint32_t    last_seen;      // time of the last telegram
+    uint16_t    rssi_ewma;      // RSSI average, 8.8 fixed point
+    uint16_t    valid;
+    uint16_t    errors;
+    uint16_t    ack_misses;
+    uint16_t    gap_ewma;       // inter-arrival time average, saturating at 0xFFFE
+    uint16_t    gap_min;        // NODE_GAP_NONE until the second telegram
+    uint16_t    gap_max;
+} node_t;
+
+typedef struct
+{
+    uint16_t    nodes;          // entries in use
+    uint32_t    lookups;
+    uint32_t    probes;         // slots looked at by all lookups
+    uint8_t     probes_max;     // by a single lookup, NODE_TABLE_PROBES at most
+    uint32_t    evictions;      // nodes dropped for a new one
+} node_table_stats_t;
+
+void node_table_init(void);
+node_t *node_table_find(uint16_t id);
+node_t *node_table_seen(uint16_t id, uint32_t now);
+void node_table_sample(node_t *node, int16_t value, uint8_t rssi);
+void node_table_result(node_t *node, node_result_t result);
+const node_t *node_table_at(uint16_t index);
+void node_table_stats_get(node_table_stats_t *stats);
+
+#endif
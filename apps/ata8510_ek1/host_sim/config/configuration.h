@@ -0,0 +1,117 @@
+/*******************************************************************************
+  System Configuration Header
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    configuration.h
+
+  Summary:
+    Host simulator build-time configuration header
+
+  Description:
+    Driver options of the ATA8510 host build. Mirrors the driver section of
+    firmware/src/config/default/configuration.h, with polled SERCOM transfers
+    since DMAC descriptors hold 32-bit addresses.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+* 
+* The software and documentation is provided by microchip and its contributors
+* "as is" and any express, implied or statutory warranties, including, but not
+* limited to, the implied warranties of merchantability, fitness for a particular
+* purpose and non-infringement of third party intellectual property rights are
+* disclaimed to the fullest extent permitted by law. In no event shall microchip
+* or its contributors be liable for any direct, indirect, incidental, special,
+* exemplary, or consequential damages (including, but not limited to, procurement
+* of substitute goods or services; loss of use, data, or profits; or business
+* interruption) however caused and on any theory of liability, whether in contract,
+* strict liability, or tort (including negligence or otherwise) arising in any way
+* out of the use of the software and documentation, even if advised of the
+* possibility of such damage.
+* 
+* Except as expressly permitted hereunder and subject to the applicable license terms
+* for any third-party software incorporated in the software and any applicable open
+* source software license terms, no license or other rights, whether express or
+* implied, are granted under any patent or other intellectual property rights of
+* Microchip or any third party.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef CONFIGURATION_H
+#define CONFIGURATION_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include "user.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Service Configuration
+// *****************************************************************************
+// *****************************************************************************
+/* TIME System Service Configuration Options */
+#define SYS_TIME_INDEX_0                            (0)
+#define SYS_TIME_MAX_TIMERS                         (5)
+#define SYS_TIME_HW_COUNTER_WIDTH                   (32)
+#define SYS_TIME_TICK_FREQ_IN_HZ                    (1000)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Driver Configuration
+// *****************************************************************************
+// *****************************************************************************
+/* ATA8510 Driver Configuration Options */
+    /* UHF SPI driver instances (simulated bus, timer and pins in initialization.c) */
+    #define UHF_SPI_INDEX_0                 0
+    #define UHF_SPI_INSTANCES_NUMBER        1
+    /* UHF SPI DMA (1: DMAC driven transfers, 0: polled SERCOM) */
+    #define UHF_SPI_DMA_ENABLE              0
+    /* UHF SPI command queue depth (asynchronous API) */
+    #define UHF_SPI_QUEUE_LENGTH            8
+    /* UHF SPI guard timer (1: TC one-shot, 0: SYS_TIME counter polling) */
+    #define UHF_SPI_GUARD_TIMER_ENABLE      1
+    /* UHF SPI wake state tracking (1: skip T0 while the AVR is known awake) */
+    #define UHF_SPI_WAKE_TRACKING_ENABLE    1
+    /* UHF SPI timing statistics (1: per command wall and CPU busy time) */
+    #define UHF_SPI_STATS_ENABLE            1
+    /* UHF SPI bus speed negotiation (SCK candidates in Hz, slowest first = MHC setting) */
+    #define UHF_SPI_SPEED_LIST              { 500000UL, 1000000UL, 2000000UL, 3000000UL, 4000000UL }
+    #define UHF_SPI_SPEED_MARGIN            1
+    #define UHF_SPI_SPEED_CHECKS            8
+    #define UHF_SPI_SPEED_ERROR_LIMIT       3
+    #define UHF_SPI_SPEED_SCRATCH_ADDR      (0x02E9)
+    /* UHF SPI trace ring (1: record every telegram, TCC0 ticks; records, power of 2) */
+    #define UHF_SPI_TRACE_ENABLE            1
+    #define UHF_SPI_TRACE_LENGTH            32
+    /* UHF SPI EEPROM programming job (CMD_RDY poll interval, at most 1365 us with the 48 MHz guard timer; timeout per byte) */
+    #define UHF_SPI_EEPROM_POLL_US          1000
+    #define UHF_SPI_EEPROM_TIMEOUT_US       10000
+    /* Unchanged bytes an EEPROM update merges into one secure write with the changed bytes around them */
+    #define UHF_SPI_EEPROM_MERGE_GAP        2
+    /* UHF SPI EEPROM shadow (1: RAM copy of selected EEPROM ranges; bytes, ranges) */
+    #define UHF_SPI_EEPROM_SHADOW_ENABLE    1
+    #define UHF_SPI_EEPROM_SHADOW_SIZE      64
+    #define UHF_SPI_EEPROM_SHADOW_RANGES    4
+    /* UHF SPI bulk dump (bytes per "Read SRAM" telegram and per sink call, 1 to 255; one chunk on the stack) */
+    #define UHF_SPI_DUMP_CHUNK_LENGTH       128
+    /* UHF SPI SRAM register map (1: RAM mirror with dirty bits; registers, mirror bytes, clean bytes a flush writes along) */
+    #define UHF_SPI_REGMAP_ENABLE           1
+    #define UHF_SPI_REGMAP_REGISTERS        32
+    #define UHF_SPI_REGMAP_SIZE             64
+    #define UHF_SPI_REGMAP_MERGE_GAP        4
+    /* UHF SPI RSSI survey (1: channel sweep with statistics; samples per channel, IRQ line poll interval, at most 1365 us with the 48 MHz guard timer; timeout per sample) */
+    #define UHF_SPI_RSSI_SURVEY_ENABLE      1
+    #define UHF_SPI_RSSI_SURVEY_SAMPLES     64
+    #define UHF_SPI_RSSI_POLL_US            50
+    #define UHF_SPI_RSSI_TIMEOUT_US         10000
+    /* UHF SPI IRQ line on an EIC falling edge interrupt (1: edges stamped for the application, which may sleep in between) */
+    #define UHF_SPI_IRQ_EIC_ENABLE          1
+
+#endif // CONFIGURATION_H
@@ -0,0 +1,147 @@
+/*******************************************************************************
+  System Definitions
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    definitions.h
+
+  Summary:
+    Host simulator system definitions
+
+  Description:
+    Counterpart of firmware/src/config/default/definitions.h for the host
+    build: system objects, and the peripheral functions used by main.c with
+    their simulator implementations in sim_platform.c.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+* 
+* The software and documentation is provided by microchip and its contributors
+* "as is" and any express, implied or statutory warranties, including, but not
+* limited to, the implied warranties of merchantability, fitness for a particular
+* purpose and non-infringement of third party intellectual property rights are
+* disclaimed to the fullest extent permitted by law. In no event shall microchip
+* or its contributors be liable for any direct, indirect, incidental, special,
+* exemplary, or consequential damages (including, but not limited to, procurement
+* of substitute goods or services; loss of use, data, or profits; or business
+* interruption) however caused and on any theory of liability, whether in contract,
+* strict liability, or tort (including negligence or otherwise) arising in any way
+* out of the use of the software and documentation, even if advised of the
+* possibility of such damage.
+* 
+* Except as expressly permitted hereunder and subject to the applicable license terms
+* for any third-party software incorporated in the software and any applicable open
+* source software license terms, no license or other rights, whether express or
+* implied, are granted under any patent or other intellectual property rights of
+* Microchip or any third party.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef DEFINITIONS_H
+#define DEFINITIONS_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "configuration.h"
+#include "device.h"
+#include "peripheral/tc/plib_tc_common.h"
+#include "peripheral/eic/plib_eic.h"
+#include "system/time/sys_time.h"
+#include "spi/ata8510/spi_ata8510.h"
+#include "system/ports/sys_ports.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Peripheral stand-ins
+// *****************************************************************************
+// *****************************************************************************
+
+/* SERCOM4 USART, captured by the simulator and paced at 38400 baud */
+bool SERCOM4_USART_Write(void *buffer, const size_t size);
+
+/* SysTick delays advance the simulation clock */
+void SYSTICK_DelayMs(uint32_t delay_ms);
+void SYSTICK_DelayUs(uint32_t delay_us);
+
+/* Application timers, callbacks are registered but never fire */
+void TC0_TimerCallbackRegister(TC_TIMER_CALLBACK callback, uintptr_t context);
+void TC0_TimerStart(void);
+void TC2_TimerCallbackRegister(TC_TIMER_CALLBACK callback, uintptr_t context);
+void TC2_TimerStart(void);
+
+/* OLED board buttons (active low) and LEDs */
+uint8_t sim_button_get(uint8_t button);
+#define OLED_BTN1_PIN                   1U
+#define OLED_BTN2_PIN                   2U
+#define OLED_BTN3_PIN                   3U
+#define OLED_BTN1_Get()                 sim_button_get(OLED_BTN1_PIN)
+#define OLED_BTN2_Get()                 sim_button_get(OLED_BTN2_PIN)
+#define OLED_BTN3_Get()                 sim_button_get(OLED_BTN3_PIN)
+#define OLED_LED1_Set()                 do { } while (0)
+#define OLED_LED1_Clear()               do { } while (0)
+#define OLED_LED2_Set()                 do { } while (0)
+#define OLED_LED2_Clear()               do { } while (0)
+#define OLED_LED3_Set()                 do { } while (0)
+#define OLED_LED3_Clear()               do { } while (0)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SYS_Initialize(void *data);
+
+void SYS_Tasks(void);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct
+{
+    SYS_MODULE_OBJ  sysTime;
+    uhf_dev_t       *uhfSpi0;
+
+} SYSTEM_OBJECTS;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: extern declarations
+// *****************************************************************************
+// *****************************************************************************
+
+extern SYSTEM_OBJECTS sysObj;
+
+/* Implemented by the driver on top of SYSTICK_DelayMs / SYSTICK_DelayUs */
+extern void delay_ms(uint32_t);
+extern void delay_us(uint32_t);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* DEFINITIONS_H */
@@ -0,0 +1,71 @@
+/*******************************************************************************
+  Device Header
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    device.h
+
+  Summary:
+    Host stand-in of the SAMC21 device header
+
+  Description:
+    Provides the few device and CMSIS definitions the driver and the PLIB
+    common headers use. Core intrinsics are routed to the simulator.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+* 
+* The software and documentation is provided by microchip and its contributors
+* "as is" and any express, implied or statutory warranties, including, but not
+* limited to, the implied warranties of merchantability, fitness for a particular
+* purpose and non-infringement of third party intellectual property rights are
+* disclaimed to the fullest extent permitted by law. In no event shall microchip
+* or its contributors be liable for any direct, indirect, incidental, special,
+* exemplary, or consequential damages (including, but not limited to, procurement
+* of substitute goods or services; loss of use, data, or profits; or business
+* interruption) however caused and on any theory of liability, whether in contract,
+* strict liability, or tort (including negligence or otherwise) arising in any way
+* out of the use of the software and documentation, even if advised of the
+* possibility of such damage.
+* 
+* Except as expressly permitted hereunder and subject to the applicable license terms
+* for any third-party software incorporated in the software and any applicable open
+* source software license terms, no license or other rights, whether express or
+* implied, are granted under any patent or other intellectual property rights of
+* Microchip or any third party.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef DEVICE_H
+#define DEVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define __ALIGNED(x)                            __attribute__((aligned(x)))
+
+/* SERCOM SPI master field values used by plib_sercom_spi_master_common.h */
+#define SERCOM_SPIM_CTRLA_CPHA_LEADING_EDGE     (0x0UL << 28)
+#define SERCOM_SPIM_CTRLA_CPHA_TRAILING_EDGE    (0x1UL << 28)
+#define SERCOM_SPIM_CTRLA_CPOL_IDLE_LOW         (0x0UL << 29)
+#define SERCOM_SPIM_CTRLA_CPOL_IDLE_HIGH        (0x1UL << 29)
+#define SERCOM_SPIM_CTRLB_CHSIZE_8_BIT          (0x0UL << 0)
+#define SERCOM_SPIM_CTRLB_CHSIZE_9_BIT          (0x1UL << 0)
+
+/* TC interrupt flags used by plib_tc_common.h */
+#define TC_INTFLAG_OVF_Msk                      (0x1UL << 0)
+#define TC_INTFLAG_MC1_Msk                      (0x1UL << 5)
+
+/* Core intrinsics, see sim_platform.c */
+void sim_wfi(void);
+#define __WFI()                                 sim_wfi()
+#define __disable_irq()                         do { } while (0)
+#define __enable_irq()                          do { } while (0)
+#define __DMB()                                 __sync_synchronize()
+
+#endif // DEVICE_H
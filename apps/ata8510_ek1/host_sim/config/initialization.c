@@ -0,0 +1,104 @@
+/*******************************************************************************
+  ATA8510 Host Simulator
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    initialization.c
+
+  Summary:
+    Host system initialization
+
+  Description:
+    Counterpart of the firmware initialization.c for the host build: the
+    driver instance is bound to the simulated SERCOM1, TC4 guard timer,
+    TCC0 trace counter and pins instead of the PLIBs.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+* 
+* The software and documentation is provided by microchip and its contributors
+* "as is" and any express, implied or statutory warranties, including, but not
+* limited to, the implied warranties of merchantability, fitness for a particular
+* purpose and non-infringement of third party intellectual property rights are
+* disclaimed to the fullest extent permitted by law. In no event shall microchip
+* or its contributors be liable for any direct, indirect, incidental, special,
+* exemplary, or consequential damages (including, but not limited to, procurement
+* of substitute goods or services; loss of use, data, or profits; or business
+* interruption) however caused and on any theory of liability, whether in contract,
+* strict liability, or tort (including negligence or otherwise) arising in any way
+* out of the use of the software and documentation, even if advised of the
+* possibility of such damage.
+* 
+* Except as expressly permitted hereunder and subject to the applicable license terms
+* for any third-party software incorporated in the software and any applicable open
+* source software license terms, no license or other rights, whether express or
+* implied, are granted under any patent or other intellectual property rights of
+* Microchip or any third party.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include "definitions.h"
+#include "sim_platform.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Driver Initialization Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* ATA8510 on the simulated SERCOM1 SPI, TC4 guard timer, TCC0 trace counter */
+const uhf_spi_init_t uhfSpi0InitData =
+{
+    .spi_setup = sim_spi_setup,
+    .spi_write_read = sim_spi_write_read,
+    .timer_frequency_get = sim_timer_frequency_get,
+    .timer_start = sim_timer_start,
+    .timer_period_set = sim_timer_period_set,
+    .timer_command = sim_timer_command,
+    .timer_callback_register = sim_timer_callback_register,
+#if (UHF_SPI_TRACE_ENABLE == 1)
+    .trace_counter_get = sim_trace_counter_get,
+    .trace_frequency_get = sim_trace_frequency_get,
+    .trace_counter_start = sim_trace_counter_start,
+    .trace_counter_mask = 0xFFFFFFUL,
+    .trace_write = SERCOM4_USART_Write,
+#endif
+    .cs_pin = SYS_PORT_PIN_PA17,
+    .nreset_pin = SYS_PORT_PIN_PA21,
+    .npwron_pin = SYS_PORT_PIN_PA20,
+    .irq_pin = SYS_PORT_PIN_PB14,
+#if (UHF_SPI_IRQ_EIC_ENABLE == 1)
+    .irq_eic_pin = EIC_PIN_14,
+    .irq_callback_register = EIC_CallbackRegister,
+#endif
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Data
+// *****************************************************************************
+// *****************************************************************************
+
+SYSTEM_OBJECTS sysObj;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Initialization
+// *****************************************************************************
+// *****************************************************************************
+
+void SYS_Initialize ( void* data )
+{
+    (void)data;
+
+    sysObj.uhfSpi0 = uhf_spi_initialize(UHF_SPI_INDEX_0, &uhfSpi0InitData);
+}
@@ -0,0 +1,64 @@
+/*******************************************************************************
+  Direct Memory Access Controller (DMAC) PLIB
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    plib_dmac.h
+
+  Summary:
+    Host stand-in of the DMAC PLIB header
+
+  Description:
+    Channel and event types referenced by the driver interface. The host
+    build uses polled transfers (UHF_SPI_DMA_ENABLE 0).
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+* 
+* The software and documentation is provided by microchip and its contributors
+* "as is" and any express, implied or statutory warranties, including, but not
+* limited to, the implied warranties of merchantability, fitness for a particular
+* purpose and non-infringement of third party intellectual property rights are
+* disclaimed to the fullest extent permitted by law. In no event shall microchip
+* or its contributors be liable for any direct, indirect, incidental, special,
+* exemplary, or consequential damages (including, but not limited to, procurement
+* of substitute goods or services; loss of use, data, or profits; or business
+* interruption) however caused and on any theory of liability, whether in contract,
+* strict liability, or tort (including negligence or otherwise) arising in any way
+* out of the use of the software and documentation, even if advised of the
+* possibility of such damage.
+* 
+* Except as expressly permitted hereunder and subject to the applicable license terms
+* for any third-party software incorporated in the software and any applicable open
+* source software license terms, no license or other rights, whether express or
+* implied, are granted under any patent or other intellectual property rights of
+* Microchip or any third party.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef PLIB_DMAC_H
+#define PLIB_DMAC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+    DMAC_CHANNEL_0 = 0,
+    DMAC_CHANNEL_1 = 1,
+} DMAC_CHANNEL;
+
+typedef enum
+{
+    DMAC_TRANSFER_EVENT_NONE = 0,
+    DMAC_TRANSFER_EVENT_COMPLETE = 1,
+    DMAC_TRANSFER_EVENT_ERROR = 2
+} DMAC_TRANSFER_EVENT;
+
+typedef void (*DMAC_CHANNEL_CALLBACK)(DMAC_TRANSFER_EVENT event, uintptr_t contextHandle);
+
+#endif // PLIB_DMAC_H
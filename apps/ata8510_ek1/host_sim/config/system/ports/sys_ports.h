@@ -0,0 +1,63 @@
+/*******************************************************************************
+  Ports System Service
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sys_ports.h
+
+  Summary:
+    Host stand-in of the ports system service
+
+  Description:
+    Only the pins used by the ATA8510 driver. Pin changes are forwarded to the
+    transceiver model, see sim_platform.c.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+* 
+* The software and documentation is provided by microchip and its contributors
+* "as is" and any express, implied or statutory warranties, including, but not
+* limited to, the implied warranties of merchantability, fitness for a particular
+* purpose and non-infringement of third party intellectual property rights are
+* disclaimed to the fullest extent permitted by law. In no event shall microchip
+* or its contributors be liable for any direct, indirect, incidental, special,
+* exemplary, or consequential damages (including, but not limited to, procurement
+* of substitute goods or services; loss of use, data, or profits; or business
+* interruption) however caused and on any theory of liability, whether in contract,
+* strict liability, or tort (including negligence or otherwise) arising in any way
+* out of the use of the software and documentation, even if advised of the
+* possibility of such damage.
+* 
+* Except as expressly permitted hereunder and subject to the applicable license terms
+* for any third-party software incorporated in the software and any applicable open
+* source software license terms, no license or other rights, whether express or
+* implied, are granted under any patent or other intellectual property rights of
+* Microchip or any third party.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef SYS_PORTS_H
+#define SYS_PORTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+    SYS_PORT_PIN_PA17 = 17U,
+    SYS_PORT_PIN_PA20 = 20U,
+    SYS_PORT_PIN_PA21 = 21U,
+    SYS_PORT_PIN_PB14 = 46U,
+    SYS_PORT_PIN_NONE = 65535U,
+} SYS_PORT_PIN;
+
+void SYS_PORT_PinWrite(SYS_PORT_PIN pin, bool value);
+bool SYS_PORT_PinRead(SYS_PORT_PIN pin);
+void SYS_PORT_PinSet(SYS_PORT_PIN pin);
+void SYS_PORT_PinClear(SYS_PORT_PIN pin);
+
+#endif // SYS_PORTS_H
@@ -0,0 +1,57 @@
+/*******************************************************************************
+  Time System Service
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sys_time.h
+
+  Summary:
+    Host stand-in of the time system service
+
+  Description:
+    Counter functions of SYS_TIME on the simulation clock, a free-running
+    32-bit counter at the SysTick rate of the board (48 MHz).
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+* 
+* The software and documentation is provided by microchip and its contributors
+* "as is" and any express, implied or statutory warranties, including, but not
+* limited to, the implied warranties of merchantability, fitness for a particular
+* purpose and non-infringement of third party intellectual property rights are
+* disclaimed to the fullest extent permitted by law. In no event shall microchip
+* or its contributors be liable for any direct, indirect, incidental, special,
+* exemplary, or consequential damages (including, but not limited to, procurement
+* of substitute goods or services; loss of use, data, or profits; or business
+* interruption) however caused and on any theory of liability, whether in contract,
+* strict liability, or tort (including negligence or otherwise) arising in any way
+* out of the use of the software and documentation, even if advised of the
+* possibility of such damage.
+* 
+* Except as expressly permitted hereunder and subject to the applicable license terms
+* for any third-party software incorporated in the software and any applicable open
+* source software license terms, no license or other rights, whether express or
+* implied, are granted under any patent or other intellectual property rights of
+* Microchip or any third party.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef SYS_TIME_H
+#define SYS_TIME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "system/system.h"
+
+uint32_t SYS_TIME_FrequencyGet(void);
+uint32_t SYS_TIME_CounterGet(void);
+uint32_t SYS_TIME_CountToUS(uint32_t count);
+uint32_t SYS_TIME_CountToMS(uint32_t count);
+uint32_t SYS_TIME_USToCount(uint32_t us);
+uint32_t SYS_TIME_MSToCount(uint32_t ms);
+
+#endif // SYS_TIME_H
@@ -0,0 +1,760 @@
+/*******************************************************************************
+  ATA8510 Host Model
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    ata8510_model.c
+
+  Summary:
+    Behavioral model of the ATA8510 SPI command set
+
+  Description:
+    Byte level model of the transceiver for the host simulator. Telegram
+    layouts follow the command set implemented by spi_ata8510.c; all times
+    are simulation nanoseconds.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+* 
+* The software and documentation is provided by microchip and its contributors
+* "as is" and any express, implied or statutory warranties, including, but not
+* limited to, the implied warranties of merchantability, fitness for a particular
+* purpose and non-infringement of third party intellectual property rights are
+* disclaimed to the fullest extent permitted by law. In no event shall microchip
+* or its contributors be liable for any direct, indirect, incidental, special,
+* exemplary, or consequential damages (including, but not limited to, procurement
+* of substitute goods or services; loss of use, data, or profits; or business
+* interruption) however caused and on any theory of liability, whether in contract,
+* strict liability, or tort (including negligence or otherwise) arising in any way
+* out of the use of the software and documentation, even if advised of the
+* possibility of such damage.
+* 
+* Except as expressly permitted hereunder and subject to the applicable license terms
+* for any third-party software incorporated in the software and any applicable open
+* source software license terms, no license or other rights, whether express or
+* implied, are granted under any patent or other intellectual property rights of
+* Microchip or any third party.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "ata8510_model.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define MODEL_NONE              UINT64_MAX
+
+/* SRAM area of "Trigger EEPROM Secure Write": address high / low, length, data */
+#define MODEL_SECURE_WRITE_SRAM (0x02E9)
+
+/* Bits that pull the IRQ line low */
+#define MODEL_IRQ_SYSTEM        (ATA8510_MODEL_SYS_ERR | ATA8510_MODEL_CMD_RDY | ATA8510_MODEL_SYS_RDY | ATA8510_MODEL_DFIFO)
+
+static const uint8_t g_secure_write_key[] = { 0xAA, 0xCC, 0xF0 };
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void model_fifo_clear(ata8510_model_fifo_t *fifo)
+{
+    fifo->head = 0;
+    fifo->count = 0;
+}
+
+static void model_fifo_push(ata8510_model_fifo_t *fifo, uint8_t data)
+{
+    if (fifo->count >= ATA8510_MODEL_FIFO_SIZE)
+    {
+        fifo->overruns++;
+        return;
+    }
+    fifo->data[(fifo->head + fifo->count) % ATA8510_MODEL_FIFO_SIZE] = data;
+    fifo->count++;
+}
+
+static uint8_t model_fifo_pop(ata8510_model_fifo_t *fifo)
+{
+    uint8_t data;
+
+    if (fifo->count == 0U)
+    {
+        return 0x00;
+    }
+    data = fifo->data[fifo->head];
+    fifo->head = (fifo->head + 1U) % ATA8510_MODEL_FIFO_SIZE;
+    fifo->count--;
+
+    return data;
+}
+
+static uint64_t model_byte_ns(uint32_t rate)
+{
+    return (8000000000ULL + rate - 1U) / rate;
+}
+
+static uint8_t model_opm(const ata8510_model_t *model)
+{
+    return model->mode & ATA8510_MODEL_OPM_MASK;
+}
+
+static bool model_ready(const ata8510_model_t *model)
+{
+    return (model->powered == true) && (model->in_reset == false) && (model->boot_at == MODEL_NONE);
+}
+
+/* Volatile state after power-up, reset command or NRESET */
+static void model_reset(ata8510_model_t *model)
+{
+    memset(model->events, 0, sizeof(model->events));
+    model->mode = ATA8510_MODEL_OPM_IDLE;
+    model->service_channel = 0;
+    model_fifo_clear(&model->rx);
+    model_fifo_clear(&model->tx);
+    model_fifo_clear(&model->preamble);
+    model_fifo_clear(&model->rssi);
+    model->busy_until = MODEL_NONE;
+    model->tx_next = MODEL_NONE;
+    model->awake = false;
+}
+
+static void model_boot(ata8510_model_t *model, uint64_t now)
+{
+    model_reset(model);
+    model->boot_at = now + model->boot_ns;
+}
+
+/* The preamble goes out first, then the TX FIFO byte by byte. Bytes written
+   meanwhile are sent on; the telegram ends when the FIFO is found empty. */
+static void model_tx_start(ata8510_model_t *model, uint64_t now)
+{
+    uint16_t length = 0;
+
+    while (model->preamble.count != 0U)
+    {
+        model->tx_air[length++] = model_fifo_pop(&model->preamble);
+    }
+    model->tx_air_length = length;
+    model->events[1] |= ATA8510_MODEL_SOTA;
+    model->tx_next = now + (uint64_t)length * model_byte_ns(model->bitrate);
+}
+
+/* RSSI average of a measurement on the service / channel of START_RSSI_MEAS */
+static uint8_t model_rssi_sample(ata8510_model_t *model)
+{
+    uint8_t config = model->service_channel;
+    uint32_t level = model->rssi_level[(config & 0x07U) | ((config >> 1) & 0x18U)];
+
+    if (model->rssi_spread != 0U)
+    {
+        /* xorshift32, the same sequence on every run */
+        model->rssi_noise ^= model->rssi_noise << 13;
+        model->rssi_noise ^= model->rssi_noise >> 17;
+        model->rssi_noise ^= model->rssi_noise << 5;
+        level += model->rssi_noise % ((uint32_t)model->rssi_spread + 1U);
+    }
+
+    return (level < 0xFFU) ? (uint8_t)level : 0xFFU;
+}
+
+static bool model_receiving(const ata8510_model_t *model)
+{
+    return (model_opm(model) == ATA8510_MODEL_OPM_RX) || (model_opm(model) == ATA8510_MODEL_OPM_POLLING);
+}
+
+/* Commands that take effect once the whole telegram is in, at CS high */
+static void model_execute(ata8510_model_t *model, uint64_t now)
+{
+    uint8_t length;
+    uint16_t addr;
+
+    switch (model->opcode)
+    {
+        case 0x04:  /* Get event bytes, reading clears them */
+            if (model->pos >= 4U)
+            {
+                memset(model->events, 0, sizeof(model->events));
+            }
+            break;
+
+        case 0x09:  /* Write EEPROM */
+            if ((model->pos >= 4U) && (model->busy_until == MODEL_NONE))
+            {
+                model->busy_op = model->opcode;
+                model->busy_addr = ((uint16_t)model->mosi[1] << 8) | model->mosi[2];
+                model->busy_length = 1;
+                model->busy_data[0] = model->mosi[3];
+                model->events[0] &= (uint8_t)~ATA8510_MODEL_CMD_RDY;
+                model->busy_until = now + model->eeprom_write_ns;
+            }
+            break;
+
+        case 0x0D:  /* Set system mode */
+            if (model->pos >= 3U)
+            {
+                model->mode = model->mosi[1];
+                model->service_channel = model->mosi[2];
+                model->awake = (model_opm(model) == ATA8510_MODEL_OPM_TX) || (model_opm(model) == ATA8510_MODEL_OPM_RX);
+                if (model_opm(model) == ATA8510_MODEL_OPM_TX)
+                {
+                    model_tx_start(model, now);
+                }
+            }
+            break;
+
+        case 0x10:  /* System reset ROM */
+        case 0x15:  /* System reset */
+            model_boot(model, now);
+            break;
+
+        case 0x16:  /* Trigger EEPROM secure write */
+            if ((model->pos < 4U) || (memcmp(&model->mosi[1], g_secure_write_key, sizeof(g_secure_write_key)) != 0))
+            {
+                model->events[0] |= ATA8510_MODEL_SYS_ERR;
+                break;
+            }
+            addr = ((uint16_t)model->sram[MODEL_SECURE_WRITE_SRAM] << 8) | model->sram[MODEL_SECURE_WRITE_SRAM + 1U];
+            length = model->sram[MODEL_SECURE_WRITE_SRAM + 2U];
+            if ((length == 0U) || (length > sizeof(model->busy_data)) || (model->busy_until != MODEL_NONE))
+            {
+                model->events[0] |= ATA8510_MODEL_SYS_ERR;
+                break;
+            }
+            model->busy_op = model->opcode;
+            model->busy_addr = addr;
+            model->busy_length = length;
+            memcpy(model->busy_data, &model->sram[MODEL_SECURE_WRITE_SRAM + 3U], length);
+            model->events[0] &= (uint8_t)~ATA8510_MODEL_CMD_RDY;
+            model->busy_until = now + (uint64_t)length * model->eeprom_write_ns;
+            break;
+
+        case 0x18:  /* OFF command */
+            model_reset(model);
+            model->powered = false;
+            break;
+
+        case 0x1B:  /* Start RSSI measurement */
+            if ((model->pos >= 2U) && (model->busy_until == MODEL_NONE))
+            {
+                model->service_channel = model->mosi[1];
+                model->busy_op = model->opcode;
+                model->events[0] &= (uint8_t)~ATA8510_MODEL_CMD_RDY;
+                model->busy_until = now + model->rssi_meas_ns;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* MISO byte and immediate effect of byte pos of the telegram */
+static uint8_t model_byte(ata8510_model_t *model, uint8_t mosi)
+{
+    uint16_t n = model->pos;
+    uint8_t miso = 0x00;
+
+    if (n < sizeof(model->mosi))
+    {
+        model->mosi[n] = mosi;
+    }
+    if (n == 0U)
+    {
+        model->opcode = mosi;
+        return model->events[0];
+    }
+    if (n == 1U)
+    {
+        miso = model->events[1];
+    }
+
+    switch (model->opcode)
+    {
+        case 0x01:  /* Read fill level RX / TX / RSSI FIFO */
+        case 0x02:
+        case 0x03:
+            if (n == 2U)
+            {
+                miso = (model->opcode == 0x01) ? model->rx.count :
+                       (model->opcode == 0x02) ? model->tx.count : model->rssi.count;
+            }
+            break;
+
+        case 0x04:  /* Get event bytes */
+            if (n < 4U)
+            {
+                miso = model->events[n];
+            }
+            break;
+
+        case 0x05:  /* Read RSSI / RX FIFO */
+        case 0x06:
+            if (n >= 3U)
+            {
+                miso = model_fifo_pop((model->opcode == 0x05) ? &model->rssi : &model->rx);
+            }
+            break;
+
+        case 0x07:  /* Write SRAM */
+            if (n == 3U)
+            {
+                model->addr = ((uint16_t)model->mosi[2] << 8) | mosi;
+            }
+            else if (n >= 4U)
+            {
+                model->sram[(model->addr + n - 4U) % ATA8510_MODEL_SRAM_SIZE] = mosi;
+            }
+            break;
+
+        case 0x08:  /* Read SRAM */
+            if (n == 3U)
+            {
+                model->addr = ((uint16_t)model->mosi[2] << 8) | mosi;
+            }
+            else if (n >= 5U)
+            {
+                miso = model->sram[(model->addr + n - 5U) % ATA8510_MODEL_SRAM_SIZE];
+            }
+            break;
+
+        case 0x0A:  /* Read EEPROM */
+            if (n == 4U)
+            {
+                model->addr = ((uint16_t)model->mosi[1] << 8) | model->mosi[2];
+                miso = model->eeprom[model->addr % ATA8510_MODEL_EEPROM_SIZE];
+            }
+            break;
+
+        case 0x0B:  /* Write TX / TX preamble FIFO */
+        case 0x0C:
+            if (n >= 2U)
+            {
+                model_fifo_push((model->opcode == 0x0B) ? &model->tx : &model->preamble, mosi);
+            }
+            break;
+
+        case 0x12:  /* Get version ROM */
+            if (n == 2U)
+            {
+                miso = model->rom_version;
+            }
+            break;
+
+        case 0x13:  /* Get version flash */
+            if ((n >= 2U) && (n < 5U))
+            {
+                miso = model->flash_version[n - 2U];
+            }
+            else if (n == 5U)
+            {
+                miso = model->customer;
+            }
+            break;
+
+        case 0x19:  /* Read temperature value */
+            if (n == 2U)
+            {
+                miso = (uint8_t)(model->temperature >> 8);
+            }
+            else if (n == 3U)
+            {
+                miso = (uint8_t)model->temperature;
+            }
+            break;
+
+        case 0x1C:  /* Get RSSI value */
+            if ((n == 2U) || (n == 3U))
+            {
+                miso = model->rssi_result[n - 2U];
+            }
+            break;
+
+        case 0x1D:  /* Read RX / RSSI buffer byte-int: a step byte 0x01
+                       requests the byte delivered two bytes later */
+        case 0x1E:
+            if ((n == 2U) || ((n > 2U) && (model->mosi_prev[1] == 0x01)))
+            {
+                miso = model_fifo_pop((model->opcode == 0x1D) ? &model->rx : &model->rssi);
+            }
+            break;
+
+        case 0x0D: case 0x0E: case 0x0F: case 0x10: case 0x09: case 0x14: case 0x15:
+        case 0x16: case 0x17: case 0x18: case 0x1A: case 0x1B:
+            /* Parameters only, executed at CS high */
+            break;
+
+        default:
+            if (n == 1U)
+            {
+                model->events[0] |= ATA8510_MODEL_SYS_ERR;
+            }
+            break;
+    }
+
+    return miso;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void ata8510_model_init(ata8510_model_t *model)
+{
+    memset(model, 0, sizeof(ata8510_model_t));
+
+    model->sck_max = 2000000UL;
+    model->bitrate = 20000UL;
+    model->t0_ns = 25000U;
+    model->t1_ns = 18000U;
+    model->t4_ns = 35000U;
+    model->t5_ns = 16000U;
+    model->boot_ns = 2000000U;
+    model->eeprom_write_ns = 4000000U;
+    model->rssi_meas_ns = 1000000U;
+    model->rom_version = 0x23;
+    model->flash_version[0] = 0x01;
+    model->flash_version[1] = 0x04;
+    model->flash_version[2] = 0x00;
+    model->customer = 0x00;
+    model->temperature = 0x0190;
+    model->irq_mask_trx = ATA8510_MODEL_EOTA | ATA8510_MODEL_EOTB;
+    memset(model->rssi_level, 0x40, sizeof(model->rssi_level));
+    model->rssi_noise = 0x2545F491U;
+
+    memset(model->eeprom, 0xFF, sizeof(model->eeprom));
+    model->powered = false;
+    model->in_reset = false;
+    model->boot_at = MODEL_NONE;
+    model->air_start = MODEL_NONE;
+    model->cs_rise = 0;
+    model_reset(model);
+}
+
+bool ata8510_model_eeprom_load(ata8510_model_t *model, const char *path)
+{
+    char line[600];
+    FILE *file = fopen(path, "r");
+    unsigned int count, addr, type, value, i;
+
+    if (file == NULL)
+    {
+        return false;
+    }
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if ((line[0] != ':') || (sscanf(&line[1], "%2x%4x%2x", &count, &addr, &type) != 3))
+        {
+            continue;
+        }
+        if (type == 0x01U)
+        {
+            break;
+        }
+        for (i = 0; (type == 0x00U) && (i < count); i++)
+        {
+            if ((sscanf(&line[9 + (2 * i)], "%2x", &value) == 1) && ((addr + i) < ATA8510_MODEL_EEPROM_SIZE))
+            {
+                model->eeprom[addr + i] = (uint8_t)value;
+            }
+        }
+    }
+    fclose(file);
+
+    return true;
+}
+
+void ata8510_model_npwron(ata8510_model_t *model, bool level, uint64_t now)
+{
+    /* Falling edge wakes the device from OFF */
+    if ((level == false) && (model->powered == false))
+    {
+        model->powered = true;
+        model_boot(model, now);
+    }
+}
+
+void ata8510_model_nreset(ata8510_model_t *model, bool level, uint64_t now)
+{
+    if (level == false)
+    {
+        model->in_reset = true;
+        model_reset(model);
+        model->boot_at = MODEL_NONE;
+    }
+    else if (model->in_reset == true)
+    {
+        model->in_reset = false;
+        if (model->powered == true)
+        {
+            model_boot(model, now);
+        }
+    }
+    else
+    {
+        /* No edge */
+    }
+}
+
+void ata8510_model_cs(ata8510_model_t *model, bool level, uint64_t now)
+{
+    if ((level == false) && (model->cs_low == false))
+    {
+        model->cs_low = true;
+        model->cs_fall = now;
+        model->pos = 0;
+        model->garbled = false;
+        memset(model->mosi_prev, 0, sizeof(model->mosi_prev));
+        if ((model->telegrams != 0U) && ((now - model->cs_rise) < model->t5_ns))
+        {
+            model->violations[ATA8510_MODEL_T5]++;
+            model->garbled = true;
+        }
+    }
+    else if ((level == true) && (model->cs_low == true))
+    {
+        model->cs_low = false;
+        model->cs_rise = now;
+        if (model->pos == 0U)
+        {
+            return;
+        }
+        model->telegrams++;
+        model->opcodes[model->opcode & 0x1FU]++;
+        model->cs_low_ns += now - model->cs_fall;
+        if ((now - model->last_byte) < model->t4_ns)
+        {
+            model->violations[ATA8510_MODEL_T4]++;
+            model->garbled = true;
+        }
+        if ((model->garbled == false) && (model_ready(model) == true))
+        {
+            model_execute(model, now);
+        }
+    }
+    else
+    {
+        /* No edge */
+    }
+}
+
+bool ata8510_model_irq(const ata8510_model_t *model)
+{
+    return ((model->events[0] & MODEL_IRQ_SYSTEM) != 0U) || ((model->events[1] & model->irq_mask_trx) != 0U) || (model->events[2] != 0U);
+}
+
+uint8_t ata8510_model_transfer(ata8510_model_t *model, uint8_t mosi, uint64_t now)
+{
+    uint64_t byte_ns = model_byte_ns(model->sck);
+    uint64_t setup;
+    uint8_t miso;
+
+    model->bytes++;
+    model->shift_ns += byte_ns;
+    model->last_byte = now;
+    if (model->cs_low == false)
+    {
+        return 0xFF;
+    }
+
+    if (model->pos == 0U)
+    {
+        setup = (now - byte_ns) - model->cs_fall;
+        if ((model->awake == false) && (setup < (uint64_t)model->t0_ns + model->t1_ns))
+        {
+            model->violations[ATA8510_MODEL_T0]++;
+            model->garbled = true;
+        }
+        else if (setup < model->t1_ns)
+        {
+            model->violations[ATA8510_MODEL_T1]++;
+            model->garbled = true;
+        }
+        else
+        {
+            /* Setup time met */
+        }
+        if (model->sck > model->sck_max)
+        {
+            model->sck_errors++;
+            model->garbled = true;
+        }
+    }
+    if ((model->garbled == true) || (model_ready(model) == false))
+    {
+        model->pos++;
+        return 0xFF;
+    }
+
+    miso = model_byte(model, mosi);
+    model->mosi_prev[1] = model->mosi_prev[0];
+    model->mosi_prev[0] = mosi;
+    model->pos++;
+
+    return miso;
+}
+
+uint64_t ata8510_model_next_event(const ata8510_model_t *model)
+{
+    uint64_t next = MODEL_NONE;
+    uint64_t air;
+
+    if (model->boot_at < next)
+    {
+        next = model->boot_at;
+    }
+    if (model->busy_until < next)
+    {
+        next = model->busy_until;
+    }
+    if (model->tx_next < next)
+    {
+        next = model->tx_next;
+    }
+    if ((model->air_start != MODEL_NONE) && ((model->air_pos < model->air_length) || (model->air_length == 0U)))
+    {
+        air = model->air_start + ((uint64_t)model->air_pos + 1U) * model_byte_ns(model->bitrate);
+        if (air < next)
+        {
+            next = air;
+        }
+    }
+
+    return next;
+}
+
+void ata8510_model_advance(ata8510_model_t *model, uint64_t now)
+{
+    uint64_t at;
+    uint16_t i;
+
+    if (model->boot_at <= now)
+    {
+        model->boot_at = MODEL_NONE;
+        model->events[0] |= ATA8510_MODEL_SYS_RDY;
+    }
+
+    if (model->busy_until <= now)
+    {
+        model->busy_until = MODEL_NONE;
+        if (model->busy_op == 0x1B)
+        {
+            model->rssi_result[0] = model_rssi_sample(model);
+            model->rssi_result[1] = (model->rssi_result[0] < 0xFCU) ? (uint8_t)(model->rssi_result[0] + 3U) : 0xFFU;
+        }
+        else
+        {
+            for (i = 0; i < model->busy_length; i++)
+            {
+                model->eeprom[(model->busy_addr + i) % ATA8510_MODEL_EEPROM_SIZE] = model->busy_data[i];
+            }
+            model->eeprom_writes += model->busy_length;
+        }
+        model->events[0] |= ATA8510_MODEL_CMD_RDY;
+    }
+
+    while (model->tx_next <= now)
+    {
+        at = model->tx_next;
+        if ((model->tx.count != 0U) && (model->tx_air_length < ATA8510_MODEL_AIR_LENGTH))
+        {
+            model->tx_air[model->tx_air_length++] = model_fifo_pop(&model->tx);
+            model->tx_next += model_byte_ns(model->bitrate);
+            if ((model->dfifo_level != 0U) && (model->tx.count == model->dfifo_level))
+            {
+                model->events[0] |= ATA8510_MODEL_DFIFO;
+            }
+            continue;
+        }
+        model->tx_next = MODEL_NONE;
+        model->events[1] |= ATA8510_MODEL_EOTA;
+        model->tx_telegrams++;
+        if (model->tx_callback != NULL)
+        {
+            model->tx_callback(model, model->tx_air, model->tx_air_length, at, model->tx_context);
+        }
+    }
+
+    while ((model->air_start != MODEL_NONE) && ((model->air_pos < model->air_length) || (model->air_length == 0U)))
+    {
+        at = model->air_start + ((uint64_t)model->air_pos + 1U) * model_byte_ns(model->bitrate);
+        if (at > now)
+        {
+            break;
+        }
+        if (model->air_pos == 0U)
+        {
+            if ((model_ready(model) == false) || (model_receiving(model) == false))
+            {
+                model->rx_missed++;
+                model->air_start = MODEL_NONE;
+                break;
+            }
+            model->awake = true;
+            model->events[1] |= ATA8510_MODEL_WCOKA | ATA8510_MODEL_SOTA;
+            model->events[3] = model->air_config;
+        }
+        if (model->air_length != 0U)
+        {
+            model_fifo_push(&model->rx, model->air[model->air_pos]);
+            model_fifo_push(&model->rssi, model->air_rssi);
+            if ((model->dfifo_level != 0U) && (model->rx.count == model->dfifo_level))
+            {
+                model->events[0] |= ATA8510_MODEL_DFIFO;
+            }
+            model->air_pos++;
+        }
+        if (model->air_pos == model->air_length)
+        {
+            model->events[1] |= ATA8510_MODEL_EOTA;
+            model->rx_telegrams++;
+            model->air_start = MODEL_NONE;
+        }
+    }
+}
+
+void ata8510_model_rx_start(ata8510_model_t *model, const uint8_t *data, size_t length, uint8_t rssi,
+                            uint8_t config, uint64_t now)
+{
+    if (length > ATA8510_MODEL_AIR_LENGTH)
+    {
+        length = ATA8510_MODEL_AIR_LENGTH;
+    }
+    memcpy(model->air, data, length);
+    model->air_length = (uint16_t)length;
+    model->air_pos = 0;
+    model->air_rssi = rssi;
+    model->air_config = config;
+    model->air_start = now;
+}
+
+uint32_t ata8510_model_violations(const ata8510_model_t *model)
+{
+    uint32_t total = 0;
+    uint8_t i;
+
+    for (i = 0; i < ATA8510_MODEL_VIOLATIONS; i++)
+    {
+        total += model->violations[i];
+    }
+
+    return total;
+}
@@ -0,0 +1,232 @@
+/*******************************************************************************
+  ATA8510 Host Model
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    ata8510_model.h
+
+  Summary:
+    Behavioral model of the ATA8510 SPI command set
+
+  Description:
+    Byte level model of the transceiver as seen from the SPI bus: event
+    bytes and IRQ line, RX / TX / RSSI FIFOs with fill levels, SRAM and
+    EEPROM address spaces, system modes and the T0 - T5 telegram timing.
+    The air interface is driven by the test scenario through the
+    ata8510_model_rx_start() and tx callback hooks.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+* 
+* The software and documentation is provided by microchip and its contributors
+* "as is" and any express, implied or statutory warranties, including, but not
+* limited to, the implied warranties of merchantability, fitness for a particular
+* purpose and non-infringement of third party intellectual property rights are
+* disclaimed to the fullest extent permitted by law. In no event shall microchip
+* or its contributors be liable for any direct, indirect, incidental, special,
+* exemplary, or consequential damages (including, but not limited to, procurement
+* of substitute goods or services; loss of use, data, or profits; or business
+* interruption) however caused and on any theory of liability, whether in contract,
+* strict liability, or tort (including negligence or otherwise) arising in any way
+* out of the use of the software and documentation, even if advised of the
+* possibility of such damage.
+* 
+* Except as expressly permitted hereunder and subject to the applicable license terms
+* for any third-party software incorporated in the software and any applicable open
+* source software license terms, no license or other rights, whether express or
+* implied, are granted under any patent or other intellectual property rights of
+* Microchip or any third party.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _ATA8510_MODEL_H
+#define _ATA8510_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+    extern "C" {
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+#define ATA8510_MODEL_SRAM_SIZE         (0x0800)
+#define ATA8510_MODEL_EEPROM_SIZE       (0x0400)
+#define ATA8510_MODEL_FIFO_SIZE         (32)
+#define ATA8510_MODEL_AIR_LENGTH        (512)
+
+/* events.system */
+#define ATA8510_MODEL_SYS_ERR           (0x80)
+#define ATA8510_MODEL_CMD_RDY           (0x40)
+#define ATA8510_MODEL_SYS_RDY           (0x20)
+#define ATA8510_MODEL_DFIFO             (0x02)  // DFIFO fill level reached dfifo_level
+/* events.trx, path A */
+#define ATA8510_MODEL_WCOKA             (0x40)
+#define ATA8510_MODEL_SOTA              (0x20)
+#define ATA8510_MODEL_EOTA              (0x10)
+#define ATA8510_MODEL_EOTB              (0x01)
+
+/* Operating mode, low bits of the system mode configuration */
+#define ATA8510_MODEL_OPM_MASK          (0x03)
+#define ATA8510_MODEL_OPM_IDLE          (0x00)
+#define ATA8510_MODEL_OPM_TX            (0x01)
+#define ATA8510_MODEL_OPM_RX            (0x02)
+#define ATA8510_MODEL_OPM_POLLING       (0x03)
+
+/* Telegram timing violations, index into ata8510_model_t.violations */
+typedef enum
+{
+    ATA8510_MODEL_T0 = 0,   // first byte before the AVR woke up
+    ATA8510_MODEL_T1,       // first byte too early after CS low
+    ATA8510_MODEL_T4,       // CS high too early after the last byte
+    ATA8510_MODEL_T5,       // CS low too early after the last CS high
+    ATA8510_MODEL_VIOLATIONS
+} ata8510_model_violation_t;
+
+typedef struct ata8510_model_fifo_t
+{
+    uint8_t             data[ATA8510_MODEL_FIFO_SIZE];
+    uint8_t             head;
+    uint8_t             count;
+    uint32_t            overruns;   // bytes dropped on a full FIFO
+} ata8510_model_fifo_t;
+
+typedef struct ata8510_model_t ata8510_model_t;
+
+/* Called when a transmission ends, data is preamble FIFO + TX FIFO content */
+typedef void (*ata8510_model_tx_callback_t)(ata8510_model_t *model, const uint8_t *data, size_t length,
+                                           uint64_t now, uintptr_t context);
+
+struct ata8510_model_t
+{
+    /* Configuration, may be changed by the scenario at any time */
+    uint32_t            sck_max;            // Hz, faster telegrams read back 0xFF
+    uint32_t            bitrate;            // air data rate in bit/s
+    uint32_t            t0_ns;
+    uint32_t            t1_ns;
+    uint32_t            t4_ns;
+    uint32_t            t5_ns;
+    uint32_t            boot_ns;            // NRESET high to SYS_RDY
+    uint32_t            eeprom_write_ns;    // per EEPROM byte
+    uint32_t            rssi_meas_ns;       // START_RSSI_MEAS to result
+    uint8_t             rom_version;
+    uint8_t             flash_version[3];
+    uint8_t             customer;
+    uint16_t            temperature;
+    uint8_t             rssi_level[32];     // START_RSSI_MEAS level, [service (bits 2:0) + 8 * channel (bits 5:4)]
+    uint8_t             rssi_spread;        // 0 - rssi_spread added per measurement, pseudo random
+    uint8_t             irq_mask_trx;       // trx events driving IRQ, EEPROM IRQ setting
+    uint8_t             dfifo_level;        // DFIFO fill level event, RX rising / TX falling to it, 0 = off
+    ata8510_model_tx_callback_t tx_callback;
+    uintptr_t           tx_context;
+
+    /* Device state */
+    bool                powered;            // NPWRON low
+    bool                in_reset;           // NRESET low
+    uint8_t             events[4];          // system, trx, power, config
+    uint8_t             mode;               // system mode configuration
+    uint8_t             service_channel;
+    uint8_t             sram[ATA8510_MODEL_SRAM_SIZE];
+    uint8_t             eeprom[ATA8510_MODEL_EEPROM_SIZE];
+    ata8510_model_fifo_t rx;
+    ata8510_model_fifo_t tx;
+    ata8510_model_fifo_t preamble;
+    ata8510_model_fifo_t rssi;
+    uint8_t             rssi_result[2];     // average, peak
+    uint32_t            rssi_noise;         // state of the rssi_spread generator
+
+    /* Pending internal events, UINT64_MAX if none */
+    uint64_t            boot_at;
+    uint64_t            busy_until;         // EEPROM write / RSSI measurement
+    uint8_t             busy_op;            // command ID of the running operation
+    uint16_t            busy_addr;
+    uint8_t             busy_length;
+    uint8_t             busy_data[16];      // EEPROM bytes to be programmed
+    uint64_t            tx_next;            // next TX FIFO byte goes on air
+    uint8_t             air[ATA8510_MODEL_AIR_LENGTH];   // telegram on the air, for RX
+    uint8_t             air_rssi;
+    uint8_t             air_config;
+    uint16_t            air_length;
+    uint16_t            air_pos;
+    uint64_t            air_start;          // first data byte at air_start + 1 byte time
+    uint8_t             tx_air[ATA8510_MODEL_AIR_LENGTH];   // telegram sent, preamble first
+    uint16_t            tx_air_length;
+
+    /* SPI telegram in progress */
+    bool                cs_low;
+    bool                awake;              // AVR running, no T0 needed
+    bool                garbled;            // telegram ignored, reads back 0xFF
+    uint32_t            sck;                // current master SCK rate
+    uint16_t            pos;                // byte index within the telegram
+    uint8_t             mosi[8];            // first bytes of the telegram
+    uint8_t             opcode;
+    uint8_t             mosi_prev[2];       // MOSI one and two bytes back, byte-int reads
+    uint16_t            addr;
+    uint64_t            cs_fall;
+    uint64_t            cs_rise;
+    uint64_t            last_byte;
+
+    /* Statistics */
+    uint32_t            telegrams;
+    uint32_t            opcodes[32];        // telegrams per command ID
+    uint32_t            bytes;
+    uint64_t            cs_low_ns;          // CS assert to CS release, all telegrams
+    uint64_t            shift_ns;           // SCK active
+    uint32_t            violations[ATA8510_MODEL_VIOLATIONS];
+    uint32_t            sck_errors;         // telegrams above sck_max
+    uint32_t            rx_missed;          // telegrams on the air while not receiving
+    uint32_t            eeprom_writes;      // EEPROM bytes programmed
+    uint32_t            rx_telegrams;
+    uint32_t            tx_telegrams;
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/* Power-on defaults, EEPROM erased to 0xFF */
+void ata8510_model_init(ata8510_model_t *model);
+
+/* Load an Intel HEX EEPROM image (programming_files, .eep), false on error */
+bool ata8510_model_eeprom_load(ata8510_model_t *model, const char *path);
+
+/* Pins, now is the simulation time in ns */
+void ata8510_model_npwron(ata8510_model_t *model, bool level, uint64_t now);
+void ata8510_model_nreset(ata8510_model_t *model, bool level, uint64_t now);
+void ata8510_model_cs(ata8510_model_t *model, bool level, uint64_t now);
+bool ata8510_model_irq(const ata8510_model_t *model);
+
+/* One SPI byte, now is the time the byte has been shifted completely */
+uint8_t ata8510_model_transfer(ata8510_model_t *model, uint8_t mosi, uint64_t now);
+
+/* Internal events: time of the next one, and processing up to now */
+uint64_t ata8510_model_next_event(const ata8510_model_t *model);
+void ata8510_model_advance(ata8510_model_t *model, uint64_t now);
+
+/* Air interface: a telegram starts at now (after preamble and wake-up
+   check). It is received if the model is in RX or polling mode while it
+   arrives. rssi is the level reported for every byte, config the event
+   byte of the receiving service / channel. A length of 0 is a telegram
+   cut short: SOT and EOT one byte time after now, nothing in the FIFOs. */
+void ata8510_model_rx_start(ata8510_model_t *model, const uint8_t *data, size_t length, uint8_t rssi,
+                            uint8_t config, uint64_t now);
+
+uint32_t ata8510_model_violations(const ata8510_model_t *model);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // #ifndef _ATA8510_MODEL_H
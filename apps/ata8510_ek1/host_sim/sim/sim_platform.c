@@ -0,0 +1,670 @@
+/*******************************************************************************
+  ATA8510 Host Simulator
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sim_platform.c
+
+  Summary:
+    Simulated platform of the ATA8510 host build
+
+  Description:
+    Implementation of the simulation clock, the event scheduler and the
+    peripheral stand-ins declared in sim_platform.h and definitions.h.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+* 
+* The software and documentation is provided by microchip and its contributors
+* "as is" and any express, implied or statutory warranties, including, but not
+* limited to, the implied warranties of merchantability, fitness for a particular
+* purpose and non-infringement of third party intellectual property rights are
+* disclaimed to the fullest extent permitted by law. In no event shall microchip
+* or its contributors be liable for any direct, indirect, incidental, special,
+* exemplary, or consequential damages (including, but not limited to, procurement
+* of substitute goods or services; loss of use, data, or profits; or business
+* interruption) however caused and on any theory of liability, whether in contract,
+* strict liability, or tort (including negligence or otherwise) arising in any way
+* out of the use of the software and documentation, even if advised of the
+* possibility of such damage.
+* 
+* Except as expressly permitted hereunder and subject to the applicable license terms
+* for any third-party software incorporated in the software and any applicable open
+* source software license terms, no license or other rights, whether express or
+* implied, are granted under any patent or other intellectual property rights of
+* Microchip or any third party.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "definitions.h"
+#include "sim_platform.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data
+// *****************************************************************************
+// *****************************************************************************
+
+ata8510_model_t sim_model;
+
+typedef struct
+{
+    uint64_t            at;
+    sim_event_t         event;
+    uintptr_t           context;
+} sim_event_obj_t;
+
+static uint64_t g_now;
+static uint64_t g_deadline = SIM_NONE;
+static jmp_buf g_run_exit;
+static bool g_running;
+static sim_hook_t g_hook;
+static sim_event_obj_t g_events[SIM_EVENTS];
+static bool g_buttons[4];
+static uint32_t g_oled[128];            // pixel columns, bit n = row n
+static char g_uart[SIM_UART_LENGTH];
+static size_t g_uart_length;
+static bool g_uart_echo;
+
+/* TC4 one-shot */
+static uint16_t g_timer_period;
+static uint64_t g_timer_expiry = SIM_NONE;
+static TC_TIMER_CALLBACK g_timer_callback;
+static uintptr_t g_timer_context;
+
+/* TC0 10 ms tick */
+static uint64_t g_tick_expiry = SIM_NONE;
+static TC_TIMER_CALLBACK g_tick_callback;
+static uintptr_t g_tick_context;
+
+/* EIC EXTINT14, falling edge of the IRQ line */
+static EIC_CALLBACK g_eic_callback;
+static uintptr_t g_eic_context;
+static bool g_eic_enabled;
+static bool g_irq_asserted;
+static uint64_t g_irq_edge = SIM_NONE;  // oldest edge not answered by a telegram yet
+static sim_cpu_stats_t g_cpu;
+static uint64_t g_wfi_start = SIM_NONE; // in WFI since
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t sim_next_event(void)
+{
+    uint64_t next = g_timer_expiry;
+    uint64_t model = ata8510_model_next_event(&sim_model);
+    uint8_t i;
+
+    if (g_tick_expiry < next)
+    {
+        next = g_tick_expiry;
+    }
+    if (model < next)
+    {
+        next = model;
+    }
+    for (i = 0; i < SIM_EVENTS; i++)
+    {
+        if ((g_events[i].event != NULL) && (g_events[i].at < next))
+        {
+            next = g_events[i].at;
+        }
+    }
+
+    return next;
+}
+
+/* Raise the EIC interrupt on a new IRQ assertion. An edge while CS is
+   high starts an IRQ response measurement, ended by the next CS assert. */
+static void sim_irq_update(void)
+{
+    bool asserted = ata8510_model_irq(&sim_model);
+
+    if ((asserted == true) && (g_irq_asserted == false))
+    {
+        g_cpu.edges++;
+        if ((sim_model.cs_low == false) && (g_irq_edge == SIM_NONE))
+        {
+            g_irq_edge = g_now;
+        }
+        if ((g_eic_enabled == true) && (g_eic_callback != NULL))
+        {
+            g_eic_callback(g_eic_context);
+        }
+    }
+    g_irq_asserted = asserted;
+}
+
+/* Fire everything due at g_now */
+static void sim_dispatch(void)
+{
+    sim_event_t event;
+    uint8_t i;
+
+    if (g_timer_expiry <= g_now)
+    {
+        g_timer_expiry = SIM_NONE;
+        if (g_timer_callback != NULL)
+        {
+            g_timer_callback(TC_TIMER_STATUS_OVERFLOW, g_timer_context);
+        }
+    }
+    if (g_tick_expiry <= g_now)
+    {
+        g_tick_expiry += SIM_TICK_NS;
+        if (g_tick_callback != NULL)
+        {
+            g_tick_callback(TC_TIMER_STATUS_OVERFLOW, g_tick_context);
+        }
+    }
+    ata8510_model_advance(&sim_model, g_now);
+    for (i = 0; i < SIM_EVENTS; i++)
+    {
+        if ((g_events[i].event != NULL) && (g_events[i].at <= g_now))
+        {
+            event = g_events[i].event;
+            g_events[i].event = NULL;
+            event(g_events[i].context);
+        }
+    }
+    sim_irq_update();
+}
+
+static void sim_run_until(uint64_t target)
+{
+    uint64_t next;
+
+    for (;;)
+    {
+        next = sim_next_event();
+        if ((next > target) || (next == SIM_NONE))
+        {
+            break;
+        }
+        if (next > g_now)
+        {
+            g_now = next;
+        }
+        if ((g_running == true) && (g_now > g_deadline))
+        {
+            longjmp(g_run_exit, SIM_RUN_DEADLINE);
+        }
+        sim_dispatch();
+    }
+    if (target > g_now)
+    {
+        g_now = target;
+    }
+    if ((g_running == true) && (g_now > g_deadline))
+    {
+        longjmp(g_run_exit, SIM_RUN_DEADLINE);
+    }
+}
+
+static void sim_pin(SYS_PORT_PIN pin, bool level)
+{
+    switch (pin)
+    {
+        case SYS_PORT_PIN_PA17:
+            if ((level == false) && (g_irq_edge != SIM_NONE))
+            {
+                g_cpu.responses++;
+                g_cpu.response_total_ns += g_now - g_irq_edge;
+                if ((g_now - g_irq_edge) > g_cpu.response_max_ns)
+                {
+                    g_cpu.response_max_ns = g_now - g_irq_edge;
+                }
+                g_irq_edge = SIM_NONE;
+            }
+            ata8510_model_cs(&sim_model, level, g_now);
+            break;
+        case SYS_PORT_PIN_PA20:
+            ata8510_model_npwron(&sim_model, level, g_now);
+            break;
+        case SYS_PORT_PIN_PA21:
+            ata8510_model_nreset(&sim_model, level, g_now);
+            break;
+        default:
+            break;
+    }
+    sim_irq_update();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulator Interface
+// *****************************************************************************
+// *****************************************************************************
+
+void sim_reset(void)
+{
+    g_now = 0;
+    g_deadline = SIM_NONE;
+    g_hook = NULL;
+    memset(g_events, 0, sizeof(g_events));
+    memset(g_buttons, 0, sizeof(g_buttons));
+    memset(g_oled, 0, sizeof(g_oled));
+    g_uart_length = 0;
+    g_uart[0] = '\0';
+    g_uart_echo = (getenv("SIM_UART") != NULL);
+    g_timer_expiry = SIM_NONE;
+    g_tick_expiry = SIM_NONE;
+    g_tick_callback = NULL;
+    g_timer_callback = NULL;
+    g_eic_callback = NULL;
+    g_eic_enabled = true;
+    g_irq_asserted = false;
+    g_irq_edge = SIM_NONE;
+    memset(&g_cpu, 0, sizeof(g_cpu));
+    g_wfi_start = SIM_NONE;
+    ata8510_model_init(&sim_model);
+}
+
+uint64_t sim_now(void)
+{
+    return g_now;
+}
+
+void sim_advance(uint64_t ns)
+{
+    sim_run_until(g_now + ns);
+}
+
+bool sim_at(uint64_t at, sim_event_t event, uintptr_t context)
+{
+    uint8_t i;
+
+    for (i = 0; i < SIM_EVENTS; i++)
+    {
+        if (g_events[i].event == NULL)
+        {
+            g_events[i].at = at;
+            g_events[i].event = event;
+            g_events[i].context = context;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+sim_run_t sim_run(int (*entry)(void), sim_hook_t hook, uint64_t deadline)
+{
+    int result;
+
+    g_hook = hook;
+    g_deadline = deadline;
+    result = setjmp(g_run_exit);
+    if (result == 0)
+    {
+        g_running = true;
+        (void)entry();
+        result = SIM_RUN_RETURN;
+    }
+    g_running = false;
+    g_hook = NULL;
+
+    return (sim_run_t)result;
+}
+
+void sim_loop(void)
+{
+    if ((g_hook != NULL) && (g_hook() == false))
+    {
+        longjmp(g_run_exit, SIM_RUN_HOOK);
+    }
+    sim_advance(SIM_LOOP_NS);
+}
+
+/* Nothing runs until the next interrupt: skip to it */
+void sim_wfi(void)
+{
+    uint64_t next = sim_next_event();
+
+    g_wfi_start = g_now;
+
+    if (next == SIM_NONE)
+    {
+        /* No interrupt source armed, the deadline ends the run */
+        sim_advance(SIM_MS(1));
+    }
+    else if (next > g_now)
+    {
+        sim_run_until(next);
+    }
+    else
+    {
+        sim_dispatch();
+    }
+    g_cpu.sleep_ns += g_now - g_wfi_start;
+    g_wfi_start = SIM_NONE;
+}
+
+void sim_cpu_stats(sim_cpu_stats_t *stats)
+{
+    *stats = g_cpu;
+    /* Called from an event while asleep */
+    if (g_wfi_start != SIM_NONE)
+    {
+        stats->sleep_ns += g_now - g_wfi_start;
+    }
+}
+
+void sim_button_set(uint8_t button, bool pressed)
+{
+    if (button < 4U)
+    {
+        g_buttons[button] = pressed;
+    }
+}
+
+uint8_t sim_button_get(uint8_t button)
+{
+    return ((button < 4U) && (g_buttons[button] == true)) ? 0U : 1U;
+}
+
+const char *sim_uart_text(void)
+{
+    return g_uart;
+}
+
+bool sim_uart_contains(const char *text)
+{
+    return (strstr(g_uart, text) != NULL);
+}
+
+void sim_uart_clear(void)
+{
+    g_uart_length = 0;
+    g_uart[0] = '\0';
+}
+
+void sim_report(const char *name)
+{
+    uint8_t i;
+
+    printf("  %-22s time %9.3f ms  telegrams %5lu  bytes %6lu  CS low %9.3f ms  SCK %8.3f ms  SCK rate %lu Hz\n",
+        name, (double)g_now / 1e6, (unsigned long)sim_model.telegrams, (unsigned long)sim_model.bytes,
+        (double)sim_model.cs_low_ns / 1e6, (double)sim_model.shift_ns / 1e6, (unsigned long)sim_model.sck);
+    printf("  %-22s violations T0 %lu T1 %lu T4 %lu T5 %lu  SCK errors %lu  RX missed %lu\n", "",
+        (unsigned long)sim_model.violations[ATA8510_MODEL_T0], (unsigned long)sim_model.violations[ATA8510_MODEL_T1],
+        (unsigned long)sim_model.violations[ATA8510_MODEL_T4], (unsigned long)sim_model.violations[ATA8510_MODEL_T5],
+        (unsigned long)sim_model.sck_errors, (unsigned long)sim_model.rx_missed);
+    printf("  %-22s IRQ edges %lu  response avg %.1f us max %.1f us  asleep %.1f %%\n", "",
+        (unsigned long)g_cpu.edges,
+        (g_cpu.responses != 0U) ? ((double)g_cpu.response_total_ns / g_cpu.responses / 1e3) : 0.0,
+        (double)g_cpu.response_max_ns / 1e3, (g_now != 0U) ? ((double)g_cpu.sleep_ns * 100.0 / g_now) : 0.0);
+    printf("  %-22s commands", "");
+    for (i = 0; i < 32U; i++)
+    {
+        if (sim_model.opcodes[i] != 0U)
+        {
+            printf(" %02X:%lu", i, (unsigned long)sim_model.opcodes[i]);
+        }
+    }
+    printf("\n");
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Peripheral Stand-ins
+// *****************************************************************************
+// *****************************************************************************
+
+bool sim_spi_setup(SPI_TRANSFER_SETUP *setup, uint32_t spiSourceClock)
+{
+    (void)spiSourceClock;
+    sim_model.sck = setup->clockFrequency;
+
+    return true;
+}
+
+bool sim_spi_write_read(void *pTransmitData, size_t txSize, void *pReceiveData, size_t rxSize)
+{
+    const uint8_t *tx = (const uint8_t *)pTransmitData;
+    uint8_t *rx = (uint8_t *)pReceiveData;
+    uint64_t byte_ns = (8000000000ULL + sim_model.sck - 1U) / sim_model.sck;
+    size_t size = (txSize > rxSize) ? txSize : rxSize;
+    size_t i;
+    uint8_t miso;
+
+    for (i = 0; i < size; i++)
+    {
+        sim_advance(byte_ns);
+        /* The SERCOM PLIB clocks 0xFF once the transmit data is used up */
+        miso = ata8510_model_transfer(&sim_model, ((tx != NULL) && (i < txSize)) ? tx[i] : 0xFF, g_now);
+        if ((rx != NULL) && (i < rxSize))
+        {
+            rx[i] = miso;
+        }
+        sim_irq_update();
+    }
+
+    return true;
+}
+
+void EIC_CallbackRegister(EIC_PIN pin, EIC_CALLBACK callback, uintptr_t context)
+{
+    if (pin == EIC_PIN_14)
+    {
+        g_eic_callback = callback;
+        g_eic_context = context;
+    }
+}
+
+void EIC_InterruptEnable(EIC_PIN pin)
+{
+    if (pin == EIC_PIN_14)
+    {
+        g_eic_enabled = true;
+    }
+}
+
+void EIC_InterruptDisable(EIC_PIN pin)
+{
+    if (pin == EIC_PIN_14)
+    {
+        g_eic_enabled = false;
+    }
+}
+
+uint32_t sim_timer_frequency_get(void)
+{
+    return SIM_CPU_HZ;
+}
+
+void sim_timer_start(void)
+{
+    g_timer_expiry = g_now + (((uint64_t)g_timer_period + 1U) * 1000000000ULL + SIM_CPU_HZ - 1U) / SIM_CPU_HZ;
+}
+
+void sim_timer_period_set(uint16_t period)
+{
+    g_timer_period = period;
+}
+
+void sim_timer_command(TC_COMMAND command)
+{
+    if (command == TC_COMMAND_START_RETRIGGER)
+    {
+        sim_timer_start();
+    }
+    else if (command == TC_COMMAND_STOP)
+    {
+        g_timer_expiry = SIM_NONE;
+    }
+    else
+    {
+        /* Not used by the driver */
+    }
+}
+
+void sim_timer_callback_register(TC_TIMER_CALLBACK callback, uintptr_t context)
+{
+    g_timer_callback = callback;
+    g_timer_context = context;
+}
+
+uint32_t sim_trace_counter_get(void)
+{
+    return (uint32_t)((g_now * (SIM_CPU_HZ / 1000000UL)) / 1000U) & 0xFFFFFFU;
+}
+
+uint32_t sim_trace_frequency_get(void)
+{
+    return SIM_CPU_HZ;
+}
+
+void sim_trace_counter_start(void)
+{
+}
+
+void SYS_PORT_PinWrite(SYS_PORT_PIN pin, bool value)
+{
+    sim_pin(pin, value);
+}
+
+bool SYS_PORT_PinRead(SYS_PORT_PIN pin)
+{
+    /* IRQ is active low */
+    return (pin == SYS_PORT_PIN_PB14) ? !ata8510_model_irq(&sim_model) : true;
+}
+
+void SYS_PORT_PinSet(SYS_PORT_PIN pin)
+{
+    sim_pin(pin, true);
+}
+
+void SYS_PORT_PinClear(SYS_PORT_PIN pin)
+{
+    sim_pin(pin, false);
+}
+
+uint32_t SYS_TIME_FrequencyGet(void)
+{
+    return SIM_CPU_HZ;
+}
+
+uint32_t SYS_TIME_CounterGet(void)
+{
+    return (uint32_t)((g_now * (SIM_CPU_HZ / 1000000UL)) / 1000U);
+}
+
+uint32_t SYS_TIME_CountToUS(uint32_t count)
+{
+    return count / (SIM_CPU_HZ / 1000000UL);
+}
+
+uint32_t SYS_TIME_CountToMS(uint32_t count)
+{
+    return count / (SIM_CPU_HZ / 1000UL);
+}
+
+uint32_t SYS_TIME_USToCount(uint32_t us)
+{
+    return us * (SIM_CPU_HZ / 1000000UL);
+}
+
+uint32_t SYS_TIME_MSToCount(uint32_t ms)
+{
+    return ms * (SIM_CPU_HZ / 1000UL);
+}
+
+void SYSTICK_DelayMs(uint32_t delay_ms)
+{
+    sim_advance(SIM_MS(delay_ms));
+}
+
+void SYSTICK_DelayUs(uint32_t delay_us)
+{
+    sim_advance(SIM_US(delay_us));
+}
+
+bool SERCOM4_USART_Write(void *buffer, const size_t size)
+{
+    const char *text = (const char *)buffer;
+    size_t length = strnlen(text, size);
+
+    if ((g_uart_length + length) < sizeof(g_uart))
+    {
+        memcpy(&g_uart[g_uart_length], text, length);
+        g_uart_length += length;
+        g_uart[g_uart_length] = '\0';
+    }
+    if (g_uart_echo == true)
+    {
+        fwrite(text, 1, length, stdout);
+    }
+    /* Blocking write, start and stop bit per byte */
+    sim_advance(((uint64_t)size * 10U * 1000000000ULL) / SIM_UART_BAUD);
+
+    return true;
+}
+
+void TC0_TimerCallbackRegister(TC_TIMER_CALLBACK callback, uintptr_t context)
+{
+    g_tick_callback = callback;
+    g_tick_context = context;
+}
+
+void TC0_TimerStart(void)
+{
+    g_tick_expiry = g_now + SIM_TICK_NS;
+}
+
+void TC2_TimerCallbackRegister(TC_TIMER_CALLBACK callback, uintptr_t context)
+{
+    (void)callback;
+    (void)context;
+}
+
+void TC2_TimerStart(void)
+{
+}
+
+/* OLED display, text output is not modeled, pixel columns are kept */
+void oled_init(void)
+{
+}
+
+void oled_clear(void)
+{
+    memset(g_oled, 0, sizeof(g_oled));
+}
+
+void oled_pixel(char px[], uint8_t x)
+{
+    if (x < 128U)
+    {
+        g_oled[x] = (uint32_t)(uint8_t)px[0] | ((uint32_t)(uint8_t)px[1] << 8) |
+                    ((uint32_t)(uint8_t)px[2] << 16) | ((uint32_t)(uint8_t)px[3] << 24);
+    }
+}
+
+uint32_t sim_oled_column(uint8_t x)
+{
+    return (x < 128U) ? g_oled[x] : 0U;
+}
+
+void oled_string(char *str, uint8_t x, uint8_t y)
+{
+    (void)str;
+    (void)x;
+    (void)y;
+}
@@ -0,0 +1,163 @@
+/*******************************************************************************
+  ATA8510 Host Simulator
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sim_platform.h
+
+  Summary:
+    Simulated platform of the ATA8510 host build
+
+  Description:
+    Simulation clock and event scheduler, and the SERCOM SPI, TC guard
+    timer, TCC trace counter, pins, UART and button stand-ins that the host
+    build of the driver and of main.c run on. Time only advances through
+    modeled bus transfers, guard timers, delays, UART output and a fixed
+    cost per superloop pass; driver code itself runs in zero time.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+* 
+* The software and documentation is provided by microchip and its contributors
+* "as is" and any express, implied or statutory warranties, including, but not
+* limited to, the implied warranties of merchantability, fitness for a particular
+* purpose and non-infringement of third party intellectual property rights are
+* disclaimed to the fullest extent permitted by law. In no event shall microchip
+* or its contributors be liable for any direct, indirect, incidental, special,
+* exemplary, or consequential damages (including, but not limited to, procurement
+* of substitute goods or services; loss of use, data, or profits; or business
+* interruption) however caused and on any theory of liability, whether in contract,
+* strict liability, or tort (including negligence or otherwise) arising in any way
+* out of the use of the software and documentation, even if advised of the
+* possibility of such damage.
+* 
+* Except as expressly permitted hereunder and subject to the applicable license terms
+* for any third-party software incorporated in the software and any applicable open
+* source software license terms, no license or other rights, whether express or
+* implied, are granted under any patent or other intellectual property rights of
+* Microchip or any third party.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _SIM_PLATFORM_H
+#define _SIM_PLATFORM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "peripheral/sercom/spi_master/plib_sercom_spi_master_common.h"
+#include "peripheral/tc/plib_tc_common.h"
+#include "ata8510_model.h"
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+    extern "C" {
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_NONE                UINT64_MAX
+#define SIM_US(us)              ((uint64_t)(us) * 1000ULL)
+#define SIM_MS(ms)              ((uint64_t)(ms) * 1000000ULL)
+
+/* Cost of one superloop pass (SYS_Tasks call) */
+#define SIM_LOOP_NS             (2000U)
+/* SysTick / SYS_TIME and TCC0 rate of the board */
+#define SIM_CPU_HZ              (48000000UL)
+/* TC0 period, button and telegram timing of main.c */
+#define SIM_TICK_NS             SIM_MS(10)
+/* SERCOM4 USART */
+#define SIM_UART_BAUD           (38400UL)
+#define SIM_UART_LENGTH         (65536U)
+#define SIM_EVENTS              (16U)
+
+typedef void (*sim_event_t)(uintptr_t context);
+
+/* CPU side of the IRQ line */
+typedef struct
+{
+    uint32_t            edges;              // IRQ assertions, EIC interrupts if registered
+    uint32_t            responses;          // edges while CS high answered by a telegram
+    uint64_t            response_total_ns;  // edge to the next CS assert
+    uint64_t            response_max_ns;
+    uint64_t            sleep_ns;           // time spent in WFI
+} sim_cpu_stats_t;
+
+/* Called once per superloop pass, returning false ends sim_run() */
+typedef bool (*sim_hook_t)(void);
+
+typedef enum
+{
+    SIM_RUN_HOOK = 1,       // hook asked to stop, longjmp() value
+    SIM_RUN_RETURN,         // entry returned
+    SIM_RUN_DEADLINE,       // simulation time passed the deadline
+} sim_run_t;
+
+extern ata8510_model_t sim_model;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/* Time 0, transceiver model at power-on defaults, pins high, UART empty */
+void sim_reset(void);
+
+uint64_t sim_now(void);
+
+/* Advance the clock, firing timer, model and scenario events on the way */
+void sim_advance(uint64_t ns);
+
+/* Scenario event at absolute time at */
+bool sim_at(uint64_t at, sim_event_t event, uintptr_t context);
+
+/* Run entry until it returns, hook returns false or deadline is reached */
+sim_run_t sim_run(int (*entry)(void), sim_hook_t hook, uint64_t deadline);
+
+/* Superloop pass, called from SYS_Tasks() */
+void sim_loop(void);
+
+/* IRQ response and sleep time since sim_reset() */
+void sim_cpu_stats(sim_cpu_stats_t *stats);
+
+void sim_button_set(uint8_t button, bool pressed);
+
+/* OLED pixel column x as drawn by oled_pixel(), bit n = row n from the top */
+uint32_t sim_oled_column(uint8_t x);
+
+const char *sim_uart_text(void);
+bool sim_uart_contains(const char *text);
+void sim_uart_clear(void);
+
+/* Print bus and timing statistics of the transceiver model */
+void sim_report(const char *name);
+
+/* SERCOM1 SPI master */
+bool sim_spi_setup(SPI_TRANSFER_SETUP *setup, uint32_t spiSourceClock);
+bool sim_spi_write_read(void *pTransmitData, size_t txSize, void *pReceiveData, size_t rxSize);
+
+/* TC4 one-shot guard timer */
+uint32_t sim_timer_frequency_get(void);
+void sim_timer_start(void);
+void sim_timer_period_set(uint16_t period);
+void sim_timer_command(TC_COMMAND command);
+void sim_timer_callback_register(TC_TIMER_CALLBACK callback, uintptr_t context);
+
+/* TCC0 free-running 24-bit trace counter */
+uint32_t sim_trace_counter_get(void);
+uint32_t sim_trace_frequency_get(void);
+void sim_trace_counter_start(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // #ifndef _SIM_PLATFORM_H
@@ -0,0 +1,1656 @@
+/*******************************************************************************
+  ATA8510 Host Simulator
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    test_runner.c
+
+  Summary:
+    Scenario runner of the ATA8510 host build
+
+  Description:
+    Runs the unmodified ATA8510 driver and the main.c packet handling
+    against the transceiver model. Every scenario runs in its own process so
+    driver and application globals start from their initial values, and
+    reports command counts and modeled bus time. Exit code is the number of
+    failed scenarios. Scenario names given on the command line select a
+    subset.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+* 
+* The software and documentation is provided by microchip and its contributors
+* "as is" and any express, implied or statutory warranties, including, but not
+* limited to, the implied warranties of merchantability, fitness for a particular
+* purpose and non-infringement of third party intellectual property rights are
+* disclaimed to the fullest extent permitted by law. In no event shall microchip
+* or its contributors be liable for any direct, indirect, incidental, special,
+* exemplary, or consequential damages (including, but not limited to, procurement
+* of substitute goods or services; loss of use, data, or profits; or business
+* interruption) however caused and on any theory of liability, whether in contract,
+* strict liability, or tort (including negligence or otherwise) arising in any way
+* out of the use of the software and documentation, even if advised of the
+* possibility of such damage.
+* 
+* Except as expressly permitted hereunder and subject to the applicable license terms
+* for any third-party software incorporated in the software and any applicable open
+* source software license terms, no license or other rights, whether express or
+* implied, are granted under any patent or other intellectual property rights of
+* Microchip or any third party.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "definitions.h"
+#include "sim_platform.h"
+#include "node/node_table.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            printf("  %s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+        }                                                                   \
+    } while (0)
+
+/* main.c telegram codes and modes */
+#define APP_TEMPDATA            (0x64)
+#define APP_TEMPDATA_ID         (0x65)
+#define APP_RSSIDATA            (0x60)
+#define APP_RXMODE              (0x32)
+#define APP_TXMODE              (0x31)
+#define APP_TXSERVICE           (0x40)
+#define APP_RX_CONFIG           (0x40)  // path A, service 0, channel 0
+/* First sensor telegram, after the 3 x 250 ms LED sequence of main() */
+#define APP_TELEGRAM_AT         SIM_MS(1000)
+#define APP_DUMP_TELEGRAM_AT    SIM_MS(1500)    // app_eeprom_dump: button 3 held, statistics shown
+#define APP_TELEGRAM_LENGTH     (4U)
+#define APP_NODE_A              (257U)
+#define APP_NODE_B              (514U)
+#define APP_EEPROM_FILE         "../programming_files/Remote_Sensor_ATA8510_EEPROM_434MHz.eep"
+
+typedef struct
+{
+    const char          *name;
+    int                 (*entry)(void);
+    sim_hook_t          hook;
+    uint64_t            deadline;
+    void                (*setup)(void);
+    void                (*verify)(sim_run_t result);
+} scenario_t;
+
+/* main.c */
+extern int app_main(void);
+extern unsigned int msg_count;
+extern unsigned int err_count;
+extern unsigned int tot_count;
+extern bool rf_rx_busy;
+extern uint32_t rf_latency_count;
+extern uint32_t rf_latency_max;
+extern uint32_t rf_handler_max;
+extern uint32_t rf_ring_overflows;
+extern uint32_t rf_turnaround_max;
+extern uint8_t rf_ring_count(void);
+
+static unsigned int g_failures;
+static uint8_t g_reply_code;
+static bool g_reply_enable;
+/* End of the sensor telegram to start of the ACK on air */
+static uint64_t g_ack_latency;
+/* End of the ACK on air to RX mode for the reply */
+static uint64_t g_ack_end;
+static uint64_t g_rx_mode_latency;
+/* Button 2 pressed right after the ACK, released at g_release_at */
+static bool g_press_on_ack;
+static uint64_t g_release_at;
+static bool g_held_polling;             // handshake over, record not shown yet, right before the release
+/* Sensor telegrams app_hook_done() waits for, another one right after each reply while g_burst */
+static unsigned int g_telegrams;
+static unsigned int g_burst;
+static sim_cpu_stats_t g_cpu_idle;      // snapshots around the idle window before the telegram
+static sim_cpu_stats_t g_cpu_rx;
+/* Bus statistics when button 3 starts the EEPROM dump, and whether a short press dumped already */
+static bool g_dump_early;
+static uint64_t g_dump_start;
+static uint64_t g_dump_cs_low_ns;
+static uint32_t g_dump_reads;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Helpers
+// *****************************************************************************
+// *****************************************************************************
+
+static uint8_t app_checksum(const uint8_t *data, size_t length)
+{
+    uint8_t sum = 0;
+    size_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        sum += data[i];
+    }
+
+    return (uint8_t)(0xFFU - sum + 1U);
+}
+
+static uhf_dev_t *dev_start(void)
+{
+    SYS_Initialize(NULL);
+    uhf_power_on(sysObj.uhfSpi0);
+
+    return sysObj.uhfSpi0;
+}
+
+/* Let a telegram arrive over the air and finish */
+static void air_receive(const uint8_t *data, size_t length, uint8_t rssi)
+{
+    ata8510_model_rx_start(&sim_model, data, length, rssi, APP_RX_CONFIG, sim_now());
+    sim_advance(((uint64_t)length * 8U * 1000000000ULL) / sim_model.bitrate + SIM_US(100));
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Driver Scenarios
+// *****************************************************************************
+// *****************************************************************************
+
+static int scn_power_on(void)
+{
+    uhf_dev_t *dev = dev_start();
+    uint8_t flash[2];
+    uint8_t customer;
+    uint8_t events[4];
+
+    CHECK(sim_model.powered == true);
+    CHECK(sim_model.in_reset == false);
+    uhf_spi_get_event_bytes(dev, events);
+    CHECK((events[0] & ATA8510_MODEL_SYS_RDY) != 0U);
+    CHECK(uhf_spi_get_version_ROM(dev) == sim_model.rom_version);
+    CHECK(uhf_spi_get_version_flash(dev, flash, &customer) == sim_model.flash_version[0]);
+    CHECK(memcmp(flash, &sim_model.flash_version[1], 2U) == 0);
+    CHECK(customer == sim_model.customer);
+    CHECK(uhf_spi_read_temperature_value(dev) == sim_model.temperature);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+
+    return 0;
+}
+
+static int scn_speed_negotiate(void)
+{
+    const uint8_t scratch[] = { 0x12, 0x34, 0x56, 0x78 };
+    uhf_dev_t *dev = dev_start();
+    uint32_t speed;
+
+    memcpy(&sim_model.sram[UHF_SPI_SPEED_SCRATCH_ADDR], scratch, sizeof(scratch));
+    speed = uhf_spi_speed_negotiate(dev);
+    /* 2 MHz fails, one step of margin below the last good rate */
+    CHECK(speed == 1000000UL);
+    CHECK(uhf_spi_speed_get(dev) == speed);
+    CHECK(sim_model.sck == speed);
+    CHECK(memcmp(&sim_model.sram[UHF_SPI_SPEED_SCRATCH_ADDR], scratch, sizeof(scratch)) == 0);
+    CHECK(uhf_spi_get_version_ROM(dev) == sim_model.rom_version);
+
+    return 0;
+}
+
+static int scn_speed_fallback(void)
+{
+    uhf_dev_t *dev = dev_start();
+    uhf_spi_stats_t stats;
+    uint8_t events[4];
+    uint8_t i;
+
+    (void)uhf_spi_speed_negotiate(dev);
+    /* Supply drop: the transceiver no longer follows 1 MHz */
+    sim_model.sck_max = 600000UL;
+    for (i = 0; i < 8U; i++)
+    {
+        uhf_spi_get_event_bytes(dev, events);
+    }
+    uhf_spi_stats_get(dev, &stats);
+    CHECK(stats.speed_fallbacks >= 1U);
+    CHECK(uhf_spi_speed_get(dev) <= sim_model.sck_max);
+    CHECK(uhf_spi_get_version_ROM(dev) == sim_model.rom_version);
+
+    return 0;
+}
+
+static int scn_sram_eeprom(void)
+{
+    uint8_t data[] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+    uint8_t readback[sizeof(data)];
+    uhf_dev_t *dev = dev_start();
+    uint8_t i;
+
+    uhf_spi_write_sram_reg(dev, 0x0100, data, sizeof(data));
+    uhf_spi_read_sram_reg(dev, 0x0100, readback, sizeof(readback));
+    CHECK(memcmp(data, readback, sizeof(data)) == 0);
+
+    uhf_spi_write_eeprom(dev, 0x0020, 0x5A);
+    /* The command returns before the cell is programmed */
+    delay_ms(5);
+    CHECK(uhf_spi_read_eeprom(dev, 0x0020) == 0x5A);
+    CHECK(sim_model.eeprom[0x0020] == 0x5A);
+
+    CHECK(uhf_spi_write_eeprom_block(dev, 0x0040, data, sizeof(data)) == true);
+    for (i = 0; i < sizeof(data); i++)
+    {
+        CHECK(uhf_spi_read_eeprom(dev, (uint16_t)(0x0040U + i)) == data[i]);
+    }
+    CHECK(sim_model.eeprom_writes == (1U + sizeof(data)));
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+
+    return 0;
+}
+
+static void cmd_count_callback(const uhf_spi_cmd_t *cmd, uintptr_t context)
+{
+    (*(unsigned int *)context)++;
+}
+
+static int scn_fifo_drain(void)
+{
+    const uint8_t telegram[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A };
+    uint8_t rx[32];
+    uint8_t rssi[32];
+    uhf_spi_drain_t drain = { .rx_data = rx, .rx_size = sizeof(rx), .rssi_data = rssi, .rssi_size = sizeof(rssi) };
+    uhf_dev_t *dev = dev_start();
+    uint8_t events[4];
+    unsigned int done = 0U;
+    const uhf_spi_cmd_t cmd = { .id = UHF_SPI_CMD_GET_EVENT_BYTES, .data = events, .callback = cmd_count_callback,
+                                .context = (uintptr_t)&done };
+    const uhf_spi_cmd_t chain[3] = { cmd, cmd, cmd };
+    uint8_t i;
+
+    uhf_spi_get_event_bytes(dev, events);
+    uhf_spi_set_system_mode(dev, APP_RXMODE, 0x00);
+    CHECK(uhf_irq_get(dev) == true);
+    air_receive(telegram, sizeof(telegram), 0x50);
+    CHECK(uhf_irq_get(dev) == false);
+    CHECK(uhf_spi_read_fill_level_rx_fifo(dev) == sizeof(telegram));
+
+    uhf_spi_drain(dev, &drain);
+    CHECK(drain.rx_length == sizeof(telegram));
+    CHECK(memcmp(rx, telegram, sizeof(telegram)) == 0);
+    CHECK(drain.rssi_length == sizeof(telegram));
+    CHECK(rssi[0] == 0x50);
+    CHECK((drain.events.trx & 0x70U) == 0x70U);
+    CHECK(sim_model.rx.count == 0U);
+
+    uhf_spi_get_event_bytes(dev, events);
+    CHECK(events[3] == APP_RX_CONFIG);
+    CHECK(uhf_irq_get(dev) == true);
+
+    /* A chain is queued whole or not at all */
+    for (i = 0; i < (UHF_SPI_QUEUE_LENGTH - 2U); i++)
+    {
+        CHECK(uhf_spi_submit(dev, &cmd) == true);
+    }
+    CHECK(uhf_spi_submit_chain(dev, chain, 3U) == false);
+    CHECK(uhf_spi_submit_chain(dev, chain, 2U) == true);
+    CHECK(uhf_spi_submit_chain(dev, chain, 1U) == false);
+    while (uhf_spi_is_idle(dev) == false)
+    {
+        SYS_Tasks();
+    }
+    CHECK(done == UHF_SPI_QUEUE_LENGTH);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+
+    return 0;
+}
+
+static int scn_byte_int_read(void)
+{
+    const uint8_t telegram[] = { 0xA1, 0xB2, 0xC3, 0xD4, 0xE5 };
+    uint8_t rx[sizeof(telegram)];
+    uint8_t rssi[sizeof(telegram)];
+    uhf_dev_t *dev = dev_start();
+
+    uhf_spi_set_system_mode(dev, APP_RXMODE, 0x00);
+    air_receive(telegram, sizeof(telegram), 0x42);
+    uhf_spi_read_rx_fifo_byte_int(dev, rx, sizeof(rx));
+    CHECK(memcmp(rx, telegram, sizeof(telegram)) == 0);
+    uhf_spi_read_rssi_fifo_byte_int(dev, rssi, sizeof(rssi));
+    CHECK(rssi[sizeof(rssi) - 1U] == 0x42);
+    CHECK(sim_model.rx.count == 0U);
+    CHECK(sim_model.rssi.count == 0U);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+
+    return 0;
+}
+
+/* One long telegram through the stream, IRQ polled like main() does */
+static bool stream_receive(uhf_dev_t *dev, uhf_spi_stream_rx_t *stream, const uint8_t *data, size_t length,
+                           uint64_t *done)
+{
+    uint64_t start = sim_now();
+    uint64_t deadline = start + ((uint64_t)length * 8U * 1000000000ULL) / sim_model.bitrate + SIM_MS(10);
+
+    ata8510_model_rx_start(&sim_model, data, length, 0x44, APP_RX_CONFIG, start);
+    while ((stream->complete == false) && (sim_now() < deadline))
+    {
+        if ((stream->busy == false) && (uhf_irq_get(dev) == false))
+        {
+            CHECK(uhf_spi_stream_rx_submit(dev, stream) == true);
+            CHECK(uhf_spi_stream_rx_submit(dev, stream) == false);
+        }
+        SYS_Tasks();
+    }
+    *done = sim_now() - start;
+
+    return stream->complete;
+}
+
+/* Telegrams longer than the DFIFO, drained on the fill level event */
+static int scn_stream_rx(void)
+{
+    static const uint32_t rate[] = { 8000UL, 20000UL, 40000UL, 80000UL, 160000UL };
+    static uint8_t telegram[300];
+    static uint8_t buffer[320];
+    uhf_spi_stream_rx_t stream;
+    uhf_dev_t *dev = dev_start();
+    uint8_t events[4];
+    uint64_t done;
+    uint64_t air;
+    uint16_t i;
+    uint8_t r;
+
+    for (i = 0; i < sizeof(telegram); i++)
+    {
+        telegram[i] = (uint8_t)(i * 7U + 3U);
+    }
+    uhf_spi_speed_negotiate(dev);
+    uhf_spi_get_event_bytes(dev, events);
+    sim_model.dfifo_level = 16U;
+
+    for (r = 0; r < (sizeof(rate) / sizeof(rate[0])); r++)
+    {
+        sim_model.bitrate = rate[r];
+        uhf_spi_set_system_mode(dev, APP_RXMODE, 0x00);
+        uhf_spi_stream_rx_init(&stream, buffer, sizeof(buffer));
+        CHECK(stream_receive(dev, &stream, telegram, sizeof(telegram), &done) == true);
+        air = ((uint64_t)sizeof(telegram) * 8U * 1000000000ULL) / rate[r];
+        printf("  %-22s %3lu kbit/s: %u bytes in %2u reads, %.3f ms after EOT, %.1f kbit/s, fill max %2u%s\n", "",
+               (unsigned long)(rate[r] / 1000UL), (unsigned)stream.length, (unsigned)stream.reads,
+               (double)(done - air) / 1e6, (double)stream.length * 8e6 / (double)done, (unsigned)stream.fill_max,
+               (stream.overrun == true) ? ", overrun" : "");
+        CHECK(stream.length == sizeof(telegram));
+        CHECK(memcmp(buffer, telegram, sizeof(telegram)) == 0);
+        CHECK(stream.overrun == false);
+        uhf_spi_set_system_mode(dev, 0x00, 0x00);
+        sim_model.rssi.count = 0U;
+    }
+
+    /* Threshold without headroom: bytes are lost and reported */
+    sim_model.dfifo_level = 32U;
+    uhf_spi_set_system_mode(dev, APP_RXMODE, 0x00);
+    uhf_spi_stream_rx_init(&stream, buffer, sizeof(buffer));
+    CHECK(stream_receive(dev, &stream, telegram, sizeof(telegram), &done) == true);
+    CHECK(stream.overrun == true);
+    CHECK(stream.length < sizeof(telegram));
+    CHECK(sim_model.rx.overruns == (sizeof(telegram) - stream.length));
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+
+    return 0;
+}
+
+/* One long telegram out through the stream, refilled on IRQ */
+static bool stream_send(uhf_dev_t *dev, uhf_spi_stream_tx_t *stream, const uint8_t *data, uint16_t length,
+                        uint64_t *done)
+{
+    uint64_t start = sim_now();
+    uint64_t deadline = start + ((uint64_t)length * 8U * 1000000000ULL) / sim_model.bitrate + SIM_MS(10);
+
+    CHECK(uhf_spi_stream_tx_start(dev, stream, data, length, APP_TXMODE, APP_TXSERVICE) == true);
+    while ((stream->complete == false) && (sim_now() < deadline))
+    {
+        if ((stream->busy == false) && (uhf_irq_get(dev) == false))
+        {
+            CHECK(uhf_spi_stream_tx_submit(dev, stream) == true);
+            CHECK(uhf_spi_stream_tx_submit(dev, stream) == false);
+        }
+        SYS_Tasks();
+    }
+    *done = sim_now() - start;
+
+    return stream->complete;
+}
+
+/* Telegrams longer than the DFIFO, refilled on the fill level event */
+static int scn_stream_tx(void)
+{
+    static const uint32_t rate[] = { 8000UL, 20000UL, 160000UL };
+    static uint8_t telegram[300];
+    uhf_spi_stream_tx_t stream;
+    uhf_dev_t *dev = dev_start();
+    uint8_t events[4];
+    uint64_t done;
+    uint64_t air;
+    uint16_t i;
+    uint8_t r;
+
+    for (i = 0; i < sizeof(telegram); i++)
+    {
+        telegram[i] = (uint8_t)(i * 5U + 1U);
+    }
+    uhf_spi_speed_negotiate(dev);
+    sim_model.dfifo_level = 16U;
+
+    for (r = 0; r < (sizeof(rate) / sizeof(rate[0])); r++)
+    {
+        sim_model.bitrate = rate[r];
+        uhf_spi_get_event_bytes(dev, events);
+        CHECK(stream_send(dev, &stream, telegram, sizeof(telegram), &done) == true);
+        air = ((uint64_t)sizeof(telegram) * 8U * 1000000000ULL) / rate[r];
+        printf("  %-22s %3lu kbit/s: %u bytes in %2u writes, on air %.3f ms, done %.3f ms later, fill min %2u\n", "",
+               (unsigned long)(rate[r] / 1000UL), (unsigned)stream.written, (unsigned)stream.writes,
+               (double)air / 1e6, (double)(done - air) / 1e6, (unsigned)stream.fill_min);
+        CHECK(stream.underrun == false);
+        CHECK(sim_model.tx_air_length == sizeof(telegram));
+        CHECK(memcmp(sim_model.tx_air, telegram, sizeof(telegram)) == 0);
+        uhf_spi_set_system_mode(dev, 0x00, 0x00);
+    }
+
+    /* Refilled too late: the telegram ends early and that is reported */
+    sim_model.dfifo_level = 1U;
+    uhf_spi_get_event_bytes(dev, events);
+    CHECK(stream_send(dev, &stream, telegram, sizeof(telegram), &done) == true);
+    CHECK(stream.underrun == true);
+    CHECK(sim_model.tx_air_length < sizeof(telegram));
+    CHECK(memcmp(sim_model.tx_air, telegram, sim_model.tx_air_length) == 0);
+    CHECK(sim_model.tx_telegrams == (sizeof(rate) / sizeof(rate[0])) + 1U);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+
+    return 0;
+}
+
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+/* Four channels at different levels, with and without noise */
+static int scn_rssi_survey(void)
+{
+    static const uint8_t level[] = { 0x50, 0x30, 0x60, 0x20 };
+    uhf_spi_rssi_channel_t channels[4] = { { .config = 0x40 }, { .config = 0x50 }, { .config = 0x60 }, { .config = 0x70 } };
+    uhf_spi_rssi_survey_t survey = { .channels = channels, .count = 4U, .samples = 16U, .percentile = 90U };
+    uhf_spi_rssi_channel_t *channel;
+    uhf_dev_t *dev = dev_start();
+    uint32_t sample_ns;
+    uint8_t i;
+
+    uhf_spi_speed_negotiate(dev);
+    for (i = 0; i < 4U; i++)
+    {
+        sim_model.rssi_level[8U * i] = level[i];
+    }
+
+    /* Constant levels: every statistic is the level itself */
+    CHECK(uhf_spi_rssi_survey(dev, &survey) == true);
+    CHECK(survey.done == true);
+    CHECK(survey.lost == 0U);
+    for (i = 0; i < 4U; i++)
+    {
+        CHECK(channels[i].samples == 16U);
+        CHECK(channels[i].min == level[i]);
+        CHECK(channels[i].max == level[i]);
+        CHECK(channels[i].percentile == level[i]);
+        CHECK(channels[i].mean == ((uint16_t)level[i] << 8));
+        CHECK(channels[i].peak == (level[i] + 3U));
+    }
+    /* One start and one read per sample, plus the reads of a foreign IRQ */
+    CHECK(sim_model.opcodes[UHF_SPI_CMD_START_RSSI_MEAS] == 64U);
+    CHECK(sim_model.opcodes[UHF_SPI_CMD_GET_RSSI_VALUE] == (64U + survey.polls));
+    sample_ns = (uint32_t)(((uint64_t)survey.duration_us * 1000U) / 64U);
+    printf("  %-22s %u us per sample, %u us over the %u us measurement\n", "", (unsigned)(sample_ns / 1000U),
+           (unsigned)((sample_ns - sim_model.rssi_meas_ns) / 1000U), (unsigned)(sim_model.rssi_meas_ns / 1000U));
+    CHECK(sample_ns < (sim_model.rssi_meas_ns + 300000U));
+
+    /* Noise of 0 - 15: ordered statistics within the band */
+    sim_model.rssi_spread = 15U;
+    survey.samples = UHF_SPI_RSSI_SURVEY_SAMPLES;
+    CHECK(uhf_spi_rssi_survey(dev, &survey) == true);
+    for (i = 0; i < 4U; i++)
+    {
+        channel = &channels[i];
+        CHECK(channel->samples == UHF_SPI_RSSI_SURVEY_SAMPLES);
+        CHECK(channel->min >= level[i]);
+        CHECK(channel->max <= (level[i] + 15U));
+        CHECK(channel->min < channel->max);
+        CHECK(channel->percentile >= channel->min);
+        CHECK(channel->percentile <= channel->max);
+        CHECK(channel->mean >= ((uint16_t)channel->min << 8));
+        CHECK(channel->mean <= ((uint16_t)channel->max << 8));
+        CHECK(((channel->mean >> 8) >= level[i] + 4U) && ((channel->mean >> 8) <= level[i] + 11U));
+        CHECK(channel->peak == (channel->max + 3U));
+        printf("  %-22s 0x%02X min %3u mean %7.3f P90 %3u max %3u\n", "", channel->config, channel->min,
+               (double)channel->mean / 256.0, channel->percentile, channel->max);
+    }
+
+    /* Out of range, nothing measured */
+    survey.samples = 0U;
+    CHECK(uhf_spi_rssi_survey_submit(dev, &survey) == false);
+    survey.samples = UHF_SPI_RSSI_SURVEY_SAMPLES + 1U;
+    CHECK(uhf_spi_rssi_survey_submit(dev, &survey) == false);
+    survey.samples = 1U;
+    survey.percentile = 0U;
+    CHECK(uhf_spi_rssi_survey_submit(dev, &survey) == false);
+
+    /* Results slower than UHF_SPI_RSSI_TIMEOUT_US are counted and measured again */
+    sim_model.rssi_meas_ns = UHF_SPI_RSSI_TIMEOUT_US * 1000U + 5000000U;
+    survey.percentile = 50U;
+    survey.count = 1U;
+    CHECK(uhf_spi_rssi_survey(dev, &survey) == true);
+    CHECK(survey.lost != 0U);
+    CHECK(channels[0].samples == 1U);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+
+    return 0;
+}
+#endif
+
+/* Bulk SRAM and EEPROM dumps into a RAM buffer */
+static int scn_dump(void)
+{
+    static uint8_t image[ATA8510_MODEL_EEPROM_SIZE];
+    uhf_spi_dump_buffer_t buffer = { .data = image, .size = sizeof(image) };
+    uhf_dev_t *dev = dev_start();
+    uint32_t telegrams;
+    uint64_t start;
+    uint64_t sram;
+    uint64_t sram_single;
+    uint64_t eeprom;
+    uint64_t eeprom_single;
+    uint16_t i;
+
+    for (i = 0; i < ATA8510_MODEL_EEPROM_SIZE; i++)
+    {
+        sim_model.sram[0x0100U + i] = (uint8_t)(i * 7U);
+        sim_model.eeprom[i] = (uint8_t)(i ^ 0x5AU);
+    }
+
+    /* SRAM, one telegram per chunk */
+    telegrams = sim_model.opcodes[0x08];
+    start = sim_now();
+    CHECK(uhf_spi_dump(dev, UHF_SPI_DUMP_SRAM, 0x0100, 600, uhf_spi_dump_buffer_sink, (uintptr_t)&buffer) == 600U);
+    sram = sim_now() - start;
+    CHECK(buffer.length == 600U);
+    CHECK(memcmp(image, &sim_model.sram[0x0100], 600) == 0);
+    CHECK((sim_model.opcodes[0x08] - telegrams) == ((600U + UHF_SPI_DUMP_CHUNK_LENGTH - 1U) / UHF_SPI_DUMP_CHUNK_LENGTH));
+
+    /* Against reading it byte by byte */
+    start = sim_now();
+    for (i = 0; i < 600U; i++)
+    {
+        uhf_spi_read_sram_reg(dev, 0x0100U + i, &image[i], 1);
+    }
+    sram_single = sim_now() - start;
+    CHECK(memcmp(image, &sim_model.sram[0x0100], 600) == 0);
+    CHECK((sram * 5U) < sram_single);
+
+    /* Whole EEPROM */
+    buffer.length = 0;
+    start = sim_now();
+    CHECK(uhf_spi_dump(dev, UHF_SPI_DUMP_EEPROM, 0x0000, sizeof(image), uhf_spi_dump_buffer_sink,
+                       (uintptr_t)&buffer) == sizeof(image));
+    eeprom = sim_now() - start;
+    CHECK(memcmp(image, sim_model.eeprom, sizeof(image)) == 0);
+
+    /* "Read EEPROM" returns one byte per telegram, so the dump cannot beat
+       uhf_spi_read_eeprom() byte by byte: both run at the guard time bound */
+    memset(image, 0, sizeof(image));
+    start = sim_now();
+    for (i = 0; i < sizeof(image); i++)
+    {
+        image[i] = uhf_spi_read_eeprom(dev, i);
+    }
+    eeprom_single = sim_now() - start;
+    CHECK(memcmp(image, sim_model.eeprom, sizeof(image)) == 0);
+    CHECK(eeprom <= eeprom_single);
+
+    /* The sink stops it */
+    buffer.size = 100;
+    buffer.length = 0;
+    CHECK(uhf_spi_dump(dev, UHF_SPI_DUMP_EEPROM, 0x0000, 300, uhf_spi_dump_buffer_sink,
+                       (uintptr_t)&buffer) == UHF_SPI_DUMP_CHUNK_LENGTH);
+    CHECK(buffer.length == 100U);
+    CHECK(uhf_spi_is_idle(dev) == true);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+    printf("  %-22s 600 SRAM bytes in %.3f ms (byte by byte %.3f ms), %u EEPROM bytes in %.3f ms (byte by byte %.3f ms)\n",
+           "", (double)sram / 1e6, (double)sram_single / 1e6, (unsigned)sizeof(image), (double)eeprom / 1e6,
+           (double)eeprom_single / 1e6);
+
+    return 0;
+}
+
+#if (UHF_SPI_REGMAP_ENABLE == 1)
+/* Register map of the regmap scenario: three runs of contiguous registers
+   and a lone one */
+enum { REG_A0, REG_A1, REG_A2, REG_A3, REG_B0, REG_B1, REG_B2, REG_B3, REG_C0, REG_C1, REG_C2, REG_C3, REG_C4, REG_D0, REG_COUNT };
+static const uhf_spi_reg_t g_regs[REG_COUNT] =
+{
+    [REG_A0] = { 0x0100, 1 }, [REG_A1] = { 0x0101, 1 }, [REG_A2] = { 0x0102, 2 }, [REG_A3] = { 0x0104, 1 },
+    [REG_B0] = { 0x0120, 1 }, [REG_B1] = { 0x0121, 4 }, [REG_B2] = { 0x0125, 1 }, [REG_B3] = { 0x0126, 1 },
+    [REG_C0] = { 0x0140, 1 }, [REG_C1] = { 0x0141, 1 }, [REG_C2] = { 0x0142, 1 }, [REG_C3] = { 0x0143, 1 },
+    [REG_C4] = { 0x0144, 1 },
+    [REG_D0] = { 0x0200, 2 },
+};
+
+/* Coalesced register map flushes against one write per register */
+static int scn_regmap(void)
+{
+    const uhf_spi_reg_t unsorted[2] = { { 0x0101, 1 }, { 0x0100, 1 } };
+    uhf_dev_t *dev = dev_start();
+    uint32_t writes;
+    uint32_t reads;
+    uint64_t start;
+    uint64_t single;
+    uint64_t flush;
+    uint8_t value[4];
+    uint8_t i;
+
+    CHECK(uhf_spi_regmap_init(dev, unsorted, 2) == false);
+    CHECK(uhf_spi_regmap_init(dev, g_regs, REG_COUNT) == true);
+    for (i = 0; i < 0x50U; i++)
+    {
+        sim_model.sram[0x0100U + i] = i;
+    }
+    sim_model.sram[0x0200] = 0x34;
+    sim_model.sram[0x0201] = 0x12;
+
+    /* One read per run */
+    reads = sim_model.opcodes[0x08];
+    uhf_spi_regmap_load(dev);
+    CHECK((sim_model.opcodes[0x08] - reads) == 4U);
+    CHECK(uhf_spi_regmap_get(dev, REG_A2) == 0x0302U);
+    CHECK(uhf_spi_regmap_get(dev, REG_B1) == 0x24232221UL);
+    CHECK(uhf_spi_regmap_get(dev, REG_D0) == 0x1234U);
+    CHECK(uhf_spi_regmap_flush(dev) == 0U);
+
+    /* Full reconfiguration, the same values one register at a time first */
+    start = sim_now();
+    for (i = 0; i < REG_COUNT; i++)
+    {
+        value[0] = (uint8_t)(0xA0U + i);
+        value[1] = 0xB0;
+        value[2] = 0xC0;
+        value[3] = 0xD0;
+        uhf_spi_write_sram_reg(dev, g_regs[i].addr, value, g_regs[i].size);
+    }
+    single = sim_now() - start;
+    writes = sim_model.opcodes[0x07];
+    start = sim_now();
+    for (i = 0; i < REG_COUNT; i++)
+    {
+        uhf_spi_regmap_set(dev, i, 0xD0C0B0A0UL + i);
+    }
+    CHECK(uhf_spi_regmap_get(dev, REG_A2) == 0xB0A2U);
+    CHECK(uhf_spi_regmap_flush(dev) == 4U);
+    flush = sim_now() - start;
+    CHECK((sim_model.opcodes[0x07] - writes) == 4U);
+    CHECK(sim_model.sram[0x0102] == 0xA2U);
+    CHECK(sim_model.sram[0x0103] == 0xB0U);
+    CHECK(sim_model.sram[0x0124] == 0xD0U);
+    CHECK(sim_model.sram[0x0144] == 0xACU);
+    CHECK(flush < single);
+
+    /* Unchanged values stay clean */
+    uhf_spi_regmap_set(dev, REG_C0, 0xA8);
+    CHECK(uhf_spi_regmap_flush(dev) == 0U);
+
+    /* Up to four clean bytes in between are written along, five are not */
+    writes = sim_model.opcodes[0x07];
+    uhf_spi_regmap_set(dev, REG_C0, 0x11);
+    uhf_spi_regmap_set(dev, REG_C3, 0x22);
+    uhf_spi_regmap_set(dev, REG_A0, 0x33);
+    uhf_spi_regmap_set(dev, REG_A3, 0x44);
+    uhf_spi_regmap_set(dev, REG_B0, 0x55);
+    uhf_spi_regmap_set(dev, REG_B3, 0x66);
+    CHECK(uhf_spi_regmap_flush(dev) == 4U);
+    CHECK((sim_model.opcodes[0x07] - writes) == 4U);
+    CHECK(sim_model.sram[0x0140] == 0x11U);
+    CHECK(sim_model.sram[0x0141] == 0xA9U);
+    CHECK(sim_model.sram[0x0143] == 0x22U);
+    CHECK(sim_model.sram[0x0104] == 0x44U);
+    CHECK(sim_model.sram[0x0126] == 0x66U);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+    printf("  %-22s %u registers in 4 telegrams %.3f ms, one by one %.3f ms\n", "", (unsigned)REG_COUNT,
+           (double)flush / 1e6, (double)single / 1e6);
+
+    return 0;
+}
+#endif
+
+static int scn_trace(void)
+{
+#if (UHF_SPI_TRACE_ENABLE == 1)
+    uhf_spi_trace_t records[4];
+    uhf_dev_t *dev = dev_start();
+    uint8_t events[4];
+    uint32_t count;
+
+    uhf_spi_trace_reset(dev);
+    uhf_spi_get_event_bytes(dev, events);
+    (void)uhf_spi_get_version_ROM(dev);
+    count = uhf_spi_trace_get(dev, records, 4U);
+    CHECK(count == 2U);
+    CHECK(records[0].opcode == UHF_SPI_CMD_GET_EVENT_BYTES);
+    CHECK(records[0].length == 4U);
+    CHECK(records[0].end != records[0].start);
+    CHECK(records[1].opcode == UHF_SPI_CMD_GET_VERSION_ROM);
+    CHECK(records[1].length == 3U);
+    uhf_spi_trace_dump(dev);
+    CHECK(sim_uart_contains("SPI trace 2 of 2") == true);
+    CHECK(sim_uart_contains("  12   3 ") == true);
+    CHECK(uhf_spi_trace_get(dev, records, 4U) == 0U);
+#endif
+
+    return 0;
+}
+
+static void eeprom_job_callback(uhf_spi_eeprom_status_t status, uint16_t written, uintptr_t context)
+{
+    *((uhf_spi_eeprom_status_t *)context) = status;
+}
+
+/* Background EEPROM programming while a telegram is received and drained */
+static int scn_eeprom_job(void)
+{
+    const uint8_t telegram[] = { 0x31, 0x32, 0x33, 0x34 };
+    uint8_t config[20];
+    uint8_t rx[32];
+    uhf_spi_drain_t drain = { .rx_data = rx, .rx_size = sizeof(rx) };
+    uint8_t event_bytes[4];
+    const uhf_spi_cmd_t events = { .id = UHF_SPI_CMD_GET_EVENT_BYTES, .data = event_bytes };
+    uhf_spi_eeprom_status_t status = UHF_SPI_EEPROM_IDLE;
+    uhf_dev_t *dev = dev_start();
+    bool drained = false;
+    uint64_t start;
+    uint16_t written;
+    uint8_t i;
+
+    for (i = 0; i < sizeof(config); i++)
+    {
+        config[i] = (uint8_t)(0xA0U + i);
+    }
+    uhf_spi_get_event_bytes(dev, event_bytes);
+    uhf_spi_set_system_mode(dev, APP_RXMODE, 0x00);
+    ata8510_model_rx_start(&sim_model, telegram, sizeof(telegram), 0x40, APP_RX_CONFIG, sim_now());
+    start = sim_now();
+    CHECK(uhf_spi_eeprom_write_submit(dev, 0x0100, config, sizeof(config), eeprom_job_callback, (uintptr_t)&status) == true);
+    CHECK(uhf_spi_eeprom_write_submit(dev, 0x0200, config, sizeof(config), NULL, 0U) == false);
+    while (status == UHF_SPI_EEPROM_IDLE)
+    {
+        /* Packet handling goes on meanwhile */
+        if ((drained == false) && (uhf_irq_get(dev) == false))
+        {
+            drained = true;
+            CHECK(uhf_spi_eeprom_write_status(dev, &written) == UHF_SPI_EEPROM_BUSY);
+            CHECK(written < sizeof(config));
+            CHECK(uhf_spi_drain_submit(dev, &drain, NULL, 0U) == true);
+            CHECK(uhf_spi_submit(dev, &events) == true);
+        }
+        SYS_Tasks();
+    }
+    CHECK(status == UHF_SPI_EEPROM_DONE);
+    CHECK(uhf_spi_eeprom_write_status(dev, &written) == UHF_SPI_EEPROM_DONE);
+    CHECK(written == sizeof(config));
+    CHECK(memcmp(&sim_model.eeprom[0x0100], config, sizeof(config)) == 0);
+    CHECK(drain.rx_length == sizeof(telegram));
+    CHECK(memcmp(rx, telegram, sizeof(telegram)) == 0);
+    /* 3 chunks, 4 ms per byte, a poll interval of slack each */
+    CHECK((sim_now() - start) < SIM_MS(20 * 4 + 3 * 2));
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+    printf("  %-22s %u bytes programmed in %.3f ms\n", "", (unsigned)written, (double)(sim_now() - start) / 1e6);
+
+    /* A blocking block write behind a running job waits for it, then writes */
+    status = UHF_SPI_EEPROM_IDLE;
+    CHECK(uhf_spi_eeprom_write_submit(dev, 0x0300, config, sizeof(config), eeprom_job_callback, (uintptr_t)&status) == true);
+    CHECK(uhf_spi_write_eeprom_block(dev, 0x0340, &config[4], 8U) == true);
+    CHECK(status == UHF_SPI_EEPROM_DONE);
+    CHECK(memcmp(&sim_model.eeprom[0x0300], config, sizeof(config)) == 0);
+    CHECK(memcmp(&sim_model.eeprom[0x0340], &config[4], 8U) == 0);
+    CHECK(uhf_spi_write_eeprom_block(dev, 0x0340, config, 0U) == false);
+
+    /* Speed negotiation neither changes SCK nor uses the SRAM scratch area under a job */
+    status = UHF_SPI_EEPROM_IDLE;
+    CHECK(uhf_spi_eeprom_write_submit(dev, 0x0380, config, sizeof(config), eeprom_job_callback, (uintptr_t)&status) == true);
+    (void)uhf_spi_speed_negotiate(dev);
+    CHECK(status == UHF_SPI_EEPROM_DONE);
+    CHECK(memcmp(&sim_model.eeprom[0x0380], config, sizeof(config)) == 0);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+
+    return 0;
+}
+
+/* CMD_RDY never comes back */
+static int scn_eeprom_timeout(void)
+{
+    uint8_t data[3] = { 1, 2, 3 };
+    uhf_spi_eeprom_status_t status = UHF_SPI_EEPROM_IDLE;
+    uhf_dev_t *dev = dev_start();
+    uint16_t written;
+
+    sim_model.eeprom_write_ns = 50000000U;
+    CHECK(uhf_spi_eeprom_write_submit(dev, 0x0010, data, sizeof(data), eeprom_job_callback, (uintptr_t)&status) == true);
+    while (status == UHF_SPI_EEPROM_IDLE)
+    {
+        SYS_Tasks();
+    }
+    CHECK(status == UHF_SPI_EEPROM_ERROR);
+    CHECK(uhf_spi_eeprom_write_status(dev, &written) == UHF_SPI_EEPROM_ERROR);
+    CHECK(written == 0U);
+
+    return 0;
+}
+
+/* Differential update: only the changed bytes are programmed */
+static int scn_eeprom_update(void)
+{
+    static const uint8_t changed[] = { 3, 5, 20, 30, 31 };
+    uint8_t block[32];
+    uhf_spi_eeprom_status_t status = UHF_SPI_EEPROM_IDLE;
+    uhf_spi_eeprom_report_t report;
+    uhf_dev_t *dev = dev_start();
+    uint32_t writes;
+    uint64_t start;
+    uint8_t i;
+
+    for (i = 0; i < sizeof(block); i++)
+    {
+        block[i] = (uint8_t)(0x10U + i);
+    }
+    memcpy(&sim_model.eeprom[0x0180], block, sizeof(block));
+    for (i = 0; i < sizeof(changed); i++)
+    {
+        block[changed[i]] ^= 0xFFU;
+    }
+    writes = sim_model.eeprom_writes;
+    start = sim_now();
+    CHECK(uhf_spi_eeprom_update_submit(dev, 0x0180, block, sizeof(block), eeprom_job_callback, (uintptr_t)&status) == true);
+    while (status == UHF_SPI_EEPROM_IDLE)
+    {
+        SYS_Tasks();
+    }
+    CHECK(status == UHF_SPI_EEPROM_DONE);
+    CHECK(memcmp(&sim_model.eeprom[0x0180], block, sizeof(block)) == 0);
+    /* 3..5 merged across the one byte gap, 20 alone, 30..31 */
+    uhf_spi_eeprom_report_get(dev, &report);
+    CHECK(report.length == sizeof(block));
+    CHECK(report.written == 6U);
+    CHECK(report.skipped == (sizeof(block) - 6U));
+    CHECK(report.chunks == 3U);
+    CHECK((sim_model.eeprom_writes - writes) == 6U);
+    CHECK(report.saved_us > 90000U);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+    printf("  %-22s %u of %u bytes programmed in %.3f ms, %lu us saved\n", "", (unsigned)report.written,
+           (unsigned)report.length, (double)(sim_now() - start) / 1e6, (unsigned long)report.saved_us);
+
+    /* Nothing left to do */
+    writes = sim_model.eeprom_writes;
+    CHECK(uhf_spi_update_eeprom_block(dev, 0x0180, block, sizeof(block)) == true);
+    uhf_spi_eeprom_report_get(dev, &report);
+    CHECK(uhf_spi_eeprom_write_status(dev, NULL) == UHF_SPI_EEPROM_DONE);
+    CHECK(report.written == 0U);
+    CHECK(report.chunks == 0U);
+    CHECK(report.skipped == sizeof(block));
+    CHECK(sim_model.eeprom_writes == writes);
+
+    return 0;
+}
+
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+/* Shadowed EEPROM reads come from RAM and follow the driver's own writes */
+static int scn_eeprom_shadow(void)
+{
+    uint8_t block[5] = { 0x51, 0x52, 0x53, 0x54, 0x55 };
+    uhf_dev_t *dev = dev_start();
+    uint64_t start;
+    uint64_t fill;
+    uint64_t single;
+    uint32_t reads;
+    uint16_t i;
+
+    for (i = 0; i < 0x20U; i++)
+    {
+        sim_model.eeprom[0x0040U + i] = (uint8_t)(0x80U + i);
+        sim_model.eeprom[0x0100U + i] = (uint8_t)i;
+    }
+    CHECK(uhf_spi_eeprom_shadow_fill(dev) == false);
+    CHECK(uhf_spi_eeprom_shadow_add(dev, 0x0040, 16) == true);
+    CHECK(uhf_spi_eeprom_shadow_add(dev, 0x0100, 8) == true);
+    /* Adjacent and overlapping ranges merge */
+    CHECK(uhf_spi_eeprom_shadow_add(dev, 0x0050, 16) == true);
+    CHECK(uhf_spi_eeprom_shadow_add(dev, 0x0048, 4) == true);
+    CHECK(uhf_spi_eeprom_shadow_add(dev, 0x0200, 30) == false);
+
+    reads = sim_model.opcodes[0x0A];
+    start = sim_now();
+    CHECK(uhf_spi_eeprom_shadow_fill(dev) == true);
+    fill = sim_now() - start;
+    CHECK((sim_model.opcodes[0x0A] - reads) == 40U);
+    start = sim_now();
+    for (i = 0; i < 0x20U; i++)
+    {
+        CHECK(uhf_spi_read_eeprom(dev, (uint16_t)(0x0040U + i)) == (uint8_t)(0x80U + i));
+    }
+    CHECK(uhf_spi_read_eeprom(dev, 0x0107) == 0x07U);
+    CHECK(sim_now() == start);
+    /* Not shadowed */
+    CHECK(uhf_spi_read_eeprom(dev, 0x0108) == 0x08U);
+    single = sim_now() - start;
+    CHECK(single > 0U);
+
+    /* Driver writes keep it coherent */
+    uhf_spi_write_eeprom(dev, 0x0042, 0x99);
+    delay_ms(5);
+    uhf_spi_write_eeprom_block(dev, 0x0104, block, sizeof(block));
+    CHECK(uhf_spi_read_eeprom(dev, 0x0042) == 0x99U);
+    CHECK(uhf_spi_read_eeprom(dev, 0x0107) == 0x54U);
+    delay_ms(5);
+    CHECK(uhf_spi_eeprom_shadow_verify(dev) == true);
+
+    /* Reprogrammed behind its back */
+    sim_model.eeprom[0x0045] ^= 0x01U;
+    CHECK(uhf_spi_eeprom_shadow_verify(dev) == false);
+    CHECK(uhf_spi_read_eeprom(dev, 0x0045) == (uint8_t)(0x85U ^ 0x01U));
+    CHECK(uhf_spi_eeprom_shadow_fill(dev) == true);
+    CHECK(uhf_spi_eeprom_shadow_verify(dev) == true);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+    printf("  %-22s 40 bytes filled in %.3f ms, one uncached read %.3f ms\n", "", (double)fill / 1e6,
+           (double)single / 1e6);
+
+    return 0;
+}
+#endif
+
+/* A transceiver with a longer T4 than the driver allows drops the telegram */
+static int scn_guard_violation(void)
+{
+    const uint8_t mode[2] = { 0x22, 0x00 };
+    uhf_dev_t *dev = dev_start();
+    uint32_t t4_ns = sim_model.t4_ns;
+
+    sim_model.t4_ns = 60000U;
+    uhf_spi_set_system_mode(dev, mode[0], mode[1]);
+    CHECK(sim_model.violations[ATA8510_MODEL_T4] == 1U);
+    CHECK(sim_model.mode == ATA8510_MODEL_OPM_IDLE);
+    sim_model.t4_ns = t4_ns;
+    uhf_spi_set_system_mode(dev, mode[0], mode[1]);
+    CHECK(sim_model.violations[ATA8510_MODEL_T4] == 1U);
+    CHECK(sim_model.mode == mode[0]);
+
+    return 0;
+}
+
+/* 256 sensors at half load all fit, a new sensor with both buckets full evicts their least recently seen node */
+static int scn_node_table(void)
+{
+    node_table_stats_t stats;
+    uint16_t ids[256];
+    uint16_t id = 0xACE1U;
+    uint16_t index;
+    uint16_t slot;
+    node_t *node;
+    node_t *keep = NULL;
+    uint32_t now = 0U;
+
+    node_table_init();
+    for (index = 0U; index < 256U; index++)
+    {
+        /* xorshift, never 0 and never NODE_ID_NONE within the first 256 */
+        id ^= (uint16_t)(id << 7);
+        id ^= (uint16_t)(id >> 9);
+        id ^= (uint16_t)(id << 8);
+        ids[index] = id;
+        node = node_table_seen(id, now++);
+        CHECK((node != NULL) && (node->id == id));
+    }
+    node = node_table_seen(ids[0], now + 5U);
+    CHECK((node != NULL) && (node->gap_min == now + 5U) && (node->gap_min == node->gap_max));
+    node_table_sample(node, 230, 0x48);
+    node_table_sample(node, 230, 0x40);
+    CHECK((node->value == 230) && (node->rssi_ewma == 0x4700U));
+    node_table_result(node, NODE_RESULT_ACK_MISS);
+    CHECK(node->ack_misses == 1U);
+    CHECK(node_table_seen(NODE_ID_NONE, now) == NULL);
+    for (index = 0U; index < 256U; index++)
+    {
+        CHECK(node_table_find(ids[index]) != NULL);
+    }
+    node_table_stats_get(&stats);
+    CHECK(stats.nodes == 256U);
+    CHECK(stats.evictions == 0U);
+    CHECK(stats.probes_max <= NODE_TABLE_PROBES);
+    printf("  %-22s 256 sensors: probes avg %.2f, max %u\n", "", (double)stats.probes / stats.lookups,
+           stats.probes_max);
+
+    /* 1024 more sensors, ids[1] is heard in between and is always the most recently seen node */
+    for (index = 0U; index < 1024U; index++)
+    {
+        keep = node_table_seen(ids[1], ++now);
+        (void)node_table_seen((uint16_t)(0x4000U + index), ++now);
+    }
+    node_table_stats_get(&stats);
+    CHECK(stats.evictions != 0U);
+    CHECK(stats.nodes <= NODE_TABLE_CAPACITY);
+    CHECK(stats.probes_max <= NODE_TABLE_PROBES);
+    CHECK((node_table_find(ids[1]) == keep) && (keep->gap_min == 2U));
+    CHECK(node_table_find(ids[0]) == NULL);
+    CHECK(node_table_find(0x4000U + 1023U) != NULL);
+    for (slot = 0U, index = 0U; slot < NODE_TABLE_CAPACITY; slot++)
+    {
+        index += (node_table_at(slot) != NULL) ? 1U : 0U;
+    }
+    CHECK(index == stats.nodes);
+    printf("  %-22s 1280 sensors: %u nodes, %lu evictions\n", "", stats.nodes, (unsigned long)stats.evictions);
+
+    return 0;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Scenarios
+// *****************************************************************************
+// *****************************************************************************
+
+static void app_sensor_telegram(uintptr_t context)
+{
+    uint8_t telegram[APP_TELEGRAM_LENGTH] = { APP_TEMPDATA, 0xE6, 0x00, 0x00 }; // 23.0 C
+
+    telegram[3] = app_checksum(telegram, 3U);
+    if (context != 0U)
+    {
+        telegram[3] ^= 0x5AU;
+    }
+    ata8510_model_rx_start(&sim_model, telegram, sizeof(telegram), 0x48, APP_RX_CONFIG, sim_now());
+}
+
+static void app_sensor_id_telegram(uintptr_t context)
+{
+    uint8_t telegram[6] = { APP_TEMPDATA_ID, (uint8_t)context, (uint8_t)(context >> 8), 0xE6, 0x00, 0x00 };
+
+    telegram[5] = app_checksum(telegram, 5U);
+    ata8510_model_rx_start(&sim_model, telegram, sizeof(telegram), 0x48, APP_RX_CONFIG, sim_now());
+}
+
+static void app_reply_enable(uintptr_t context)
+{
+    g_reply_enable = (context != 0U);
+}
+
+static void app_reply_telegram(uintptr_t context)
+{
+    uint8_t telegram[4] = { g_reply_code, 0x00, 0x37, 0x00 };
+
+    (void)context;
+    telegram[3] = app_checksum(telegram, 3U);
+    ata8510_model_rx_start(&sim_model, telegram, sizeof(telegram), 0x44, APP_RX_CONFIG, sim_now());
+}
+
+static void app_press_button2(uintptr_t context)
+{
+    sim_button_set(2U, (context != 0U));
+}
+
+static void app_check_held(uintptr_t context)
+{
+    (void)context;
+    g_held_polling = (rf_rx_busy == false) && (rf_ring_count() == 1U) && (sim_uart_contains("RSSI= 55") == false) &&
+                     ((sim_model.mode & ATA8510_MODEL_OPM_MASK) == ATA8510_MODEL_OPM_POLLING);
+}
+
+/* Follow the receiver from the end of the ACK until it is in RX mode */
+static void app_rx_mode_poll(uintptr_t context)
+{
+    (void)context;
+    if ((sim_model.mode & ATA8510_MODEL_OPM_MASK) == ATA8510_MODEL_OPM_RX)
+    {
+        g_rx_mode_latency = sim_now() - g_ack_end;
+    }
+    else if ((sim_now() - g_ack_end) < SIM_MS(50))
+    {
+        (void)sim_at(sim_now() + SIM_US(5), app_rx_mode_poll, 0U);
+    }
+}
+
+/* Sensor side: answer the ACK after its receive turn-around */
+static void app_sensor_tx(ata8510_model_t *model, const uint8_t *data, size_t length, uint64_t now, uintptr_t context)
+{
+    uint64_t byte_ns = 8000000000ULL / model->bitrate;
+
+    (void)context;
+    if ((length >= 2U) && (data[length - 2U] == APP_RSSIDATA))
+    {
+        /* now is the end of the ACK */
+        g_ack_latency = (now - (uint64_t)length * byte_ns) - (APP_TELEGRAM_AT + APP_TELEGRAM_LENGTH * byte_ns);
+        g_ack_end = now;
+        (void)sim_at(now, app_rx_mode_poll, 0U);
+        if (g_press_on_ack == true)
+        {
+            g_release_at = now + SIM_MS(300);
+            (void)sim_at(now + SIM_MS(1), app_press_button2, 1U);
+            (void)sim_at(g_release_at - 1U, app_check_held, 0U);
+            (void)sim_at(g_release_at, app_press_button2, 0U);
+        }
+    }
+    if ((g_reply_enable == true) && (length >= 2U) && (data[length - 2U] == APP_RSSIDATA))
+    {
+        (void)sim_at(now + SIM_MS(3), app_reply_telegram, 0U);
+        if (g_burst != 0U)
+        {
+            /* 4 ms after the end of the reply, while the first report is still on the UART */
+            g_burst--;
+            (void)sim_at(now + SIM_MS(3) + 5U * byte_ns + SIM_MS(4), app_sensor_telegram, 0U);
+        }
+    }
+}
+
+static void app_setup(void)
+{
+    g_reply_code = APP_RSSIDATA;
+    g_reply_enable = true;
+    g_telegrams = 1U;
+    sim_model.tx_callback = app_sensor_tx;
+    (void)sim_at(APP_TELEGRAM_AT, app_sensor_telegram, 0U);
+}
+
+/* SOT IRQ enabled in the transceiver EEPROM: the head is read while the tail is on air */
+static void app_setup_cut_through(void)
+{
+    app_setup();
+    sim_model.irq_mask_trx |= ATA8510_MODEL_SOTA;
+}
+
+/* Button 2 and its UART output in the middle of the handshake */
+static void app_setup_button_during_reply(void)
+{
+    app_setup();
+    g_press_on_ack = true;
+}
+
+/* A second sensor right after the first handshake */
+static void app_setup_burst(void)
+{
+    app_setup();
+    g_burst = 1U;
+    g_telegrams = 2U;
+}
+
+/* Six handshakes while button 2 is held, the ring keeps the first four */
+static void app_setup_ring_overflow(void)
+{
+    unsigned int index;
+
+    app_setup();
+    g_telegrams = 6U;
+    (void)sim_at(APP_TELEGRAM_AT - SIM_MS(100), app_press_button2, 1U);
+    for (index = 1U; index < g_telegrams; index++)
+    {
+        (void)sim_at(APP_TELEGRAM_AT + index * SIM_MS(60), app_sensor_telegram, 0U);
+    }
+    (void)sim_at(APP_TELEGRAM_AT + SIM_MS(400), app_press_button2, 0U);
+}
+
+static void app_setup_no_reply(void)
+{
+    app_setup();
+    g_reply_enable = false;
+}
+
+/* Two sensors with an ID, the first one is heard again 300 ms later and its reply is lost */
+static void app_setup_nodes(void)
+{
+    sim_model.tx_callback = app_sensor_tx;
+    g_reply_code = APP_RSSIDATA;
+    g_reply_enable = true;
+    g_telegrams = 3U;
+    (void)sim_at(APP_TELEGRAM_AT, app_sensor_id_telegram, APP_NODE_A);
+    (void)sim_at(APP_TELEGRAM_AT + SIM_MS(100), app_sensor_id_telegram, APP_NODE_B);
+    (void)sim_at(APP_TELEGRAM_AT + SIM_MS(250), app_reply_enable, 0U);
+    (void)sim_at(APP_TELEGRAM_AT + SIM_MS(300), app_sensor_id_telegram, APP_NODE_A);
+}
+
+/* SOT and EOT with nothing in the DFIFO */
+static void app_empty_telegram(uintptr_t context)
+{
+    uint8_t none = 0;
+
+    (void)context;
+    ata8510_model_rx_start(&sim_model, &none, 0U, 0x48, APP_RX_CONFIG, sim_now());
+}
+
+static void app_setup_empty(void)
+{
+    sim_model.tx_callback = app_sensor_tx;
+    (void)sim_at(APP_TELEGRAM_AT, app_empty_telegram, 0U);
+}
+
+static void app_setup_bad_checksum(void)
+{
+    sim_model.tx_callback = app_sensor_tx;
+    (void)sim_at(APP_TELEGRAM_AT, app_sensor_telegram, 1U);
+}
+
+static void app_press_button3(uintptr_t context)
+{
+    sim_button_set(3U, (context != 0U));
+}
+
+static void app_press_button1(uintptr_t context)
+{
+    sim_button_set(1U, (context != 0U));
+}
+
+static void app_setup_rssi_survey(void)
+{
+    sim_model.rssi_level[0] = 0x48;
+    sim_model.rssi_level[8] = 0x22;
+    sim_model.rssi_level[16] = 0x80;
+    sim_model.rssi_level[24] = 0x30;
+    sim_model.rssi_spread = 4U;
+    (void)sim_at(SIM_MS(500), app_press_button1, 1U);
+    (void)sim_at(SIM_MS(2500), app_press_button1, 0U);
+}
+
+static bool app_hook_rssi_survey(void)
+{
+    return !sim_uart_contains("cleanest");
+}
+
+static void app_verify_rssi_survey(sim_run_t result)
+{
+    CHECK(result == SIM_RUN_HOOK);
+    CHECK(sim_uart_contains("RSSI survey, 16 samples per channel, P90") == true);
+    CHECK(sim_uart_contains("0x50 min  3") == true);
+    CHECK(sim_uart_contains("cleanest 0x50") == true);
+    CHECK(sim_uart_contains("lost 0") == true);
+    /* Bars of 32 columns, the cleanest one marked on the top row */
+    CHECK(sim_oled_column(40U) == ((uint32_t)(0xFFFFFFFFUL << 27) | 1U));
+    CHECK(sim_oled_column(72U) == (uint32_t)(0xFFFFFFFFUL << 15));
+    CHECK((sim_oled_column(8U) & 1U) == 0U);
+    CHECK(sim_oled_column(0U) == 0U);
+    CHECK((sim_model.mode & ATA8510_MODEL_OPM_MASK) == ATA8510_MODEL_OPM_POLLING);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+}
+
+static void app_cpu_snapshot(uintptr_t context)
+{
+    sim_cpu_stats((sim_cpu_stats_t *)context);
+}
+
+/* Idle from 900 ms until the telegram at 1000 ms */
+static void app_setup_irq_sleep(void)
+{
+    app_setup();
+    (void)sim_at(APP_TELEGRAM_AT - SIM_MS(100), app_cpu_snapshot, (uintptr_t)&g_cpu_idle);
+    (void)sim_at(APP_TELEGRAM_AT - 1U, app_cpu_snapshot, (uintptr_t)&g_cpu_rx);
+}
+
+static void app_verify_irq_sleep(sim_run_t result)
+{
+    sim_cpu_stats_t end;
+    double asleep;
+    double response;
+
+    sim_cpu_stats(&end);
+    asleep = (double)(g_cpu_rx.sleep_ns - g_cpu_idle.sleep_ns) * 100.0 / (double)SIM_MS(100);
+    response = (end.responses != g_cpu_rx.responses) ?
+        (double)(end.response_total_ns - g_cpu_rx.response_total_ns) / (end.responses - g_cpu_rx.responses) / 1e3 : 0.0;
+    CHECK(result == SIM_RUN_HOOK);
+    CHECK(msg_count == 1U);
+    CHECK(end.responses > g_cpu_rx.responses);
+#if (UHF_SPI_IRQ_EIC_ENABLE == 1)
+    /* Asleep between the 2 us superloop passes only when nothing happens */
+    CHECK(asleep > 99.0);
+    /* The EIC stamp is the edge itself, answered in the same pass */
+    CHECK(SYS_TIME_CountToUS(rf_handler_max) <= 10U);
+#endif
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+    printf("  %-22s idle asleep %.1f %%, IRQ edge to telegram avg %.1f us, IRQ->handler max %lu us\n", "",
+           asleep, response, (unsigned long)SYS_TIME_CountToUS(rf_handler_max));
+}
+
+static void app_dump_snapshot(uintptr_t context)
+{
+    g_dump_early = sim_uart_contains("EEPROM dump");
+    g_dump_start = sim_now();
+    g_dump_cs_low_ns = sim_model.cs_low_ns;
+    g_dump_reads = sim_model.opcodes[0x0A];
+}
+
+static void app_setup_eeprom_dump(void)
+{
+    CHECK(ata8510_model_eeprom_load(&sim_model, APP_EEPROM_FILE) == true);
+    /* A short press shows the statistics only; a telegram after them, with
+       the button still held, is acknowledged right away */
+    sim_model.tx_callback = app_sensor_tx;
+    g_reply_code = APP_RSSIDATA;
+    g_reply_enable = true;
+    (void)sim_at(SIM_MS(500), app_press_button3, 1U);
+    (void)sim_at(APP_DUMP_TELEGRAM_AT, app_sensor_telegram, 0U);
+    (void)sim_at(APP_DUMP_TELEGRAM_AT + SIM_MS(200), app_press_button3, 0U);
+    /* A long press dumps the EEPROM */
+    (void)sim_at(SIM_MS(2000), app_dump_snapshot, 0U);
+    (void)sim_at(SIM_MS(2000), app_press_button3, 1U);
+    (void)sim_at(SIM_MS(4000), app_press_button3, 0U);
+}
+
+static bool app_hook_eeprom_dump(void)
+{
+    return !sim_uart_contains("EEPROM dump end");
+}
+
+static void app_verify_eeprom_dump(sim_run_t result)
+{
+    const char *path = getenv("SIM_EEPROM_DUMP");
+    FILE *file;
+
+    CHECK(result == SIM_RUN_HOOK);
+    CHECK(sim_uart_contains("Receiver statistics") == true);
+    CHECK(g_dump_early == false);
+    CHECK(msg_count == 1U);
+    CHECK((g_ack_end > APP_DUMP_TELEGRAM_AT) && (g_ack_end < (APP_DUMP_TELEGRAM_AT + SIM_MS(20))));
+    CHECK(sim_uart_contains("EEPROM dump end, 1024 bytes") == true);
+    CHECK(sim_uart_contains("EEPROM 0000: 2A 07 02 68 DD") == true);
+    /* CS is released while the sink prints a block: CS low is the reads only */
+    CHECK((sim_model.cs_low_ns - g_dump_cs_low_ns) < ((uint64_t)(sim_model.opcodes[0x0A] - g_dump_reads) * SIM_US(150)));
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+    printf("  %-22s %lu reads, CS low %.1f ms of %.1f ms\n", "", (unsigned long)(sim_model.opcodes[0x0A] - g_dump_reads),
+           (double)(sim_model.cs_low_ns - g_dump_cs_low_ns) / 1e6, (double)(sim_now() - g_dump_start) / 1e6);
+    /* For the dump2eep round trip of make test */
+    if (path != NULL)
+    {
+        file = fopen(path, "w");
+        CHECK(file != NULL);
+        if (file != NULL)
+        {
+            fputs(sim_uart_text(), file);
+            fclose(file);
+        }
+    }
+}
+
+static unsigned int app_uart_count(const char *text)
+{
+    const char *at = sim_uart_text();
+    unsigned int count = 0U;
+
+    while ((at = strstr(at, text)) != NULL)
+    {
+        count++;
+        at += strlen(text);
+    }
+
+    return count;
+}
+
+/* Stop once the telegrams have been handled and shown, and the receiver is back polling */
+static bool app_hook_done(void)
+{
+    return !((rf_rx_busy == false) && (rf_ring_count() == 0U) && (tot_count != 0U) && (tot_count >= g_telegrams));
+}
+
+static void app_verify_ack(sim_run_t result)
+{
+    CHECK(result == SIM_RUN_HOOK);
+    CHECK(tot_count == 1U);
+    CHECK(msg_count == 1U);
+    CHECK(err_count == 0U);
+    CHECK(sim_model.tx_telegrams == 1U);
+    CHECK(sim_model.rx_telegrams == 2U);
+    CHECK(sim_uart_contains("T= 23'C") == true);
+    CHECK(sim_uart_contains("RSSI= 55") == true);
+    CHECK(rf_latency_count == 1U);
+    /* TX FIFO and preamble staged while still awake in RX, 1.041 ms when written after idle mode */
+    CHECK(g_ack_latency < SIM_US(1000));
+    CHECK(rf_turnaround_max != 0U);
+    CHECK((sim_model.mode & ATA8510_MODEL_OPM_MASK) == ATA8510_MODEL_OPM_POLLING);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+    printf("  %-22s end of telegram to ACK start %.3f ms (EOT->ACK %lu us), ACK end to RX mode %.3f ms\n", "",
+           (double)g_ack_latency / 1e6, (unsigned long)SYS_TIME_CountToUS(rf_turnaround_max),
+           (double)g_rx_mode_latency / 1e6);
+}
+
+static void app_verify_button_during_reply(sim_run_t result)
+{
+    const char *com = strstr(sim_uart_text(), "COM Port Settings");
+    const char *report = strstr(sim_uart_text(), "RSSI= 55");
+
+    CHECK(result == SIM_RUN_HOOK);
+    CHECK(msg_count == 1U);
+    CHECK(err_count == 0U);
+    CHECK((com != NULL) && (report != NULL) && (com < report));
+    /* Handshake done and back polling while the button is still held, shown after the release */
+    CHECK(g_held_polling == true);
+    CHECK(sim_now() > g_release_at);
+    CHECK((sim_model.mode & ATA8510_MODEL_OPM_MASK) == ATA8510_MODEL_OPM_POLLING);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+}
+
+static void app_verify_burst(sim_run_t result)
+{
+    CHECK(result == SIM_RUN_HOOK);
+    CHECK(tot_count == 2U);
+    CHECK(msg_count == 2U);
+    CHECK(err_count == 0U);
+    CHECK(sim_model.rx_missed == 0U);
+    CHECK(sim_model.tx_telegrams == 2U);
+    CHECK(app_uart_count("T= 23'C") == 2U);
+    CHECK(rf_ring_overflows == 0U);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+}
+
+static void app_verify_ring_overflow(sim_run_t result)
+{
+    CHECK(result == SIM_RUN_HOOK);
+    CHECK(msg_count == 6U);
+    CHECK(err_count == 0U);
+    CHECK(sim_model.rx_missed == 0U);
+    CHECK(sim_model.tx_telegrams == 6U);
+    CHECK(rf_ring_overflows == 2U);
+    CHECK(app_uart_count("T= 23'C") == 4U);
+    CHECK((sim_model.mode & ATA8510_MODEL_OPM_MASK) == ATA8510_MODEL_OPM_POLLING);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+}
+
+static void app_verify_nodes(sim_run_t result)
+{
+    const node_t *a = node_table_find(APP_NODE_A);
+    const node_t *b = node_table_find(APP_NODE_B);
+    node_table_stats_t stats;
+
+    node_table_stats_get(&stats);
+    CHECK(result == SIM_RUN_HOOK);
+    CHECK(tot_count == 3U);
+    CHECK(msg_count == 3U);
+    CHECK(err_count == 1U);
+    CHECK(stats.nodes == 2U);
+    CHECK((a != NULL) && (a->valid == 1U) && (a->ack_misses == 1U) && (a->errors == 0U) && (a->value == 230));
+    CHECK((a != NULL) && (a->gap_min >= 29U) && (a->gap_min <= 31U) && (a->gap_min == a->gap_max));
+    CHECK((a != NULL) && ((a->rssi_ewma >> 8) == 0x48U));
+    CHECK((b != NULL) && (b->valid == 1U) && (b->ack_misses == 0U) && (b->gap_min == NODE_GAP_NONE));
+    CHECK(sim_uart_contains("node=  257") == true);
+    CHECK(sim_uart_contains("node=  514") == true);
+    CHECK(app_uart_count("T= 23'C") == 2U);
+    CHECK(sim_uart_contains("No RF ACK telegram!") == true);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+}
+
+static void app_verify_no_reply(sim_run_t result)
+{
+    CHECK(result == SIM_RUN_HOOK);
+    CHECK(msg_count == 1U);
+    CHECK(err_count == 1U);
+    CHECK(sim_uart_contains("No RF ACK telegram!") == true);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+}
+
+static void app_verify_bad_checksum(sim_run_t result)
+{
+    CHECK(result == SIM_RUN_HOOK);
+    CHECK(tot_count == 1U);
+    CHECK(msg_count == 0U);
+    CHECK(err_count == 1U);
+    CHECK(sim_model.tx_telegrams == 0U);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+}
+
+/* Reported as a wrong telegram, no checksum read from before rx_buffer */
+static void app_verify_empty(sim_run_t result)
+{
+    CHECK(result == SIM_RUN_HOOK);
+    CHECK(tot_count == 1U);
+    CHECK(msg_count == 0U);
+    CHECK(err_count == 1U);
+    CHECK(sim_model.tx_telegrams == 0U);
+    CHECK(sim_uart_contains("Wrong ACK telegram!") == true);
+    CHECK(ata8510_model_violations(&sim_model) == 0U);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Runner
+// *****************************************************************************
+// *****************************************************************************
+
+static const scenario_t g_scenarios[] =
+{
+    { "power_on",           scn_power_on,           NULL,           SIM_MS(100),    NULL,                   NULL },
+    { "speed_negotiate",    scn_speed_negotiate,    NULL,           SIM_MS(200),    NULL,                   NULL },
+    { "speed_fallback",     scn_speed_fallback,     NULL,           SIM_MS(200),    NULL,                   NULL },
+    { "sram_eeprom",        scn_sram_eeprom,        NULL,           SIM_MS(200),    NULL,                   NULL },
+    { "fifo_drain",         scn_fifo_drain,         NULL,           SIM_MS(100),    NULL,                   NULL },
+    { "byte_int_read",      scn_byte_int_read,      NULL,           SIM_MS(100),    NULL,                   NULL },
+    { "eeprom_job",         scn_eeprom_job,         NULL,           SIM_MS(600),    NULL,                   NULL },
+    { "eeprom_timeout",     scn_eeprom_timeout,     NULL,           SIM_MS(300),    NULL,                   NULL },
+    { "eeprom_update",      scn_eeprom_update,      NULL,           SIM_MS(300),    NULL,                   NULL },
+#if (UHF_SPI_EEPROM_SHADOW_ENABLE == 1)
+    { "eeprom_shadow",      scn_eeprom_shadow,      NULL,           SIM_MS(300),    NULL,                   NULL },
+#endif
+    { "node_table",         scn_node_table,         NULL,           SIM_MS(100),    NULL,                   NULL },
+    { "guard_violation",    scn_guard_violation,    NULL,           SIM_MS(100),    NULL,                   NULL },
+    { "trace",              scn_trace,              NULL,           SIM_MS(100),    NULL,                   NULL },
+    { "stream_rx",          scn_stream_rx,          NULL,           SIM_MS(1000),   NULL,                   NULL },
+    { "stream_tx",          scn_stream_tx,          NULL,           SIM_MS(1000),   NULL,                   NULL },
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+    { "rssi_survey",        scn_rssi_survey,        NULL,           SIM_MS(1000),   NULL,                   NULL },
+#endif
+    { "dump",               scn_dump,               NULL,           SIM_MS(1000),    NULL,                   NULL },
+#if (UHF_SPI_REGMAP_ENABLE == 1)
+    { "regmap",             scn_regmap,             NULL,           SIM_MS(100),    NULL,                   NULL },
+#endif
+    { "app_rx_ack",         app_main,               app_hook_done,  SIM_MS(2000),   app_setup,              app_verify_ack },
+    { "app_cut_through",    app_main,               app_hook_done,  SIM_MS(2000),   app_setup_cut_through,  app_verify_ack },
+    { "app_no_reply",       app_main,               app_hook_done,  SIM_MS(2000),   app_setup_no_reply,     app_verify_no_reply },
+    { "app_button_reply",   app_main,               app_hook_done,  SIM_MS(2000),   app_setup_button_during_reply, app_verify_button_during_reply },
+    { "app_burst",          app_main,               app_hook_done,  SIM_MS(2000),   app_setup_burst,        app_verify_burst },
+    { "app_ring_overflow",  app_main,               app_hook_done,  SIM_MS(2000),   app_setup_ring_overflow, app_verify_ring_overflow },
+    { "app_nodes",          app_main,               app_hook_done,  SIM_MS(2000),   app_setup_nodes,        app_verify_nodes },
+    { "app_bad_checksum",   app_main,               app_hook_done,  SIM_MS(2000),   app_setup_bad_checksum, app_verify_bad_checksum },
+    { "app_empty",          app_main,               app_hook_done,  SIM_MS(2000),   app_setup_empty,        app_verify_empty },
+    { "app_irq_sleep",      app_main,               app_hook_done,  SIM_MS(2000),   app_setup_irq_sleep,    app_verify_irq_sleep },
+#if (UHF_SPI_RSSI_SURVEY_ENABLE == 1)
+    { "app_rssi_survey",    app_main,               app_hook_rssi_survey, SIM_MS(5000), app_setup_rssi_survey, app_verify_rssi_survey },
+#endif
+    { "app_eeprom_dump",    app_main,               app_hook_eeprom_dump, SIM_MS(6000), app_setup_eeprom_dump, app_verify_eeprom_dump },
+};
+
+static int scenario_run(const scenario_t *scenario)
+{
+    sim_run_t result;
+
+    sim_reset();
+    if (scenario->setup != NULL)
+    {
+        scenario->setup();
+    }
+    result = sim_run(scenario->entry, scenario->hook, scenario->deadline);
+    if (scenario->verify != NULL)
+    {
+        scenario->verify(result);
+    }
+    else
+    {
+        CHECK(result == SIM_RUN_RETURN);
+    }
+    sim_report(scenario->name);
+    fflush(stdout);
+
+    return (g_failures == 0U) ? 0 : 1;
+}
+
+static bool scenario_selected(const scenario_t *scenario, int argc, char *argv[])
+{
+    int i;
+
+    if (argc < 2)
+    {
+        return true;
+    }
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], scenario->name) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int failed = 0;
+    unsigned int run = 0;
+    size_t i;
+    pid_t pid;
+    int status;
+
+    for (i = 0; i < (sizeof(g_scenarios) / sizeof(g_scenarios[0])); i++)
+    {
+        if (scenario_selected(&g_scenarios[i], argc, argv) == false)
+        {
+            continue;
+        }
+        printf("[ RUN  ] %s\n", g_scenarios[i].name);
+        fflush(stdout);
+        run++;
+        pid = fork();
+        if (pid == 0)
+        {
+            exit(scenario_run(&g_scenarios[i]));
+        }
+        if ((pid < 0) || (waitpid(pid, &status, 0) != pid) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+        {
+            printf("[ FAIL ] %s\n", g_scenarios[i].name);
+            failed++;
+        }
+        else
+        {
+            printf("[  OK  ] %s\n", g_scenarios[i].name);
+        }
+    }
+    printf("%u of %u scenarios passed\n", run - failed, run);
+
+    return (int)failed;
+}
@@ -0,0 +1,181 @@
+/*******************************************************************************
+  ATA8510 Host Simulator
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    dump2eep.c
+
+  Summary:
+    Convert an ATA8510 memory dump to the .eep layout
+
+  Description:
+    Reads the UART log of an EEPROM dump of the firmware ("EEPROM aaaa: dd dd
+    ..." lines, see rf_dump_sink() in main.c) and writes it as Intel HEX in
+    the layout of the programming_files .eep files, one data record per byte
+    followed by the end record, so that it compares byte for byte with them.
+
+      dump2eep [-s] [-m eep] [log]
+
+    -s converts "SRAM" lines instead. The .eep files leave some addresses
+    out; -m eep writes only the addresses that the given file contains.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+* 
+* The software and documentation is provided by microchip and its contributors
+* "as is" and any express, implied or statutory warranties, including, but not
+* limited to, the implied warranties of merchantability, fitness for a particular
+* purpose and non-infringement of third party intellectual property rights are
+* disclaimed to the fullest extent permitted by law. In no event shall microchip
+* or its contributors be liable for any direct, indirect, incidental, special,
+* exemplary, or consequential damages (including, but not limited to, procurement
+* of substitute goods or services; loss of use, data, or profits; or business
+* interruption) however caused and on any theory of liability, whether in contract,
+* strict liability, or tort (including negligence or otherwise) arising in any way
+* out of the use of the software and documentation, even if advised of the
+* possibility of such damage.
+* 
+* Except as expressly permitted hereunder and subject to the applicable license terms
+* for any third-party software incorporated in the software and any applicable open
+* source software license terms, no license or other rights, whether express or
+* implied, are granted under any patent or other intellectual property rights of
+* Microchip or any third party.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DUMP_SPACE_SIZE     (0x10000UL)
+
+static uint8_t g_image[DUMP_SPACE_SIZE];
+static bool g_present[DUMP_SPACE_SIZE];
+static bool g_mask[DUMP_SPACE_SIZE];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Conversion
+// *****************************************************************************
+// *****************************************************************************
+
+/* Take the bytes of one dump line, other lines of the log are skipped */
+static void dump_line(const char *line, const char *tag)
+{
+    size_t tag_length = strlen(tag);
+    unsigned int addr;
+    unsigned int value;
+    int used;
+
+    line = strstr(line, tag);
+    if ((line == NULL) || (line[tag_length] != ' ') ||
+        (sscanf(&line[tag_length], " %4x:%n", &addr, &used) != 1))
+    {
+        return;
+    }
+    line += tag_length + used;
+    while ((addr < DUMP_SPACE_SIZE) && (sscanf(line, " %2x%n", &value, &used) == 1))
+    {
+        g_image[addr] = (uint8_t)value;
+        g_present[addr] = true;
+        addr++;
+        line += used;
+    }
+}
+
+/* Addresses of the data records of an Intel HEX file */
+static bool dump_mask(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    char line[600];
+    unsigned int count, addr, type, i;
+
+    if (file == NULL)
+    {
+        return false;
+    }
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if ((line[0] != ':') || (sscanf(&line[1], "%2x%4x%2x", &count, &addr, &type) != 3))
+        {
+            continue;
+        }
+        if (type == 0x01U)
+        {
+            break;
+        }
+        for (i = 0; (type == 0x00U) && (i < count) && ((addr + i) < DUMP_SPACE_SIZE); i++)
+        {
+            g_mask[addr + i] = true;
+        }
+    }
+    fclose(file);
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *tag = "EEPROM";
+    FILE *input = stdin;
+    char line[256];
+    bool masked = false;
+    unsigned long addr;
+    unsigned int sum;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0)
+        {
+            tag = "SRAM";
+        }
+        else if ((strcmp(argv[i], "-m") == 0) && ((i + 1) < argc))
+        {
+            i++;
+            masked = true;
+            if (dump_mask(argv[i]) == false)
+            {
+                fprintf(stderr, "dump2eep: cannot open %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if ((input = fopen(argv[i], "r")) == NULL)
+        {
+            fprintf(stderr, "dump2eep: cannot open %s\n", argv[i]);
+            return 1;
+        }
+        else
+        {
+            /* Input file */
+        }
+    }
+
+    while (fgets(line, sizeof(line), input) != NULL)
+    {
+        dump_line(line, tag);
+    }
+
+    for (addr = 0; addr < DUMP_SPACE_SIZE; addr++)
+    {
+        if ((g_present[addr] == true) && ((masked == false) || (g_mask[addr] == true)))
+        {
+            /* Two's complement of count, address, type and data */
+            sum = 0x01U + (unsigned int)(addr >> 8) + (unsigned int)(addr & 0xFFU) + g_image[addr];
+            printf(":01%04lX00%02X%02X\n", addr, g_image[addr], (0x100U - (sum & 0xFFU)) & 0xFFU);
+        }
+    }
+    printf(":00000001FF");
+
+    return 0;
+}